@@ -0,0 +1,559 @@
+/*! \file bench.cpp
+ *  \brief Бенчмарки горячих путей сервера
+ *  \details Запуск: make bench. Каждый раздел печатает одну таблицу результатов.
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../src/AuthManager.h"
+#include "../src/BufferPool.h"
+#include "../src/ComputePool.h"
+#include "../src/DataCalculator.h"
+#include "../src/Logger.h"
+#include "../src/SaltReservoir.h"
+#include "../src/SimdKernels.h"
+#include "../src/UserStore.h"
+#include "../src/VectorStats.h"
+
+//! \brief Счётчик выделений памяти в куче (для проверки путей без выделений)
+static std::atomic<uint64_t> heap_allocations{0};
+
+void* operator new(size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+//! \brief Время выполнения функции в секундах
+double measure(const std::function<void()>& fn) {
+    auto start = Clock::now();
+    fn();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//! \brief Пакет векторов в формате протокола: количество, затем размер и элементы каждого
+std::string build_batch(uint32_t num_vectors, uint32_t vector_size) {
+    std::string batch(reinterpret_cast<const char*>(&num_vectors), sizeof(num_vectors));
+    std::vector<double> data(vector_size, 1.5);
+    for (uint32_t i = 0; i < num_vectors; i++) {
+        batch.append(reinterpret_cast<const char*>(&vector_size), sizeof(vector_size));
+        batch.append(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+    }
+    return batch;
+}
+
+// ===================== Ввод-вывод: select против io_uring =====================
+
+//! \brief Клиент, отправляющий весь пакет сразу
+void pipelined_client(int sock, const std::string& batch, uint32_t num_vectors) {
+    send(sock, batch.data(), batch.size(), 0);
+    std::vector<double> results(num_vectors);
+    recv(sock, results.data(), results.size() * sizeof(double), MSG_WAITALL);
+}
+
+//! \brief Клиент, ждущий результат каждого вектора перед отправкой следующего
+void lockstep_client(int sock, const std::string& batch, uint32_t num_vectors) {
+    size_t vector_bytes = (batch.size() - sizeof(uint32_t)) / num_vectors;
+    send(sock, batch.data(), sizeof(uint32_t), 0);
+    for (uint32_t i = 0; i < num_vectors; i++) {
+        send(sock, batch.data() + sizeof(uint32_t) + i * vector_bytes, vector_bytes, 0);
+        double result;
+        recv(sock, &result, sizeof(result), MSG_WAITALL);
+    }
+}
+
+void bench_io_backends() {
+    const uint32_t num_vectors = 1000;
+    const uint32_t vector_size = 16;
+    const std::string batch = build_batch(num_vectors, vector_size);
+    Logger logger("/dev/null");
+
+    std::printf("\n%-10s %-10s %12s %14s %12s\n", "backend", "client", "syscalls", "syscalls/vec", "time, ms");
+    for (IoBackend backend : {IoBackend::Select, IoBackend::Uring}) {
+        const char* backend_name = backend == IoBackend::Select ? "select" : "uring";
+        if (DataCalculator::set_io_backend(backend) != backend) {
+            std::printf("%-10s %-10s %12s\n", backend_name, "-", "unsupported");
+            continue;
+        }
+
+        for (bool lockstep : {false, true}) {
+            int sockfd[2];
+            socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd);
+            std::thread client([&]() {
+                if (lockstep) {
+                    lockstep_client(sockfd[0], batch, num_vectors);
+                } else {
+                    pipelined_client(sockfd[0], batch, num_vectors);
+                }
+            });
+
+            DataCalculator::io_syscalls = 0;
+            double seconds = measure([&]() {
+                DataCalculator::process_client_data(sockfd[1], logger, "bench");
+            });
+            uint64_t syscalls = DataCalculator::io_syscalls;
+            client.join();
+            close(sockfd[0]);
+            close(sockfd[1]);
+
+            std::printf("%-10s %-10s %12llu %14.2f %12.2f\n", backend_name,
+                        lockstep ? "lockstep" : "pipelined",
+                        static_cast<unsigned long long>(syscalls),
+                        static_cast<double>(syscalls) / num_vectors, seconds * 1e3);
+        }
+    }
+    DataCalculator::set_io_backend(IoBackend::Select);
+}
+
+// ===================== Буферы векторов: std::vector против пула =====================
+
+void bench_buffer_pool() {
+    const int iterations = 200;
+
+    std::printf("\n%-12s %-14s %14s\n", "elements", "allocator", "us/vector");
+    for (size_t elements : {16, 4096, 1000000}) {
+        double vector_seconds = measure([&]() {
+            for (int i = 0; i < iterations; i++) {
+                std::vector<double> data(elements);
+                data[elements - 1] = 1.0;
+                asm volatile("" : : "r"(data.data()) : "memory");
+            }
+        });
+        double pool_seconds = measure([&]() {
+            for (int i = 0; i < iterations; i++) {
+                PooledBuffer data(elements * sizeof(double));
+                data.as<double>()[elements - 1] = 1.0;
+                asm volatile("" : : "r"(data.data()) : "memory");
+            }
+        });
+        std::printf("%-12zu %-14s %14.2f\n", elements, "std::vector", vector_seconds * 1e6 / iterations);
+        std::printf("%-12zu %-14s %14.2f\n", elements, "BufferPool", pool_seconds * 1e6 / iterations);
+    }
+    std::printf("pool: %s\n", BufferPool::instance().get_stats().to_string().c_str());
+}
+
+// ===================== Ядра суммы квадратов =====================
+
+void bench_simd_kernels() {
+    std::printf("\n%-12s %-10s %12s\n", "elements", "kernel", "GB/s");
+    // 32K элементов (256 КБ) помещаются в L2, 1M элементов (8 МБ) читаются из памяти
+    for (size_t elements : {32768, 1000000}) {
+        std::vector<double> data(elements, 1.5);
+        const int iterations = static_cast<int>(200000000 / elements);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+            SimdKernels::SumOfSquaresFn fn = SimdKernels::kernel(level);
+            if (!fn) continue;
+            double sink = 0.0;
+            double seconds = measure([&]() {
+                for (int i = 0; i < iterations; i++) {
+                    asm volatile("" : : "r"(data.data()) : "memory");
+                    sink += fn(data.data(), elements);
+                }
+            });
+            asm volatile("" : : "x"(sink));
+            double bytes = static_cast<double>(elements) * sizeof(double) * iterations;
+            std::printf("%-12zu %-10s %12.2f\n", elements, SimdKernels::level_name(level), bytes / seconds / 1e9);
+        }
+        // float: вдвое меньше байт на элемент, квадраты суммируются в double
+        std::vector<float> floats(elements, 1.5f);
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+            SimdKernels::FloatSumOfSquaresFn fn = SimdKernels::float_kernel(level);
+            if (!fn) continue;
+            double sink = 0.0;
+            double seconds = measure([&]() {
+                for (int i = 0; i < iterations; i++) {
+                    asm volatile("" : : "r"(floats.data()) : "memory");
+                    sink += fn(floats.data(), elements);
+                }
+            });
+            asm volatile("" : : "x"(sink));
+            double bytes = static_cast<double>(elements) * sizeof(float) * iterations;
+            std::printf("%-12zu %-10s %12.2f\n", elements,
+                        (std::string("f32-") + SimdKernels::level_name(level)).c_str(), bytes / seconds / 1e9);
+        }
+    }
+    std::printf("active: %s\n", SimdKernels::level_name(SimdKernels::get_level()));
+}
+
+// ===================== Слитные статистики против отдельных запросов =====================
+
+void bench_fused_stats() {
+    const size_t elements = 1000000;
+    const int iterations = 50;
+    std::vector<double> data(elements);
+    for (size_t i = 0; i < elements; i++) {
+        data[i] = static_cast<double>(i % 1000) - 500.0;
+    }
+    char results[StatsAccumulator<>::MAX_RESULT_SIZE];
+
+    // Восемь запросов по одной статистике - восемь проходов по вектору
+    double separate_seconds = measure([&]() {
+        for (int i = 0; i < iterations; i++) {
+            for (unsigned bit = 0; bit < 8; bit++) {
+                StatsAccumulator<double> accumulator(static_cast<uint8_t>(1u << bit));
+                accumulator.add(data.data(), elements);
+                accumulator.write_results(results);
+            }
+        }
+    });
+    double fused_seconds = measure([&]() {
+        for (int i = 0; i < iterations; i++) {
+            StatsAccumulator<double> accumulator(0xFF);
+            accumulator.add(data.data(), elements);
+            accumulator.write_results(results);
+        }
+    });
+    std::printf("\n%-22s %14s\n", "1M doubles, 8 stats", "us/vector");
+    std::printf("%-22s %14.0f\n", "separate requests", separate_seconds * 1e6 / iterations);
+    std::printf("%-22s %14.0f\n", "fused mask 0xFF", fused_seconds * 1e6 / iterations);
+}
+
+// ===================== Параллельное суммирование длинных векторов =====================
+
+void bench_parallel_reduction() {
+    ComputePool& pool = ComputePool::instance();
+    const unsigned default_threads = pool.thread_count();
+    // Столбцы: потоков пула + вызывающий поток; на машинах с малым числом ядер
+    // столбцы сверх числа ядер показывают цену лишней раздачи заданий
+    std::vector<unsigned> thread_counts = {0, 1, 3};
+    for (unsigned threads = 7; threads <= default_threads; threads = threads * 2 + 1) {
+        thread_counts.push_back(threads);
+    }
+
+    std::printf("\n%-12s", "elements");
+    for (unsigned threads : thread_counts) {
+        std::printf(" %9u+1", threads);
+    }
+    std::printf("   (us/vector, speedup)\n");
+    for (size_t elements : {size_t(65536), size_t(262144), size_t(1) << 20, size_t(4) << 20, size_t(16) << 20}) {
+        std::vector<double> data(elements, 1.5);
+        const int iterations = static_cast<int>(std::max<size_t>(5, 100000000 / elements));
+        double baseline = 0.0;
+        std::printf("%-12zu", elements);
+        for (unsigned threads : thread_counts) {
+            pool.set_threads(threads);
+            double sink = 0.0;
+            double seconds = measure([&]() {
+                for (int i = 0; i < iterations; i++) {
+                    asm volatile("" : : "r"(data.data()) : "memory");
+                    sink += DataCalculator::calculate_sum_of_squares(data);
+                }
+            });
+            asm volatile("" : : "x"(sink));
+            double us = seconds * 1e6 / iterations;
+            if (threads == 0) {
+                baseline = us;
+            }
+            std::printf(" %7.0f/%-4.1f", us, baseline / us);
+        }
+        std::printf("\n");
+    }
+    pool.set_threads(default_threads);
+    std::printf("threshold: %zu elements\n", DataCalculator::PARALLEL_REDUCTION_THRESHOLD);
+}
+
+//! \brief Выдача солей: прежний путь, генератор потока и запас
+void bench_salts() {
+    const int iterations = 200000;
+    std::string sink;
+    
+    // Прежняя реализация generate_salt(): новый генератор и конвейер HexEncoder на каждую соль
+    double legacy_seconds = measure([&]() {
+        for (int i = 0; i < iterations; i++) {
+            CryptoPP::byte salt_bytes[8];
+            CryptoPP::AutoSeededRandomPool rng;
+            rng.GenerateBlock(salt_bytes, sizeof(salt_bytes));
+            std::string salt_hex;
+            CryptoPP::ArraySource as(salt_bytes, sizeof(salt_bytes), true,
+                new CryptoPP::HexEncoder(new CryptoPP::StringSink(salt_hex)));
+            while (salt_hex.length() < 16) {
+                salt_hex = "0" + salt_hex;
+            }
+            sink = salt_hex;
+        }
+    });
+    
+    auto take_all = [&](SaltReservoir& reservoir) {
+        return measure([&]() {
+            for (int i = 0; i < iterations; i++) {
+                char salt[SaltReservoir::SALT_SIZE];
+                reservoir.take(salt);
+                sink.assign(salt, sizeof(salt));
+            }
+        });
+    };
+    SaltReservoir direct(0);
+    double direct_seconds = take_all(direct);
+    SaltReservoir pooled;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    double pooled_seconds = take_all(pooled);
+    
+    std::printf("\n%-22s %14s %10s\n", "salt source", "salts/sec", "misses");
+    std::printf("%-22s %14.0f %10s\n", "legacy per-call pool", iterations / legacy_seconds, "-");
+    std::printf("%-22s %14.0f %10llu\n", "thread generator", iterations / direct_seconds,
+                static_cast<unsigned long long>(direct.get_misses()));
+    std::printf("%-22s %14.0f %10llu\n", "reservoir", iterations / pooled_seconds,
+                static_cast<unsigned long long>(pooled.get_misses()));
+}
+
+//! \brief Проверка хеша клиента: прежний путь и check_credentials()
+void bench_auth() {
+    const int iterations = 500000;
+    std::string users_path = (std::filesystem::temp_directory_path() / "bench_users.txt").string();
+    {
+        std::ofstream users(users_path);
+        for (int i = 0; i < 1000; i++) {
+            users << "user" << i << ":password" << i << "\n";
+        }
+    }
+    AuthManager auth;
+    auth.load_users(users_path);
+    std::filesystem::remove(users_path);
+    const std::string login = "user500";
+    const std::string salt = auth.generate_salt();
+    const std::string hash = AuthManager::compute_md5_hash(salt, "password500");
+    
+    // Прежняя реализация authenticate() без журнала: два поиска, копия пароля,
+    // конвейер фильтров Crypto++, перевод в верхний регистр и сравнение строк
+    auto legacy = [&]() {
+        if (!auth.user_exists(login)) {
+            return false;
+        }
+        std::string password = auth.get_password(login);
+        std::string digest;
+        std::string data_to_hash = salt + password;
+        CryptoPP::Weak::MD5 md5;
+        CryptoPP::StringSource ss(data_to_hash, true,
+            new CryptoPP::HashFilter(md5, new CryptoPP::HexEncoder(new CryptoPP::StringSink(digest))));
+        for (char& c : digest) {
+            c = std::toupper(static_cast<unsigned char>(c));
+        }
+        return hash == digest;
+    };
+    auto current = [&]() { return auth.check_credentials(login, hash, salt) == AuthResult::Accepted; };
+    
+    std::printf("\n%-22s %14s %12s\n", "hash check", "auths/sec", "allocs/auth");
+    auto run = [&](const char* name, const std::function<bool()>& check) {
+        uint64_t allocations = heap_allocations.load();
+        int accepted = 0;
+        double seconds = measure([&]() {
+            for (int i = 0; i < iterations; i++) {
+                accepted += check();
+            }
+        });
+        double allocs = double(heap_allocations.load() - allocations) / iterations;
+        std::printf("%-22s %14.0f %12.1f%s\n", name, iterations / seconds, allocs,
+                    accepted == iterations ? "" : "  (rejected!)");
+    };
+    run("legacy", legacy);
+    run("check_credentials", current);
+}
+
+//! \brief Загрузка базы пользователей: текст против отображаемого двоичного файла
+void bench_user_store() {
+    const int users = 1000000;
+    const int lookups = 1000000;
+    auto temp = std::filesystem::temp_directory_path();
+    std::string text_path = (temp / "bench_users_1m.txt").string();
+    std::string binary_path = (temp / "bench_users_1m.bin").string();
+    {
+        std::ofstream text(text_path);
+        for (int i = 0; i < users; i++) {
+            text << "tenant_user_" << i << ":password_" << i << "\n";
+        }
+    }
+    double compile_seconds = measure([&]() { UserStore::compile(text_path, binary_path); });
+    
+    std::printf("\n%-14s %12s %14s\n", "format", "load, ms", "lookups/sec");
+    auto run = [&](const char* name, const std::string& path) {
+        std::shared_ptr<const UserStore> store;
+        double load_seconds = measure([&]() { store = UserStore::open(path); });
+        size_t found = 0;
+        std::string login = "tenant_user_";
+        double lookup_seconds = measure([&]() {
+            std::string_view password;
+            for (int i = 0; i < lookups; i++) {
+                login.resize(12);
+                login += std::to_string(static_cast<uint64_t>(i) * 7919 % users);
+                found += store->find(login, password);
+            }
+        });
+        std::printf("%-14s %12.1f %14.0f%s\n", name, load_seconds * 1e3, lookups / lookup_seconds,
+                    found == static_cast<size_t>(lookups) ? "" : "  (missing!)");
+    };
+    run("text", text_path);
+    run("binary mmap", binary_path);
+    std::printf("compile: %.0f ms, binary size: %.1f MB\n", compile_seconds * 1e3,
+                std::filesystem::file_size(binary_path) / 1048576.0);
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(binary_path);
+}
+
+//! \brief Задержка вызова Logger::log(): синхронная запись и фоновый поток
+void bench_logger() {
+    const int iterations = 200000;
+    const int thread_counts[] = {1, 4};
+    std::string log_path = (std::filesystem::temp_directory_path() / "bench_logger.log").string();
+    
+    auto run = [&](const LoggerOptions& options, int threads) {
+        std::filesystem::remove(log_path);
+        Logger logger(log_path, options);
+        double seconds = measure([&]() {
+            std::vector<std::thread> producers;
+            for (int t = 0; t < threads; t++) {
+                producers.emplace_back([&logger]() {
+                    for (int i = 0; i < iterations; i++) {
+                        logger.log_data("127.0.0.1", "Vector 1: size=16, result=1240.000000");
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+        });
+        uint64_t dropped = logger.get_dropped();
+        logger.flush();
+        return std::make_pair(seconds * 1e9 / iterations, dropped);
+    };
+    
+    std::printf("\n%-22s %8s %14s %10s\n", "logger", "threads", "ns/line", "dropped");
+    for (int threads : thread_counts) {
+        LoggerOptions sync_options;
+        LoggerOptions block_options;
+        block_options.async = true;
+        block_options.queue_capacity = 65536;
+        LoggerOptions drop_options = block_options;
+        drop_options.overflow = LogOverflow::Drop;
+        // Ротация каждый мегабайт со сжатием: потоки сессий не должны замедлиться
+        LoggerOptions rotate_options = block_options;
+        rotate_options.rotate_bytes = 1024 * 1024;
+        rotate_options.keep_segments = 2;
+        const std::pair<const char*, LoggerOptions> variants[] = {
+            {"sync (flush per line)", sync_options}, {"async, block", block_options}, {"async, drop", drop_options},
+            {"async, rotate 1 MB", rotate_options}};
+        for (const auto& [name, options] : variants) {
+            auto [ns, dropped] = run(options, threads);
+            std::printf("%-22s %8d %14.0f %10llu\n", name, threads, ns, static_cast<unsigned long long>(dropped));
+        }
+    }
+    std::filesystem::remove(log_path);
+    for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path())) {
+        if (entry.path().filename().string().rfind("bench_logger.log.", 0) == 0) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+}
+
+//! \brief Стоимость отладочной строки на вектор: прежний вызов log_debug() и LOG_DEBUG
+void bench_log_levels() {
+    const int vectors = 2000000;
+    std::string log_path = (std::filesystem::temp_directory_path() / "bench_levels.log").string();
+    Logger logger(log_path);
+    uint64_t vector_size = 16;
+    
+    std::printf("\n%-30s %12s\n", "per-vector debug line", "ns/vector");
+    auto report = [&](const char* name, const std::function<void(int)>& body) {
+        double seconds = measure([&]() {
+            for (int i = 0; i < vectors; i++) {
+                body(i);
+            }
+        });
+        std::printf("%-30s %12.1f\n", name, seconds * 1e9 / vectors);
+    };
+    logger.set_level(LogLevel::Info);
+    report("log_debug(), level info", [&](int i) {
+        logger.log_debug("Vector " + std::to_string(i) + " has " + std::to_string(vector_size) + " elements");
+    });
+    report("LOG_DEBUG, level info", [&](int i) {
+        LOG_DEBUG(logger, "Vector " + std::to_string(i) + " has " + std::to_string(vector_size) + " elements");
+    });
+    report("no logging", [&](int i) {
+        vector_size += static_cast<uint64_t>(i) & 1;
+    });
+    std::filesystem::remove(log_path);
+}
+
+//! \brief Событие пакета в текстовом и двоичном журнале: время и выделения памяти на событие
+void bench_log_format() {
+    const int events = 200000;
+    std::string log_path = (std::filesystem::temp_directory_path() / "bench_format.log").string();
+    
+    std::printf("\n%-22s %12s %12s\n", "log format", "ns/event", "allocs/event");
+    for (LogFormat format : {LogFormat::Text, LogFormat::Binary}) {
+        std::filesystem::remove(log_path);
+        LoggerOptions options;
+        options.async = true;
+        options.queue_capacity = 65536;
+        options.format = format;
+        Logger logger(log_path, options);
+        const std::string client_ip = "192.168.10.25";
+        // Выделения считаются во всех потоках, включая поток записи
+        uint64_t allocations = heap_allocations.load();
+        double seconds = measure([&]() {
+            for (int i = 0; i < events; i++) {
+                LOG_BATCH(logger, LogEvent::BatchProcessed, client_ip, 16);
+            }
+        });
+        logger.flush();
+        double allocs = double(heap_allocations.load() - allocations) / events;
+        std::printf("%-22s %12.0f %12.2f\n", format == LogFormat::Text ? "text" : "binary",
+                    seconds * 1e9 / events, allocs);
+    }
+    std::filesystem::remove(log_path);
+}
+}
+
+int main() {
+    // Логгер дублирует строки в консоль - отключаем её на время замеров
+    std::streambuf* console = std::cout.rdbuf();
+    auto section = [console](const std::string& title, const std::function<void()>& body) {
+        std::cout.rdbuf(console);
+        std::cout << "=== " << title << " ===" << std::endl;
+        std::cout.rdbuf(nullptr);
+        body();
+        std::fflush(stdout);
+    };
+    
+    section("Ввод-вывод: 1000 векторов по 16 элементов", bench_io_backends);
+    section("Буферы векторов", bench_buffer_pool);
+    section("Сумма квадратов", bench_simd_kernels);
+    section("Параллельное суммирование", bench_parallel_reduction);
+    section("Статистики вектора", bench_fused_stats);
+    section("Соль аутентификации", bench_salts);
+    section("Проверка хеша, 1 поток", bench_auth);
+    section("База пользователей: 1M записей", bench_user_store);
+    section("Журнал: 200K строк на поток", bench_logger);
+    section("Уровни журнала: 2M векторов", bench_log_levels);
+    section("Формат журнала: 200K событий", bench_log_format);
+    
+    std::cout.rdbuf(console);
+    return 0;
+}
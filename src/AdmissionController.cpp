@@ -0,0 +1,67 @@
+/*! \file AdmissionController.cpp
+ *  \brief Реализация класса AdmissionController
+ *  \details Содержит предел одновременных сессий и отсечение по времени ожидания
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "AdmissionController.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+AdmissionController::AdmissionController(unsigned max_sessions, std::chrono::milliseconds target,
+                                         std::chrono::milliseconds interval)
+    : max_sessions(max_sessions), target(target), interval(interval),
+      active(0), first_above(0), shed(0) {
+}
+
+bool AdmissionController::try_admit() {
+    if (max_sessions == 0) {
+        active.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    unsigned current = active.load(std::memory_order_relaxed);
+    do {
+        if (current >= max_sessions) {
+            return false;
+        }
+    } while (!active.compare_exchange_weak(current, current + 1, std::memory_order_relaxed));
+    return true;
+}
+
+void AdmissionController::release() {
+    active.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool AdmissionController::should_shed(std::chrono::nanoseconds sojourn,
+                                      std::chrono::steady_clock::time_point now) {
+    if (target.count() == 0) {
+        return false;
+    }
+    
+    if (sojourn < target) {
+        first_above.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    int64_t deadline = first_above.load(std::memory_order_relaxed);
+    if (deadline == 0) {
+        // Первое превышение: даём очереди интервал, чтобы рассосаться самой
+        first_above.compare_exchange_strong(deadline, now_ns + interval.count(), std::memory_order_relaxed);
+        return false;
+    }
+    if (now_ns < deadline) {
+        return false;
+    }
+    
+    shed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void AdmissionController::reject(int sock) {
+    send(sock, "ERR", 3, MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(sock);
+}
@@ -0,0 +1,62 @@
+#ifndef ADMISSIONCONTROLLER_H
+#define ADMISSIONCONTROLLER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+//! \brief Контроль допуска клиентских сессий
+//! \details Ограничивает число одновременно обслуживаемых сессий и отсекает
+//! подключения по времени ожидания в очереди в стиле CoDel: если время ожидания
+//! держится выше цели дольше интервала, очередь считается стоячей, и сессии,
+//! прождавшие дольше цели, получают быстрый отказ "ERR" вместо таймаута.
+//! Как только время ожидания опускается ниже цели, отсечение прекращается.
+//! Все методы потокобезопасны и не блокируют.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class AdmissionController {
+private:
+    unsigned max_sessions;                   //!< Предел одновременных сессий (0 - без предела)
+    std::chrono::nanoseconds target;         //!< Целевое время ожидания (0 - отсечение выключено)
+    std::chrono::nanoseconds interval;       //!< Интервал, в течение которого допускается превышение цели
+    std::atomic<unsigned> active;            //!< Допущено незавершённых сессий
+    std::atomic<int64_t> first_above;        //!< Момент окончания интервала превышения (0 - ниже цели)
+    std::atomic<uint64_t> shed;              //!< Отсечено по времени ожидания
+
+public:
+    //! \brief Конструктор
+    //! \param[in] max_sessions Предел одновременных сессий (0 - без предела)
+    //! \param[in] target Целевое время ожидания в очереди (0 - без отсечения)
+    //! \param[in] interval Интервал превышения цели до начала отсечения
+    AdmissionController(unsigned max_sessions, std::chrono::milliseconds target,
+                        std::chrono::milliseconds interval);
+
+    //! \brief Допустить новую сессию
+    //! \return true если предел не достигнут; тогда по завершении нужно вызвать release()
+    bool try_admit();
+
+    //! \brief Отметить завершение допущенной сессии
+    void release();
+
+    //! \brief Решить, отсечь ли сессию по времени ожидания в очереди
+    //! \param[in] sojourn Время ожидания сессии в очереди
+    //! \param[in] now Текущее время
+    //! \return true если сессию нужно отклонить
+    bool should_shed(std::chrono::nanoseconds sojourn, std::chrono::steady_clock::time_point now);
+
+    //! \brief Отклонить подключение
+    //! \details Отправляет "ERR" без ожидания и закрывает сокет
+    //! \param[in] sock Сокет клиента
+    static void reject(int sock);
+
+    //! \brief Получить количество допущенных незавершённых сессий
+    //! \return Количество сессий
+    unsigned active_sessions() const { return active.load(std::memory_order_relaxed); }
+
+    //! \brief Получить количество отсечённых по времени ожидания сессий
+    //! \return Количество сессий
+    uint64_t shed_count() const { return shed.load(std::memory_order_relaxed); }
+};
+
+#endif // ADMISSIONCONTROLLER_H
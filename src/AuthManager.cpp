@@ -8,126 +8,176 @@
 
 #include "AuthManager.h"
 #include "Logger.h"
+#include "IpRateLimiter.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <cstring>
+
+#include <cryptopp/misc.h>
 
 #include <sys/socket.h>
 #include <unistd.h>
 
-bool AuthManager::load_users(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open user database: " + filename);
-    }
-    
-    std::string line;
-    int count = 0;
-    
-    while (std::getline(file, line)) {
-        try {
-                size_t start = line.find_first_not_of(" \t");
-                if (start == std::string::npos) continue;
-                
-                size_t end = line.find_last_not_of(" \t");
-                std::string trimmed = line.substr(start, end - start + 1);
-                
-                if (trimmed.empty() || trimmed[0] == '#') continue;
-                
-                size_t colon_pos = trimmed.find(':');
-                if (colon_pos != std::string::npos) {
-                    std::string login = trimmed.substr(0, colon_pos);
-                    std::string password = trimmed.substr(colon_pos + 1);
-                    
-                    // Убираем пробелы
-                    size_t login_start = login.find_first_not_of(" \t");
-                    size_t login_end = login.find_last_not_of(" \t");
-                    if (login_start != std::string::npos) {
-                        login = login.substr(login_start, login_end - login_start + 1);
-                    }
-                    
-                    size_t pass_start = password.find_first_not_of(" \t");
-                    size_t pass_end = password.find_last_not_of(" \t");
-                    if (pass_start != std::string::npos) {
-                        password = password.substr(pass_start, pass_end - pass_start + 1);
-                    }
-                    
-                    if (login.empty()) {
-                        throw std::runtime_error("Empty login in database");
-                    }
-                    
-                    users[login] = password;
-                    count++;
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "WARNING: Skipping invalid line in user database: " 
-                         << e.what() << std::endl;
-                continue;
-            }
+namespace {
+
+//! \brief Префикс запроса билета в первом сообщении
+const std::string TICKET_REQUEST_PREFIX = "TICKET:";
+//! \brief Префикс возобновления по билету в первом сообщении
+const std::string RESUME_PREFIX = "RESUME:";
+
+// Смещения полей в двоичной части билета
+constexpr size_t TICKET_ISSUED_OFFSET = 1; //!< Время выдачи (секунды монотонных часов)
+constexpr size_t TICKET_NONCE_OFFSET = 9;  //!< Случайный нонс
+constexpr size_t TICKET_MAC_OFFSET = 17;   //!< MAC версии, времени, нонса и логина
+
+//! \brief Текущее время монотонных часов в секундах
+uint64_t steady_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//! \brief Разобрать шестнадцатеричную строку
+//! \return false при недопустимом символе
+bool decode_hex(const char* hex, size_t size, CryptoPP::byte* out) {
+    auto digit = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    for (size_t i = 0; i < size; i++) {
+        int high = digit(hex[2 * i]);
+        int low = digit(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
         }
-    
-    file.close();
-    if (count == 0) {
-        throw std::runtime_error("No valid users found in database");
+        out[i] = static_cast<CryptoPP::byte>(high << 4 | low);
     }
-    
-    std::cout << "INFO: Loaded " << count << " users from database" << std::endl;
     return true;
 }
-bool AuthManager::user_exists(const std::string& login) {
-    return users.find(login) != users.end();
+
+//! \brief Поколения снимков базы; уникальны среди всех экземпляров AuthManager
+std::atomic<uint64_t> next_users_generation{1};
+
+//! \brief Снимок базы, последний увиденный потоком
+struct UsersCache {
+    uint64_t generation = 0;                                //!< Поколение снимка
+    std::shared_ptr<const UserStore> table;    //!< Снимок
+};
+
+thread_local UsersCache users_cache;
+
+} // namespace
+
+AuthManager::AuthManager()
+    : users_generation(0), rate_limiter(nullptr), ticket_lifetime_sec(DEFAULT_TICKET_LIFETIME_SEC), used_tickets_purge_size(1024) {
+    publish_users(UserStore::build({}));
+    SaltReservoir::random_bytes(ticket_key, sizeof(ticket_key));
+}
+
+bool AuthManager::load_users(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(reload_mutex);
+    auto table = UserStore::open(filename);
+    publish_users(table);
+    user_db_file = filename;
+    std::cout << "INFO: Loaded " << table->size() << " users from database" << std::endl;
+    return true;
+}
+
+bool AuthManager::reload_users(Logger& logger) {
+    std::lock_guard<std::mutex> lock(reload_mutex);
+    if (user_db_file.empty()) {
+        return false;
+    }
+    try {
+        auto table = UserStore::open(user_db_file);
+        publish_users(table);
+        logger.log("User database reloaded: " + std::to_string(table->size()) + " users");
+        return true;
+    } catch (const std::exception& e) {
+        logger.log_error("User database reload failed, keeping " +
+                         std::to_string(users.load()->size()) + " users: " + e.what());
+        return false;
+    }
+}
+
+void AuthManager::publish_users(std::shared_ptr<const UserStore> table) {
+    users.store(std::move(table), std::memory_order_release);
+    // Снимок публикуется раньше поколения: увидевший новое поколение поток загрузит новый снимок
+    users_generation.store(next_users_generation.fetch_add(1, std::memory_order_relaxed),
+                           std::memory_order_release);
+}
+
+const UserStore& AuthManager::current_users() const {
+    uint64_t generation = users_generation.load(std::memory_order_acquire);
+    if (users_cache.generation != generation) {
+        users_cache.table = users.load(std::memory_order_acquire);
+        users_cache.generation = generation;
+    }
+    return *users_cache.table;
+}
+
+bool AuthManager::user_exists(const std::string& login) const {
+    return current_users().contains(login);
 }
 
-std::string AuthManager::get_password(const std::string& login) {
-    auto it = users.find(login);
-    return (it != users.end()) ? it->second : "";
+std::string AuthManager::get_password(const std::string& login) const {
+    std::string_view password;
+    return current_users().find(login, password) ? std::string(password) : "";
 }
 
 std::string AuthManager::generate_salt() {
     try {
-        CryptoPP::byte salt_bytes[8];
-        CryptoPP::AutoSeededRandomPool rng;
-        rng.GenerateBlock(salt_bytes, sizeof(salt_bytes));
-        
-        std::string salt_hex;
-        CryptoPP::ArraySource as(salt_bytes, sizeof(salt_bytes), true,
-            new CryptoPP::HexEncoder(
-                new CryptoPP::StringSink(salt_hex)
-            )
-        );
-        
-        while (salt_hex.length() < 16) {
-            salt_hex = "0" + salt_hex;
-        }
-        
-        if (salt_hex.length() > 16) {
-            salt_hex = salt_hex.substr(0, 16);
-        }
-        
-        return salt_hex;
+        char salt[SaltReservoir::SALT_SIZE];
+        salt_reservoir.take(salt);
+        return std::string(salt, sizeof(salt));
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to generate salt: " + std::string(e.what()));
     }
 }
 
 std::string AuthManager::compute_md5_hash(const std::string& salt, const std::string& password) {
-    std::string digest;
-    std::string data_to_hash = salt + password;
+    static const char digits[] = "0123456789ABCDEF";
+    CryptoPP::byte digest[CryptoPP::Weak::MD5::DIGESTSIZE];
+    compute_md5_digest(salt, password, digest);
     
+    std::string hex(2 * sizeof(digest), '\0');
+    for (size_t i = 0; i < sizeof(digest); i++) {
+        hex[2 * i] = digits[digest[i] >> 4];
+        hex[2 * i + 1] = digits[digest[i] & 0x0F];
+    }
+    return hex;
+}
+
+void AuthManager::compute_md5_digest(std::string_view salt, std::string_view password,
+                                     CryptoPP::byte* digest) {
     CryptoPP::Weak::MD5 hash;
-    CryptoPP::StringSource ss(data_to_hash, true,
-        new CryptoPP::HashFilter(hash,
-            new CryptoPP::HexEncoder(
-                new CryptoPP::StringSink(digest)
-            )
-        )
-    );
+    hash.Update(reinterpret_cast<const CryptoPP::byte*>(salt.data()), salt.size());
+    hash.Update(reinterpret_cast<const CryptoPP::byte*>(password.data()), password.size());
+    hash.Final(digest);
+}
+
+AuthResult AuthManager::check_credentials(const std::string& login,
+                                          const std::string& client_hash,
+                                          const std::string& salt) const {
+    std::string_view password;
+    if (!current_users().find(login, password)) {
+        return AuthResult::UnknownUser;
+    }
     
-    for (char& c : digest) {
-        c = std::toupper(static_cast<unsigned char>(c));
+    CryptoPP::byte expected[CryptoPP::Weak::MD5::DIGESTSIZE];
+    CryptoPP::byte received[CryptoPP::Weak::MD5::DIGESTSIZE];
+    if (client_hash.size() != 2 * sizeof(received) ||
+        !decode_hex(client_hash.data(), sizeof(received), received)) {
+        return AuthResult::HashMismatch;
     }
+    compute_md5_digest(salt, password, expected);
     
-    return digest;
+    // Время сравнения не зависит от позиции первого несовпадающего байта
+    return CryptoPP::VerifyBufsEqual(expected, received, sizeof(expected))
+        ? AuthResult::Accepted : AuthResult::HashMismatch;
 }
 
 bool AuthManager::authenticate(const std::string& login, 
@@ -135,22 +185,128 @@ bool AuthManager::authenticate(const std::string& login,
                                const std::string& salt,
                                Logger& logger,
                                const std::string& client_ip) {
+    bool success = false;
+    switch (check_credentials(login, client_hash, salt)) {
+        case AuthResult::Accepted:
+            logger.log_auth(client_ip, login, true, "Hash verified");
+            success = true;
+            break;
+        case AuthResult::UnknownUser:
+            logger.log_auth(client_ip, login, false, "User not found");
+            break;
+        case AuthResult::HashMismatch:
+            logger.log_auth(client_ip, login, false, "Hash mismatch");
+            break;
+    }
+    return record_auth_result(success, logger, client_ip);
+}
+
+bool AuthManager::record_auth_result(bool success, Logger& logger, const std::string& client_ip) {
+    if (rate_limiter && rate_limiter->record_auth(IpRateLimiter::parse_ip(client_ip), success)) {
+        logger.log("Blocked " + client_ip + " for " + std::to_string(rate_limiter->get_limits().block_sec) +
+                   " s after " + std::to_string(rate_limiter->get_limits().fail_limit) + " failed logins");
+    }
+    return success;
+}
+
+LoginKind AuthManager::parse_login_message(std::string& message) {
+    if (message.compare(0, RESUME_PREFIX.size(), RESUME_PREFIX) == 0) {
+        message.erase(0, RESUME_PREFIX.size());
+        return LoginKind::Resume;
+    }
+    if (message.compare(0, TICKET_REQUEST_PREFIX.size(), TICKET_REQUEST_PREFIX) == 0) {
+        message.erase(0, TICKET_REQUEST_PREFIX.size());
+        return LoginKind::PasswordWithTicket;
+    }
+    return LoginKind::Password;
+}
+
+void AuthManager::compute_ticket_mac(const CryptoPP::byte* header, size_t header_size,
+                                     const std::string& login, CryptoPP::byte* mac) const {
+    CryptoPP::HMAC<CryptoPP::SHA256> hmac(ticket_key, sizeof(ticket_key));
+    CryptoPP::byte digest[CryptoPP::HMAC<CryptoPP::SHA256>::DIGESTSIZE];
+    hmac.Update(header, header_size);
+    hmac.Update(reinterpret_cast<const CryptoPP::byte*>(login.data()), login.size());
+    hmac.Final(digest);
+    memcpy(mac, digest, TICKET_MAC_SIZE);
+}
+
+std::string AuthManager::issue_ticket(const std::string& login) {
+    CryptoPP::byte ticket[TICKET_BINARY_SIZE];
+    ticket[0] = TICKET_VERSION;
+    uint64_t issued = steady_seconds();
+    memcpy(ticket + TICKET_ISSUED_OFFSET, &issued, sizeof(issued));
+    try {
+        SaltReservoir::random_bytes(ticket + TICKET_NONCE_OFFSET, sizeof(uint64_t));
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to generate ticket nonce: " + std::string(e.what()));
+    }
+    compute_ticket_mac(ticket, TICKET_MAC_OFFSET, login, ticket + TICKET_MAC_OFFSET);
     
-    if (!user_exists(login)) {
-        logger.log_auth(client_ip, login, false, "User not found");
+    std::string encoded;
+    CryptoPP::ArraySource as(ticket, sizeof(ticket), true,
+        new CryptoPP::HexEncoder(
+            new CryptoPP::StringSink(encoded)
+        )
+    );
+    return encoded + login;
+}
+
+bool AuthManager::resume(const std::string& ticket, std::string& login, Logger& logger,
+                         const std::string& client_ip) {
+    return record_auth_result(verify_ticket(ticket, login, logger, client_ip), logger, client_ip);
+}
+
+bool AuthManager::verify_ticket(const std::string& ticket, std::string& login, Logger& logger,
+                                const std::string& client_ip) {
+    const size_t hex_size = 2 * TICKET_BINARY_SIZE;
+    CryptoPP::byte binary[TICKET_BINARY_SIZE];
+    if (ticket.size() <= hex_size || !decode_hex(ticket.data(), TICKET_BINARY_SIZE, binary) ||
+        binary[0] != TICKET_VERSION) {
+        logger.log_auth(client_ip, "", false, "Malformed ticket");
         return false;
     }
+    std::string ticket_login = ticket.substr(hex_size);
     
-    std::string password = get_password(login);
-    std::string expected_hash = compute_md5_hash(salt, password);
+    CryptoPP::byte expected[TICKET_MAC_SIZE];
+    compute_ticket_mac(binary, TICKET_MAC_OFFSET, ticket_login, expected);
+    if (!CryptoPP::VerifyBufsEqual(expected, binary + TICKET_MAC_OFFSET, TICKET_MAC_SIZE)) {
+        logger.log_auth(client_ip, ticket_login, false, "Ticket MAC mismatch");
+        return false;
+    }
     
-    bool success = (client_hash == expected_hash);
+    uint64_t issued;
+    uint64_t nonce;
+    memcpy(&issued, binary + TICKET_ISSUED_OFFSET, sizeof(issued));
+    memcpy(&nonce, binary + TICKET_NONCE_OFFSET, sizeof(nonce));
+    uint64_t now = steady_seconds();
+    if (issued > now || now - issued > ticket_lifetime_sec) {
+        logger.log_auth(client_ip, ticket_login, false, "Ticket expired");
+        return false;
+    }
+    if (!user_exists(ticket_login)) {
+        logger.log_auth(client_ip, ticket_login, false, "User not found");
+        return false;
+    }
     
-    if (success) {
-        logger.log_auth(client_ip, login, true, "Hash verified");
-    } else {
-        logger.log_auth(client_ip, login, false, "Hash mismatch");
+    {
+        // Билет одноразовый: нонс помнится, пока билет мог бы пройти проверку срока
+        std::lock_guard<std::mutex> lock(used_tickets_mutex);
+        auto steady_now = std::chrono::steady_clock::now();
+        if (used_tickets.size() >= used_tickets_purge_size) {
+            for (auto it = used_tickets.begin(); it != used_tickets.end();) {
+                it = it->second <= steady_now ? used_tickets.erase(it) : std::next(it);
+            }
+            used_tickets_purge_size = std::max<size_t>(1024, 2 * used_tickets.size());
+        }
+        auto expiry = steady_now + std::chrono::seconds(ticket_lifetime_sec - (now - issued) + 1);
+        if (!used_tickets.emplace(nonce, expiry).second) {
+            logger.log_auth(client_ip, ticket_login, false, "Ticket replayed");
+            return false;
+        }
     }
     
-    return success;
+    login = ticket_login;
+    logger.log_auth(client_ip, login, true, "Ticket resumed");
+    return true;
 }
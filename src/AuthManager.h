@@ -1,6 +1,11 @@
 #ifndef AUTHMANAGER_H
 #define AUTHMANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -9,22 +14,108 @@
 #include <cryptopp/md5.h>
 #include <cryptopp/filters.h>
 #include <cryptopp/osrng.h>
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
+
+#include "SaltReservoir.h"
+#include "UserStore.h"
 
 // Предварительное объявление
 class Logger;
+class IpRateLimiter;
+
+//! \brief Вид первого сообщения клиента
+enum class LoginKind {
+    Password,           //!< Логин, далее соль и хеш
+    PasswordWithTicket, //!< "TICKET:" и логин: после "OK" выдаётся билет возобновления
+    Resume              //!< "RESUME:" и билет: сразу к данным, без соли и хеша
+};
+
+//! \brief Результат проверки учётных данных
+enum class AuthResult {
+    Accepted,     //!< Хеш совпал
+    UnknownUser,  //!< Логин не найден
+    HashMismatch  //!< Хеш не совпал или имеет неверный формат
+};
 
 //! \brief Класс для управления аутентификацией пользователей
-//! \details Загружает базу пользователей, генерирует соль, проверяет хеши MD5
+//! \details Загружает базу пользователей, генерирует соль, проверяет хеши MD5,
+//! выдаёт и проверяет билеты возобновления сессии.
+//! База хранится неизменяемым снимком за атомарным указателем: reload_users()
+//! разбирает файл заново и подменяет снимок, не останавливая проверки. Поток
+//! держит ссылку на последний увиденный снимок и перечитывает указатель только
+//! при смене поколения, поэтому читатели не берут блокировок и не меняют общих
+//! счётчиков ссылок. generate_salt(), authenticate() и операции с билетами можно
+//! вызывать одновременно из нескольких рабочих потоков
 //! \author Осетров М.С.
 //! \date 2025
 //! \copyright ПГУ
 class AuthManager {
+public:
+    static constexpr unsigned TICKET_VERSION = 1;            //!< Версия формата билета
+    static constexpr size_t TICKET_MAC_SIZE = 16;            //!< Усечённый HMAC-SHA256 билета, байт
+    //! \brief Двоичная часть билета: версия, время выдачи, нонс и MAC, байт
+    static constexpr size_t TICKET_BINARY_SIZE = 1 + 8 + 8 + TICKET_MAC_SIZE;
+    static constexpr unsigned DEFAULT_TICKET_LIFETIME_SEC = 300; //!< Срок действия билета по умолчанию
+
 private:
-    std::unordered_map<std::string, std::string> users; //!< База пользователей (логин → пароль)
+    static constexpr size_t TICKET_KEY_SIZE = 32; //!< Размер ключа HMAC
+
+    std::atomic<std::shared_ptr<const UserStore>> users; //!< Текущий снимок базы пользователей
+    std::atomic<uint64_t> users_generation;              //!< Поколение снимка (уникально в процессе)
+    std::mutex reload_mutex;                             //!< Последовательность загрузок базы
+    std::string user_db_file;                            //!< Файл базы для reload_users()
+    SaltReservoir salt_reservoir;                        //!< Запас готовых солей
+    IpRateLimiter* rate_limiter;                         //!< Учёт неудачных входов по IP (nullptr - без учёта)
+    
+    CryptoPP::byte ticket_key[TICKET_KEY_SIZE];          //!< Ключ HMAC билетов (случайный на процесс)
+    unsigned ticket_lifetime_sec;                        //!< Срок действия билета, с
+    std::mutex used_tickets_mutex;                       //!< Защита used_tickets
+    //! \brief Нонсы использованных билетов и их срок (окно защиты от повтора)
+    std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> used_tickets;
+    size_t used_tickets_purge_size;                      //!< Размер used_tickets для очистки истёкших
+    
+    //! \brief Получить снимок базы текущего потока
+    //! \details Ссылка действительна до следующего вызова в этом потоке
+    //! \return База пользователей
+    const UserStore& current_users() const;
+    
+    //! \brief Опубликовать новый снимок базы
+    //! \param[in] table Снимок
+    void publish_users(std::shared_ptr<const UserStore> table);
+    
+    //! \brief Передать результат входа ограничителю по IP
+    //! \param[in] success Результат входа
+    //! \param[in] logger Логгер для записи блокировки
+    //! \param[in] client_ip IP адрес клиента
+    //! \return success
+    bool record_auth_result(bool success, Logger& logger, const std::string& client_ip);
+    
+    //! \brief Проверить билет возобновления (см. resume())
+    bool verify_ticket(const std::string& ticket, std::string& login, Logger& logger, const std::string& client_ip);
+    
+    //! \brief Вычислить MD5 соли и пароля
+    //! \param[in] salt Соль
+    //! \param[in] password Пароль
+    //! \param[out] digest Дайджест (16 байт)
+    static void compute_md5_digest(std::string_view salt, std::string_view password,
+                                   CryptoPP::byte* digest);
+    
+    //! \brief Вычислить MAC билета
+    //! \param[in] header Версия, время выдачи и нонс
+    //! \param[in] header_size Размер header
+    //! \param[in] login Логин
+    //! \param[out] mac Усечённый MAC (TICKET_MAC_SIZE байт)
+    void compute_ticket_mac(const CryptoPP::byte* header, size_t header_size,
+                            const std::string& login, CryptoPP::byte* mac) const;
     
 public:
     //! \brief Конструктор по умолчанию
-    AuthManager() = default;
+    //! \details Создаёт случайный ключ билетов: билеты действительны до перезапуска сервера
+    AuthManager();
+    
+    AuthManager(const AuthManager&) = delete;
+    AuthManager& operator=(const AuthManager&) = delete;
     
     //! \brief Загрузить пользователей из файла
     //! \param[in] filename Имя файла с базой пользователей
@@ -32,21 +123,46 @@ public:
     //! \throw std::runtime_error При ошибке чтения файла или отсутствии пользователей
     bool load_users(const std::string& filename);
     
+    //! \brief Перечитать файл базы, заданный в load_users()
+    //! \details Новый снимок подменяет текущий атомарно; сессии, уже прошедшие
+    //! поиск логина, завершают проверку по старому снимку. При ошибке разбора
+    //! остаётся прежняя база
+    //! \param[in] logger Логгер для записи результата
+    //! \return true если база заменена
+    bool reload_users(Logger& logger);
+    
     //! \brief Проверить существование пользователя
     //! \param[in] login Логин пользователя
     //! \return true если пользователь существует
-    bool user_exists(const std::string& login);
+    bool user_exists(const std::string& login) const;
     
     //! \brief Получить пароль пользователя
     //! \param[in] login Логин пользователя
     //! \return Пароль пользователя или пустая строка если пользователь не найден
-    std::string get_password(const std::string& login);
+    std::string get_password(const std::string& login) const;
+    
+    //! \brief Получить количество пользователей текущего снимка
+    //! \return Количество пользователей
+    size_t user_count() const { return current_users().size(); }
     
     //! \brief Сгенерировать случайную соль
+    //! \details Берёт готовую соль из запаса, пополняемого фоновым потоком
     //! \return Соль в шестнадцатеричном формате (16 символов)
     //! \throw std::runtime_error При ошибке генерации
     std::string generate_salt();
     
+    //! \brief Проверить хеш клиента без записи в журнал
+    //! \details Один поиск в базе, хеширование из буферов на стеке и сравнение
+    //! двоичных дайджестов за постоянное время; память в куче не выделяется.
+    //! Хеш принимается в шестнадцатеричном виде в любом регистре
+    //! \param[in] login Логин пользователя
+    //! \param[in] client_hash Хеш от клиента
+    //! \param[in] salt Соль использованная для хеширования
+    //! \return Результат проверки
+    AuthResult check_credentials(const std::string& login,
+                                 const std::string& client_hash,
+                                 const std::string& salt) const;
+    
     //! \brief Аутентифицировать пользователя
     //! \param[in] login Логин пользователя
     //! \param[in] client_hash Хеш от клиента
@@ -66,9 +182,52 @@ public:
     //! \return MD5 хеш в верхнем регистре
     static std::string compute_md5_hash(const std::string& salt, const std::string& password);
     
-    //! \brief Получить копию базы пользователей
-    //! \return Константная ссылка на базу пользователей
-    const std::unordered_map<std::string, std::string>& get_users() const { return users; }
+    //! \brief Разобрать первое сообщение клиента
+    //! \details Логин не может содержать ':', поэтому префиксы однозначны
+    //! \param[in,out] message Сообщение; префикс удаляется
+    //! \return Вид сообщения
+    static LoginKind parse_login_message(std::string& message);
+    
+    //! \brief Получить длину билета для логина
+    //! \details Клиент знает свой логин, поэтому читает после "OK" ровно столько байт
+    //! \param[in] login Логин
+    //! \return Длина билета в символах
+    static size_t ticket_length(const std::string& login) { return 2 * TICKET_BINARY_SIZE + login.size(); }
+    
+    //! \brief Выдать билет возобновления
+    //! \details Билет - шестнадцатеричные версия, время выдачи, случайный нонс и MAC,
+    //! затем логин. MAC - HMAC-SHA256 ключом сервера, клиент не может изменить билет
+    //! \param[in] login Аутентифицированный логин
+    //! \return Билет длиной ticket_length(login)
+    //! \throw std::runtime_error При ошибке генерации нонса
+    std::string issue_ticket(const std::string& login);
+    
+    //! \brief Аутентифицировать клиента по билету возобновления
+    //! \details Билет принимается один раз и только в течение срока действия;
+    //! нонсы принятых билетов хранятся до истечения их срока
+    //! \param[in] ticket Билет
+    //! \param[out] login Логин из билета
+    //! \param[in] logger Логгер для записи событий
+    //! \param[in] client_ip IP адрес клиента
+    //! \return true если билет действителен
+    bool resume(const std::string& ticket, std::string& login, Logger& logger, const std::string& client_ip);
+    
+    //! \brief Установить срок действия билетов
+    //! \param[in] seconds Срок в секундах
+    void set_ticket_lifetime(unsigned seconds) { ticket_lifetime_sec = seconds; }
+    
+    //! \brief Получить срок действия билетов
+    //! \return Срок в секундах
+    unsigned get_ticket_lifetime() const { return ticket_lifetime_sec; }
+    
+    //! \brief Подключить ограничитель по IP
+    //! \details authenticate() и resume() сообщают ему результат каждого входа
+    //! \param[in] limiter Ограничитель (nullptr - без учёта неудач)
+    void set_rate_limiter(IpRateLimiter* limiter) { rate_limiter = limiter; }
+    
+    //! \brief Получить снимок базы пользователей
+    //! \return Неизменяемый снимок, действительный независимо от перезагрузок
+    std::shared_ptr<const UserStore> get_users() const { return users.load(std::memory_order_acquire); }
 };
 
 #endif // AUTHMANAGER_H
@@ -0,0 +1,303 @@
+/*! \file BinaryLog.cpp
+ *  \brief Реализация классов BinaryLogRecord и BinaryLogDecoder
+ *  \details Содержит кодирование записей двоичного журнала и их преобразование в текст или JSON
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "BinaryLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+
+namespace {
+
+constexpr uint8_t IP_V4 = 4;     //!< Адрес хранится в 4 байтах
+constexpr uint8_t IP_STRING = 0; //!< Адрес хранится строкой
+
+//! \brief Чтение аргументов записи с проверкой границ
+class PayloadReader {
+private:
+    const char* data;
+    size_t size;
+    size_t offset = 0;
+
+    void need(size_t count) const {
+        if (size - offset < count) {
+            throw std::runtime_error("Corrupted binary log: argument out of record bounds");
+        }
+    }
+
+public:
+    PayloadReader(const char* data, size_t size) : data(data), size(size) {}
+
+    std::string_view bytes(size_t count) {
+        need(count);
+        std::string_view result(data + offset, count);
+        offset += count;
+        return result;
+    }
+
+    template <typename T>
+    T number() {
+        T value;
+        memcpy(&value, bytes(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view string() { return bytes(number<uint16_t>()); }
+
+    bool flag() { return number<uint8_t>() != 0; }
+
+    std::string ip() {
+        if (number<uint8_t>() == IP_V4) {
+            char text[INET_ADDRSTRLEN] = "unknown";
+            inet_ntop(AF_INET, bytes(4).data(), text, sizeof(text));
+            return text;
+        }
+        return std::string(string());
+    }
+};
+
+//! \brief Время в формате текстового журнала
+std::string format_time(int64_t wall_ns) {
+    std::time_t seconds = static_cast<std::time_t>(wall_ns / 1000000000);
+    struct tm local_time;
+    localtime_r(&seconds, &local_time);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_time);
+    return buffer;
+}
+
+//! \brief Строка JSON в кавычках
+std::string json_string(std::string_view text) {
+    std::string result = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    result += escaped;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result + "\"";
+}
+
+} // namespace
+
+BinaryLogRecord::BinaryLogRecord(LogEvent event) {
+    uint16_t event_id = static_cast<uint16_t>(event);
+    uint16_t payload_size = 0;
+    int64_t ticks = now_ticks();
+    entry.append(&event_id, sizeof(event_id));
+    entry.append(&payload_size, sizeof(payload_size));
+    entry.append(&ticks, sizeof(ticks));
+}
+
+int64_t BinaryLogRecord::now_ticks() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+BinaryLogRecord& BinaryLogRecord::add(std::string_view text) {
+    uint16_t length = static_cast<uint16_t>(std::min(text.size(), MAX_STRING));
+    entry.append(&length, sizeof(length));
+    entry.append(text.data(), length);
+    return *this;
+}
+
+BinaryLogRecord& BinaryLogRecord::add_flag(bool flag) {
+    uint8_t value = flag ? 1 : 0;
+    entry.append(&value, sizeof(value));
+    return *this;
+}
+
+BinaryLogRecord& BinaryLogRecord::add_count(uint32_t count) {
+    entry.append(&count, sizeof(count));
+    return *this;
+}
+
+BinaryLogRecord& BinaryLogRecord::add_ip(std::string_view ip) {
+    // События сессии идут с одного адреса - inet_pton() вызывается при смене адреса
+    thread_local char cached_text[INET_ADDRSTRLEN] = "";
+    thread_local size_t cached_size = 0;
+    thread_local uint32_t cached_address = 0;
+    if (cached_size == 0 || ip.size() != cached_size || memcmp(ip.data(), cached_text, cached_size) != 0) {
+        char text[INET_ADDRSTRLEN];
+        struct in_addr addr;
+        if (ip.empty() || ip.size() >= sizeof(text)) {
+            return add_ip_string(ip);
+        }
+        memcpy(text, ip.data(), ip.size());
+        text[ip.size()] = '\0';
+        if (inet_pton(AF_INET, text, &addr) != 1) {
+            return add_ip_string(ip);
+        }
+        memcpy(cached_text, ip.data(), ip.size());
+        cached_size = ip.size();
+        cached_address = addr.s_addr;
+    }
+    uint8_t kind = IP_V4;
+    entry.append(&kind, sizeof(kind));
+    entry.append(&cached_address, sizeof(cached_address));
+    return *this;
+}
+
+BinaryLogRecord& BinaryLogRecord::add_ip_string(std::string_view ip) {
+    uint8_t kind = IP_STRING;
+    entry.append(&kind, sizeof(kind));
+    return add(ip);
+}
+
+LogEntry BinaryLogRecord::finish() {
+    // Строки усечены до MAX_STRING, а аргументов не больше четырёх - длина помещается в 16 бит
+    uint16_t payload_size = static_cast<uint16_t>(entry.size() - HEADER_SIZE);
+    memcpy(entry.data() + 2, &payload_size, sizeof(payload_size));
+    return std::move(entry);
+}
+
+LogEntry BinaryLogRecord::session() {
+    int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    BinaryLogRecord record(LogEvent::Session);
+    record.entry.append(SESSION_MAGIC, sizeof(SESSION_MAGIC));
+    record.entry.append(&wall_ns, sizeof(wall_ns));
+    return record.finish();
+}
+
+std::string BinaryLogDecoder::describe_batch(LogEvent event, uint32_t count) {
+    switch (event) {
+        case LogEvent::BatchStarted:
+            return "Processing client data";
+        case LogEvent::BatchProcessed:
+            return "Successfully processed " + std::to_string(count) + " vectors";
+        default:
+            return "Connection served " + std::to_string(count) + " batches";
+    }
+}
+
+size_t BinaryLogDecoder::decode(std::istream& in, std::ostream& out, LogOutputFormat format) {
+    static const char* const event_names[] = {"session", "message", "auth", "connection", "data", "error", "debug",
+                                                 "batch_started", "batch_processed", "connection_served"};
+    bool in_session = false;
+    int64_t base_wall = 0;
+    int64_t base_ticks = 0;
+    size_t count = 0;
+    char header[BinaryLogRecord::HEADER_SIZE];
+    std::string payload;
+
+    while (in.read(header, sizeof(header))) {
+        uint16_t event_id;
+        uint16_t payload_size;
+        int64_t ticks;
+        memcpy(&event_id, header, sizeof(event_id));
+        memcpy(&payload_size, header + 2, sizeof(payload_size));
+        memcpy(&ticks, header + 4, sizeof(ticks));
+        payload.resize(payload_size);
+        if (!in.read(payload.data(), payload_size)) {
+            throw std::runtime_error("Corrupted binary log: truncated record");
+        }
+        PayloadReader reader(payload.data(), payload.size());
+        LogEvent event = static_cast<LogEvent>(event_id);
+
+        if (event == LogEvent::Session) {
+            if (reader.bytes(sizeof(BinaryLogRecord::SESSION_MAGIC)) !=
+                std::string_view(BinaryLogRecord::SESSION_MAGIC, sizeof(BinaryLogRecord::SESSION_MAGIC))) {
+                throw std::runtime_error("Not a binary log: bad session signature");
+            }
+            base_wall = reader.number<int64_t>();
+            base_ticks = ticks;
+            in_session = true;
+            continue;
+        }
+        if (!in_session) {
+            throw std::runtime_error("Not a binary log: record before session start");
+        }
+        if (event_id >= sizeof(event_names) / sizeof(event_names[0])) {
+            continue; // Запись нового вида: длина известна, пропускаем
+        }
+
+        int64_t wall_ns = base_wall + (ticks - base_ticks);
+        std::string time = format_time(wall_ns);
+        std::string text;
+        std::string json;
+        switch (event) {
+            case LogEvent::Auth: {
+                std::string ip = reader.ip();
+                std::string_view login = reader.string();
+                bool success = reader.flag();
+                std::string_view details = reader.string();
+                text = "AUTH [" + ip + "] user '" + std::string(login) + "' : " + (success ? "SUCCESS" : "FAILED");
+                if (!details.empty()) {
+                    text += " (" + std::string(details) + ")";
+                }
+                json = ",\"ip\":" + json_string(ip) + ",\"login\":" + json_string(login) +
+                       ",\"success\":" + (success ? "true" : "false") + ",\"details\":" + json_string(details);
+                break;
+            }
+            case LogEvent::Connection: {
+                std::string ip = reader.ip();
+                bool connected = reader.flag();
+                text = "CLIENT [" + ip + "] " + (connected ? "connected" : "disconnected");
+                json = ",\"ip\":" + json_string(ip) + ",\"connected\":" + (connected ? "true" : "false");
+                break;
+            }
+            case LogEvent::Data: {
+                std::string ip = reader.ip();
+                std::string_view operation = reader.string();
+                text = "DATA [" + ip + "] " + std::string(operation);
+                json = ",\"ip\":" + json_string(ip) + ",\"operation\":" + json_string(operation);
+                break;
+            }
+            case LogEvent::BatchStarted:
+            case LogEvent::BatchProcessed:
+            case LogEvent::ConnectionServed: {
+                std::string ip = reader.ip();
+                uint32_t batch_count = event == LogEvent::BatchStarted ? 0 : reader.number<uint32_t>();
+                text = "DATA [" + ip + "] " + describe_batch(event, batch_count);
+                json = ",\"ip\":" + json_string(ip);
+                if (event != LogEvent::BatchStarted) {
+                    json += ",\"count\":" + std::to_string(batch_count);
+                }
+                break;
+            }
+            default: {
+                std::string_view message = reader.string();
+                const char* prefix = event == LogEvent::Error ? "ERROR: " : event == LogEvent::Debug ? "DEBUG: " : "";
+                text = prefix + std::string(message);
+                json = ",\"message\":" + json_string(message);
+                break;
+            }
+        }
+
+        if (format == LogOutputFormat::Json) {
+            out << "{\"time\":\"" << time << "\",\"ns\":" << wall_ns << ",\"event\":\""
+                << event_names[event_id] << "\"" << json << "}\n";
+        } else {
+            out << "[" << time << "] " << text << "\n";
+        }
+        count++;
+    }
+    if (in.gcount() != 0) {
+        throw std::runtime_error("Corrupted binary log: truncated record header");
+    }
+    return count;
+}
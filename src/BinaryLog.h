@@ -0,0 +1,116 @@
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+#include "LogEntry.h"
+
+//! \brief Вид записи двоичного журнала (статический идентификатор формата)
+enum class LogEvent : uint16_t {
+    Session = 0,     //!< Начало сеанса записи: сигнатура и привязка тиков к настенному времени
+    Message = 1,     //!< Общее сообщение: текст
+    Auth = 2,        //!< Аутентификация: IP, логин, результат, детали
+    Connection = 3,  //!< Подключение или отключение: IP, флаг
+    Data = 4,        //!< Обработка данных: IP, операция
+    Error = 5,       //!< Ошибка: текст
+    Debug = 6,       //!< Отладочное сообщение: текст
+    BatchStarted = 7,      //!< Начат пакет векторов: IP
+    BatchProcessed = 8,    //!< Пакет обработан: IP, количество векторов
+    ConnectionServed = 9   //!< Соединение обслужило пакеты: IP, количество пакетов
+};
+
+//! \brief Построитель записи двоичного журнала
+//! \details Запись: вид (2 байта), длина аргументов (2 байта), тики steady_clock
+//! в наносекундах (8 байт), затем аргументы без преобразования в текст:
+//! строка - длина (2 байта) и байты, флаг - 1 байт, счётчик - 4 байта, IP - байт вида и 4 байта
+//! IPv4 адреса (вид 4) или строка (вид 0).
+//! Числа - в порядке байт хоста, записавшего журнал.
+//! Запись строится прямо в LogEntry: событие с короткими аргументами не
+//! выделяет памяти, а разобранный IPv4 адрес кэшируется в потоке.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class BinaryLogRecord {
+public:
+    static constexpr size_t HEADER_SIZE = 12;            //!< Размер заголовка записи
+    static constexpr size_t MAX_STRING = 16383;          //!< Наибольшая длина строкового аргумента
+    static constexpr char SESSION_MAGIC[8] = {'V', 'S', 'B', 'L', 'O', 'G', '0', '1'}; //!< Сигнатура сеанса
+
+private:
+    LogEntry entry; //!< Байты записи
+
+public:
+    //! \brief Начать запись с текущим временем
+    //! \param[in] event Вид записи
+    explicit BinaryLogRecord(LogEvent event);
+
+    //! \brief Добавить строку (длиннее MAX_STRING - усекается)
+    //! \param[in] text Строка
+    //! \return Запись
+    BinaryLogRecord& add(std::string_view text);
+
+    //! \brief Добавить флаг
+    //! \param[in] flag Флаг
+    //! \return Запись
+    BinaryLogRecord& add_flag(bool flag);
+
+    //! \brief Добавить счётчик
+    //! \param[in] count Значение
+    //! \return Запись
+    BinaryLogRecord& add_count(uint32_t count);
+
+    //! \brief Добавить IP адрес
+    //! \details IPv4 в точечной записи хранится в 4 байтах, иное - строкой
+    //! \param[in] ip Адрес
+    //! \return Запись
+    BinaryLogRecord& add_ip(std::string_view ip);
+
+    //! \brief Добавить адрес строкой (не IPv4)
+    //! \param[in] ip Адрес
+    //! \return Запись
+    BinaryLogRecord& add_ip_string(std::string_view ip);
+
+    //! \brief Завершить запись
+    //! \return Запись для очереди журнала (забирается из построителя)
+    LogEntry finish();
+
+    //! \brief Запись начала сеанса
+    //! \return Запись с сигнатурой и настенным временем в наносекундах
+    static LogEntry session();
+
+    //! \brief Текущее время steady_clock, нс
+    static int64_t now_ticks();
+};
+
+//! \brief Формат вывода декодера
+enum class LogOutputFormat {
+    Text,  //!< Строки как у текстового журнала
+    Json   //!< Объект JSON на строку
+};
+
+//! \brief Декодер двоичного журнала
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class BinaryLogDecoder {
+public:
+    //! \brief Текст события обработки пакетов с постоянным форматом
+    //! \param[in] event BatchStarted, BatchProcessed или ConnectionServed
+    //! \param[in] count Количество векторов или пакетов
+    //! \return Текст операции, как в записи DATA текстового журнала
+    static std::string describe_batch(LogEvent event, uint32_t count);
+
+    //! \brief Преобразовать двоичный журнал в текст или JSON
+    //! \param[in] in Поток журнала
+    //! \param[out] out Поток вывода
+    //! \param[in] format Формат вывода
+    //! \return Количество выведенных записей
+    //! \throw std::runtime_error При повреждённом журнале или записи до начала сеанса
+    static size_t decode(std::istream& in, std::ostream& out, LogOutputFormat format);
+};
+
+#endif // BINARYLOG_H
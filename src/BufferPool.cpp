@@ -0,0 +1,169 @@
+/*! \file BufferPool.cpp
+ *  \brief Реализация класса BufferPool
+ *  \details Содержит пул буферов с классами размеров и кэшами потоков
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "BufferPool.h"
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace {
+
+//! \brief Кэш свободных буферов потока
+//! \details При завершении потока буферы возвращаются в общие списки пула
+struct ThreadCache {
+    std::array<std::vector<void*>, BufferPool::CLASS_COUNT> free_buffers;
+
+    ~ThreadCache() {
+        for (unsigned size_class = 0; size_class < BufferPool::CLASS_COUNT; size_class++) {
+            for (void* buffer : free_buffers[size_class]) {
+                BufferPool::instance().release_global(buffer, size_class);
+            }
+        }
+    }
+};
+
+thread_local ThreadCache thread_cache;
+
+}
+
+BufferPool::BufferPool()
+    : huge_pages(HugePages::Transparent), hits(0), misses(0),
+      huge_page_allocations(0), bytes_reserved(0) {
+}
+
+BufferPool::~BufferPool() {
+    for (unsigned size_class = 0; size_class < CLASS_COUNT; size_class++) {
+        for (void* buffer : global_free[size_class]) {
+            free_block(buffer, class_size(size_class));
+        }
+    }
+}
+
+BufferPool& BufferPool::instance() {
+    static BufferPool pool;
+    return pool;
+}
+
+unsigned BufferPool::size_class(size_t bytes) {
+    unsigned shift = MIN_CLASS_SHIFT;
+    while (shift <= MAX_CLASS_SHIFT && (size_t(1) << shift) < bytes) {
+        shift++;
+    }
+    return shift - MIN_CLASS_SHIFT;
+}
+
+void* BufferPool::allocate_block(size_t bytes) {
+    void* block = nullptr;
+    if (bytes < HUGE_PAGE_SIZE) {
+        block = std::aligned_alloc(64, bytes);
+        if (!block) {
+            throw std::bad_alloc();
+        }
+    } else {
+        HugePages mode = huge_pages.load(std::memory_order_relaxed);
+        if (mode == HugePages::Explicit && bytes % HUGE_PAGE_SIZE == 0) {
+            block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (block == MAP_FAILED) {
+                block = nullptr;
+            } else {
+                huge_page_allocations.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (!block) {
+            block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (block == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            if (mode != HugePages::None) {
+                madvise(block, bytes, MADV_HUGEPAGE);
+            }
+        }
+    }
+    bytes_reserved.fetch_add(bytes, std::memory_order_relaxed);
+    return block;
+}
+
+void BufferPool::free_block(void* block, size_t bytes) {
+    if (bytes < HUGE_PAGE_SIZE) {
+        std::free(block);
+    } else {
+        munmap(block, bytes);
+    }
+    bytes_reserved.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void* BufferPool::acquire(size_t bytes, size_t& capacity) {
+    unsigned size_class = BufferPool::size_class(bytes);
+    if (size_class >= CLASS_COUNT) {
+        // Больше наибольшего класса: отдельное выделение, округлённое до большой страницы
+        capacity = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return allocate_block(capacity);
+    }
+    capacity = class_size(size_class);
+    
+    std::vector<void*>& local = thread_cache.free_buffers[size_class];
+    if (!local.empty()) {
+        void* buffer = local.back();
+        local.pop_back();
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return buffer;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<void*>& shared = global_free[size_class];
+        if (!shared.empty()) {
+            void* buffer = shared.back();
+            shared.pop_back();
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return buffer;
+        }
+    }
+    
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return allocate_block(capacity);
+}
+
+void BufferPool::release(void* buffer, size_t capacity) {
+    unsigned size_class = BufferPool::size_class(capacity);
+    if (size_class >= CLASS_COUNT || class_size(size_class) != capacity) {
+        free_block(buffer, capacity);
+        return;
+    }
+    
+    std::vector<void*>& local = thread_cache.free_buffers[size_class];
+    if (local.size() < THREAD_CACHE_DEPTH) {
+        local.push_back(buffer);
+        return;
+    }
+    release_global(buffer, size_class);
+}
+
+void BufferPool::release_global(void* buffer, unsigned size_class) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<void*>& shared = global_free[size_class];
+        if (shared.size() < GLOBAL_CACHE_DEPTH) {
+            shared.push_back(buffer);
+            return;
+        }
+    }
+    free_block(buffer, class_size(size_class));
+}
+
+BufferPoolStats BufferPool::get_stats() const {
+    BufferPoolStats stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.huge_page_allocations = huge_page_allocations.load(std::memory_order_relaxed);
+    stats.bytes_reserved = bytes_reserved.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,187 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//! \brief Использование больших страниц для крупных буферов
+enum class HugePages {
+    None,         //!< Обычные страницы
+    Transparent,  //!< Прозрачные большие страницы (madvise(MADV_HUGEPAGE))
+    Explicit      //!< Явные большие страницы (MAP_HUGETLB), при нехватке - прозрачные
+};
+
+//! \brief Снимок счётчиков пула буферов
+struct BufferPoolStats {
+    uint64_t hits = 0;                   //!< Выдано повторно использованных буферов
+    uint64_t misses = 0;                 //!< Выделено новых буферов
+    uint64_t huge_page_allocations = 0;  //!< Выделено на явных больших страницах
+    uint64_t bytes_reserved = 0;         //!< Байт памяти, выделенной под буферы
+
+    //! \brief Сформировать строку для журнала
+    //! \return Текстовое представление счётчиков
+    std::string to_string() const {
+        return "hits=" + std::to_string(hits) +
+               " misses=" + std::to_string(misses) +
+               " huge_pages=" + std::to_string(huge_page_allocations) +
+               " reserved=" + std::to_string(bytes_reserved);
+    }
+};
+
+//! \brief Пул буферов полезной нагрузки с классами размеров
+//! \details Размеры округляются вверх до степени двойки (от 64 байт до 16 МБ),
+//! буферы выровнены по 64 байта и не обнуляются. Освобождённый буфер сначала
+//! попадает в кэш своего потока, при его переполнении - в общий список класса,
+//! поэтому повторное использование между векторами и сессиями обычно обходится
+//! без блокировок. Классы от 2 МБ выделяются через mmap и могут использовать
+//! большие страницы.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class BufferPool {
+public:
+    static constexpr unsigned MIN_CLASS_SHIFT = 6;    //!< Наименьший класс: 64 байта
+    static constexpr unsigned MAX_CLASS_SHIFT = 24;   //!< Наибольший класс: 16 МБ
+    static constexpr unsigned CLASS_COUNT = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1; //!< Количество классов
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;  //!< Размер большой страницы
+    static constexpr size_t THREAD_CACHE_DEPTH = 4;   //!< Буферов класса в кэше потока
+    static constexpr size_t GLOBAL_CACHE_DEPTH = 16;  //!< Буферов класса в общем списке
+
+private:
+    std::mutex mutex;                                          //!< Защита общих списков
+    std::array<std::vector<void*>, CLASS_COUNT> global_free;   //!< Общие списки свободных буферов
+    std::atomic<HugePages> huge_pages;                         //!< Режим больших страниц
+    std::atomic<uint64_t> hits;                                //!< Повторно использовано буферов
+    std::atomic<uint64_t> misses;                              //!< Выделено новых буферов
+    std::atomic<uint64_t> huge_page_allocations;               //!< Выделено на явных больших страницах
+    std::atomic<uint64_t> bytes_reserved;                      //!< Выделено байт
+
+    BufferPool();
+
+    //! \brief Выделить память под буфер класса
+    void* allocate_block(size_t bytes);
+
+    //! \brief Вернуть память буфера системе
+    void free_block(void* block, size_t bytes);
+
+public:
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    //! \brief Получить пул процесса
+    //! \return Единственный экземпляр пула
+    static BufferPool& instance();
+
+    //! \brief Определить класс размера
+    //! \param[in] bytes Требуемый размер
+    //! \return Номер класса (CLASS_COUNT - больше наибольшего класса)
+    static unsigned size_class(size_t bytes);
+
+    //! \brief Получить размер буфера класса
+    //! \param[in] size_class Номер класса
+    //! \return Размер в байтах
+    static size_t class_size(unsigned size_class) { return size_t(1) << (size_class + MIN_CLASS_SHIFT); }
+
+    //! \brief Выбрать режим больших страниц для новых буферов
+    //! \param[in] mode Режим
+    void set_huge_pages(HugePages mode) { huge_pages.store(mode, std::memory_order_relaxed); }
+
+    //! \brief Получить буфер
+    //! \param[in] bytes Требуемый размер
+    //! \param[out] capacity Фактический размер буфера
+    //! \return Буфер, выровненный по 64 байта
+    //! \throw std::bad_alloc При нехватке памяти
+    void* acquire(size_t bytes, size_t& capacity);
+
+    //! \brief Вернуть буфер в пул
+    //! \param[in] buffer Буфер
+    //! \param[in] capacity Размер буфера, полученный из acquire()
+    void release(void* buffer, size_t capacity);
+
+    //! \brief Вернуть буфер в общий список (из кэша завершающегося потока)
+    //! \param[in] buffer Буфер
+    //! \param[in] size_class Номер класса
+    void release_global(void* buffer, unsigned size_class);
+
+    //! \brief Получить счётчики пула
+    //! \return Снимок счётчиков
+    BufferPoolStats get_stats() const;
+};
+
+//! \brief Буфер из пула с автоматическим возвратом
+//! \details Содержимое не инициализируется; reserve() меняет буфер на больший
+//! без копирования данных
+class PooledBuffer {
+private:
+    void* buffer;      //!< Память буфера
+    size_t capacity;   //!< Размер буфера
+
+public:
+    PooledBuffer() : buffer(nullptr), capacity(0) {}
+
+    //! \brief Получить буфер не меньше bytes
+    //! \param[in] bytes Требуемый размер
+    explicit PooledBuffer(size_t bytes) : buffer(nullptr), capacity(0) { reserve(bytes); }
+
+    PooledBuffer(PooledBuffer&& other) noexcept : buffer(other.buffer), capacity(other.capacity) {
+        other.buffer = nullptr;
+        other.capacity = 0;
+    }
+
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            buffer = other.buffer;
+            capacity = other.capacity;
+            other.buffer = nullptr;
+            other.capacity = 0;
+        }
+        return *this;
+    }
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    ~PooledBuffer() { reset(); }
+
+    //! \brief Обеспечить размер не меньше bytes
+    //! \param[in] bytes Требуемый размер
+    void reserve(size_t bytes) {
+        if (bytes <= capacity && buffer) {
+            return;
+        }
+        reset();
+        buffer = BufferPool::instance().acquire(bytes, capacity);
+    }
+
+    //! \brief Вернуть буфер в пул
+    void reset() {
+        if (buffer) {
+            BufferPool::instance().release(buffer, capacity);
+            buffer = nullptr;
+            capacity = 0;
+        }
+    }
+
+    //! \brief Получить память буфера
+    //! \return Указатель на начало буфера
+    char* data() const { return static_cast<char*>(buffer); }
+
+    //! \brief Получить память буфера как массив элементов
+    //! \return Указатель на начало буфера
+    template<typename T>
+    T* as() const { return static_cast<T*>(buffer); }
+
+    //! \brief Получить размер буфера
+    //! \return Размер в байтах
+    size_t size() const { return capacity; }
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,337 @@
+/*! \file ClientSession.cpp
+ *  \brief Реализация класса ClientSession
+ *  \details Содержит реализацию неблокирующего автомата клиентской сессии
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "ClientSession.h"
+#include "AuthManager.h"
+#include "DataCalculator.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+
+ClientSession::ClientSession(int sock, const std::string& client_ip,
+                             AuthManager& auth_manager, Logger& logger, SessionStats& stats,
+                             unsigned keep_alive_sec)
+    : sock(sock), client_ip(client_ip), auth_manager(auth_manager), logger(logger), stats(stats),
+      state(SessionState::AwaitingLogin), login_kind(LoginKind::Password), authenticated(false),
+      num_vectors(0), vector_index(0), header_value(0), header_received(0),
+      extended_size(0), frame{}, frame_remaining(0), payload(DataCalculator::STREAM_CHUNK_SIZE), payload_remaining(0),
+      payload_received(0), keep_alive_sec(keep_alive_sec), batches(0), awaiting_batch(false),
+      out_sent(0), after_send(SessionState::Finished) {
+    touch();
+}
+
+void ClientSession::touch() {
+    unsigned timeout_sec = idle() ? keep_alive_sec : DataCalculator::DATA_PROCESSING_TIMEOUT_SEC;
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+}
+
+void ClientSession::log_batches() {
+    if (keep_alive_sec > 0) {
+        LOG_BATCH(logger, LogEvent::ConnectionServed, client_ip, static_cast<uint32_t>(batches));
+    }
+}
+
+bool ClientSession::receive_into(void* dst, size_t size, size_t& received) {
+    char* ptr = static_cast<char*>(dst);
+    while (received < size) {
+        ssize_t n = recv(sock, ptr + received, size - received, 0);
+        if (n > 0) {
+            received += n;
+            SessionStats::add(stats.bytes_received, n);
+            awaiting_batch = false;
+            touch();
+            continue;
+        }
+        if (n == 0) {
+            if (idle()) {
+                // Закрытие соединения между пакетами - штатное завершение
+                log_batches();
+                state = SessionState::Finished;
+                return false;
+            }
+            throw std::runtime_error("Connection closed by client during read");
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+        throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+    }
+    return true;
+}
+
+bool ClientSession::receive_message(std::string& message) {
+    char buffer[MAX_MESSAGE_LEN + 1];
+    for (;;) {
+        ssize_t n = recv(sock, buffer, MAX_MESSAGE_LEN, 0);
+        if (n > 0) {
+            buffer[n] = '\0';
+            message = std::string(buffer);
+            touch();
+            return true;
+        }
+        if (n == 0) {
+            throw std::runtime_error("connection closed by client");
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+        throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+    }
+}
+
+void ClientSession::queue_output(const void* data, size_t size, SessionState next) {
+    out_buffer.append(static_cast<const char*>(data), size);
+    after_send = next;
+    switch (state) {
+        case SessionState::AwaitingLogin:
+            // После билета возобновления вместо соли сразу отправляется статус
+            state = next == SessionState::AwaitingHash ? SessionState::SendingSalt : SessionState::SendingStatus;
+            break;
+        case SessionState::AwaitingHash: state = SessionState::SendingStatus; break;
+        default: state = SessionState::SendingResult; break;
+    }
+}
+
+bool ClientSession::flush_output() {
+    while (out_sent < out_buffer.size()) {
+        ssize_t n = send(sock, out_buffer.data() + out_sent, out_buffer.size() - out_sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            out_sent += n;
+            SessionStats::add(stats.bytes_sent, n);
+            touch();
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return false;
+        throw std::runtime_error("send failed: " + std::string(strerror(errno)));
+    }
+    out_buffer.clear();
+    out_sent = 0;
+    return true;
+}
+
+void ClientSession::send_result() {
+    vector_index++;
+    SessionStats::add(stats.vectors_processed);
+    bool last = vector_index >= num_vectors;
+    SessionState next = request.framed ? SessionState::ReadingExtendedSize : SessionState::ReadingVectorSize;
+    if (last) {
+        next = keep_alive_sec > 0 ? SessionState::ReadingVectorCount : SessionState::Finished;
+    }
+    char results[StatsAccumulator<>::MAX_RESULT_SIZE];
+    size_t size = std::visit([&](auto& typed) { return typed.write_results(results, request.swap_bytes); },
+                             accumulator);
+    queue_output(results, size, next);
+    if (last) {
+        batches++;
+        SessionStats::add(stats.batches_processed);
+        LOG_BATCH(logger, LogEvent::BatchProcessed, client_ip, num_vectors);
+        if (keep_alive_sec > 0) {
+            // Согласование действует на один пакет, следующий начинается заново
+            request = DataRequest();
+            awaiting_batch = true;
+        } else {
+            log_batches();
+        }
+    }
+}
+
+void ClientSession::on_authenticated() {
+    if (!authenticated) {
+        SessionStats::add(stats.auth_failures);
+        queue_output("ERR", 3, SessionState::Finished);
+        return;
+    }
+    std::string reply = "OK";
+    if (login_kind != LoginKind::Password) {
+        reply += auth_manager.issue_ticket(login);
+    }
+    queue_output(reply.data(), reply.size(), SessionState::ReadingVectorCount);
+    LOG_BATCH(logger, LogEvent::BatchStarted, client_ip, 0);
+}
+
+void ClientSession::on_vector_size(uint64_t vector_size) {
+    LOG_DEBUG(logger, "Vector " + std::to_string(vector_index) + " has " +
+                      std::to_string(vector_size) + " elements");
+
+    accumulator = make_stats_accumulator(request, vector_size);
+    if (vector_size == 0) {
+        send_result();
+        return;
+    }
+    payload_remaining = vector_size * DataCalculator::element_size(request.element_type);
+    payload_received = 0;
+    state = SessionState::ReadingPayload;
+}
+
+bool ClientSession::step() {
+    switch (state) {
+        case SessionState::AwaitingLogin: {
+            if (!receive_message(login)) return false;
+            if (login.empty()) {
+                throw std::runtime_error("Empty login received");
+            }
+            login_kind = AuthManager::parse_login_message(login);
+            if (login_kind == LoginKind::Resume) {
+                std::string ticket = login;
+                authenticated = auth_manager.resume(ticket, login, logger, client_ip);
+                on_authenticated();
+                return true;
+            }
+            salt = auth_manager.generate_salt();
+            queue_output(salt.data(), salt.size(), SessionState::AwaitingHash);
+            return true;
+        }
+
+        case SessionState::AwaitingHash: {
+            std::string client_hash;
+            if (!receive_message(client_hash)) return false;
+            authenticated = auth_manager.authenticate(login, client_hash, salt, logger, client_ip);
+            on_authenticated();
+            return true;
+        }
+
+        case SessionState::SendingSalt:
+        case SessionState::SendingStatus:
+        case SessionState::SendingResult:
+            if (!flush_output()) return false;
+            state = after_send;
+            touch();
+            return true;
+
+        case SessionState::ReadingVectorCount:
+            if (!receive_into(&header_value, sizeof(header_value), header_received)) return false;
+            header_received = 0;
+            switch (DataCalculator::classify_batch_header(header_value, request)) {
+                case BatchHeader::Frame:
+                    frame.magic = header_value;
+                    header_received = sizeof(frame.magic);
+                    state = SessionState::ReadingFrameHeader;
+                    return true;
+                case BatchHeader::Negotiation:
+                    if (!DataCalculator::apply_negotiation_header(header_value, request, logger)) {
+                        logger.log_error("Rejected negotiation header " + std::to_string(header_value) +
+                                         " from " + client_ip);
+                        queue_output("ERR", 3, SessionState::Finished);
+                        return true;
+                    }
+                    queue_output("OK", 2, SessionState::ReadingVectorCount);
+                    return true;
+                case BatchHeader::Misplaced:
+                    logger.log_error("Rejected frame header after negotiation from " + client_ip);
+                    queue_output("ERR", 3, SessionState::Finished);
+                    return true;
+                case BatchHeader::VectorCount:
+                    break;
+            }
+            num_vectors = DataCalculator::normalize_vector_count(header_value, logger);
+            vector_index = 0;
+            LOG_DEBUG(logger, "Client " + client_ip + " will send " + std::to_string(num_vectors) + " vectors");
+            state = SessionState::ReadingVectorSize;
+            return true;
+
+        case SessionState::ReadingFrameHeader:
+            if (!receive_into(&frame, sizeof(frame), header_received)) return false;
+            header_received = 0;
+            if (!DataCalculator::parse_frame_header(frame, request, logger)) {
+                logger.log_error("Rejected frame header from " + client_ip);
+                queue_output("ERR", 3, SessionState::Finished);
+                return true;
+            }
+            num_vectors = frame.num_vectors;
+            frame_remaining = frame.payload_length;
+            vector_index = 0;
+            LOG_DEBUG(logger, "Client " + client_ip + " will send " + std::to_string(num_vectors) + " vectors");
+            state = SessionState::ReadingExtendedSize;
+            return true;
+
+        case SessionState::ReadingVectorSize:
+            if (!receive_into(&header_value, sizeof(header_value), header_received)) return false;
+            header_received = 0;
+            if (header_value == DataCalculator::VECTOR_SIZE_EXTENDED) {
+                state = SessionState::ReadingExtendedSize;
+            } else {
+                on_vector_size(DataCalculator::normalize_vector_size(header_value, logger));
+            }
+            return true;
+
+        case SessionState::ReadingExtendedSize:
+            if (!receive_into(&extended_size, sizeof(extended_size), header_received)) return false;
+            header_received = 0;
+            if (request.framed) {
+                on_vector_size(DataCalculator::take_frame_vector_size(extended_size, request,
+                                                                      vector_index + 1 == num_vectors,
+                                                                      frame_remaining));
+            } else {
+                on_vector_size(DataCalculator::normalize_extended_vector_size(extended_size, logger));
+            }
+            return true;
+
+        case SessionState::ReadingPayload: {
+            // Элементы сворачиваются порциями, вектор целиком не хранится
+            size_t chunk_bytes = static_cast<size_t>(std::min<uint64_t>(payload_remaining, payload.size()));
+            if (!receive_into(payload.data(), chunk_bytes, payload_received)) return false;
+            size_t width = DataCalculator::element_size(request.element_type);
+            if (request.swap_bytes) {
+                DataCalculator::swap_byte_order(payload.data(), chunk_bytes / width, width);
+            }
+            std::visit([&](auto& typed) { typed.add_unaligned(payload.data(), chunk_bytes / width); }, accumulator);
+            payload_remaining -= chunk_bytes;
+            payload_received = 0;
+            if (payload_remaining == 0) {
+                send_result();
+            }
+            return true;
+        }
+
+        case SessionState::Finished:
+            return false;
+    }
+    return false;
+}
+
+bool ClientSession::handle_io() {
+    try {
+        while (step()) {
+        }
+    } catch (const std::exception& e) {
+        if (authenticated) {
+            logger.log_error("Error processing data from " + client_ip + ": " + e.what());
+        } else {
+            logger.log_error("Session error [" + client_ip + "]: " + e.what());
+            send(sock, "ERR", 3, MSG_NOSIGNAL | MSG_DONTWAIT);
+        }
+        if (batches > 0) {
+            log_batches();
+        }
+        state = SessionState::Finished;
+    }
+    return state != SessionState::Finished;
+}
+
+void ClientSession::expire() {
+    if (idle()) {
+        LOG_DATA(logger, client_ip, "Idle timeout between batches");
+        log_batches();
+        state = SessionState::Finished;
+        return;
+    }
+    logger.log_error("Session timeout for " + client_ip);
+    if (!authenticated) {
+        send(sock, "ERR", 3, MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+    state = SessionState::Finished;
+}
+
+bool ClientSession::wants_write() const {
+    return state == SessionState::SendingSalt ||
+           state == SessionState::SendingStatus ||
+           state == SessionState::SendingResult;
+}
@@ -0,0 +1,172 @@
+#ifndef CLIENTSESSION_H
+#define CLIENTSESSION_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "AuthManager.h"
+#include "BufferPool.h"
+#include "DataCalculator.h"
+#include "SessionStats.h"
+#include "VectorStats.h"
+
+class Logger;
+
+//! \brief Состояние неблокирующей клиентской сессии
+enum class SessionState {
+    AwaitingLogin,       //!< Ожидание логина
+    SendingSalt,         //!< Отправка соли
+    AwaitingHash,        //!< Ожидание хеша
+    SendingStatus,       //!< Отправка OK/ERR
+    ReadingVectorCount,  //!< Чтение количества векторов
+    ReadingFrameHeader,  //!< Чтение заголовка кадра версии 2
+    ReadingVectorSize,   //!< Чтение размера вектора
+    ReadingExtendedSize, //!< Чтение 64-битного размера вектора (в кадре версии 2 - каждого)
+    ReadingPayload,      //!< Чтение элементов вектора
+    SendingResult,       //!< Отправка результата
+    Finished             //!< Сессия завершена, сокет можно закрыть
+};
+
+//! \brief Клиентская сессия в виде конечного автомата
+//! \details Выполняет тот же протокол, что и Server::handle_client, но на неблокирующем
+//! сокете: каждый вызов handle_io() продвигает сессию, пока сокет не вернёт EAGAIN.
+//! При keep_alive_sec > 0 после пакета сессия ждёт следующий; закрытие соединения
+//! клиентом или простой между пакетами завершают её штатно.
+//! Используется циклом EpollLoop, который обслуживает тысячи сессий одним потоком.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class ClientSession {
+private:
+    static constexpr size_t MAX_MESSAGE_LEN = 1024; //!< Максимальная длина логина/хеша
+
+    int sock;                          //!< Неблокирующий сокет клиента
+    std::string client_ip;             //!< IP адрес клиента
+    AuthManager& auth_manager;         //!< Менеджер аутентификации
+    Logger& logger;                    //!< Логгер
+    SessionStats& stats;               //!< Счётчики потока, обслуживающего сессию
+    SessionState state;                //!< Текущее состояние
+
+    std::string login;                 //!< Логин клиента
+    LoginKind login_kind;              //!< Вид первого сообщения (пароль, запрос билета, билет)
+    std::string salt;                  //!< Выданная соль
+    bool authenticated;                //!< Результат аутентификации
+
+    uint32_t num_vectors;              //!< Количество векторов в пакете
+    uint32_t vector_index;             //!< Номер текущего вектора
+    uint32_t header_value;             //!< Буфер для 4-байтовых заголовков
+    size_t header_received;            //!< Принято байт заголовка
+    uint64_t extended_size;            //!< Буфер для 8-байтового размера вектора
+    FrameHeader frame;                 //!< Заголовок кадра версии 2
+    uint64_t frame_remaining;          //!< Неразобранная длина нагрузки кадра, байт
+    PooledBuffer payload;              //!< Порция элементов текущего вектора
+    uint64_t payload_remaining;        //!< Осталось принять байт элементов
+    DataRequest request;               //!< Согласованные тип элементов и маска операций
+    AnyStatsAccumulator accumulator;   //!< Статистики принятых порций
+    size_t payload_received;           //!< Принято байт текущей порции
+
+    unsigned keep_alive_sec;           //!< Простой между пакетами, с (0 - один пакет)
+    uint64_t batches;                  //!< Обработано пакетов
+    bool awaiting_batch;               //!< Пакет завершён, следующий ещё не начался
+
+    std::string out_buffer;            //!< Данные, ожидающие отправки
+    size_t out_sent;                   //!< Отправлено байт из out_buffer
+    SessionState after_send;           //!< Состояние после завершения отправки
+
+    std::chrono::steady_clock::time_point deadline; //!< Срок ожидания следующего события
+
+    //! \brief Продлить срок ожидания
+    //! \details Между пакетами срок - keep_alive_sec, иначе DATA_PROCESSING_TIMEOUT_SEC
+    void touch();
+
+    //! \brief Проверить, ждёт ли сессия начала следующего пакета
+    //! \return true если результаты пакета отправлены, а новых данных ещё нет
+    bool idle() const { return awaiting_batch && state == SessionState::ReadingVectorCount; }
+
+    //! \brief Записать в журнал количество пакетов соединения
+    void log_batches();
+
+    //! \brief Принять недостающие байты в буфер
+    //! \param[out] dst Буфер назначения
+    //! \param[in] size Требуемый размер
+    //! \param[in,out] received Уже принято байт
+    //! \return true если буфер заполнен, false если данных пока нет
+    //! \throw std::runtime_error При закрытии соединения или ошибке recv
+    bool receive_into(void* dst, size_t size, size_t& received);
+
+    //! \brief Принять текстовое сообщение (логин или хеш) за один recv
+    //! \param[out] message Принятая строка
+    //! \return true если сообщение принято, false если данных пока нет
+    //! \throw std::runtime_error При закрытии соединения или ошибке recv
+    bool receive_message(std::string& message);
+
+    //! \brief Поставить данные в очередь на отправку
+    //! \param[in] data Данные
+    //! \param[in] size Размер данных
+    //! \param[in] next Состояние после отправки
+    void queue_output(const void* data, size_t size, SessionState next);
+
+    //! \brief Отправить накопленные данные
+    //! \return true если всё отправлено, false если сокет заполнен
+    //! \throw std::runtime_error При ошибке send
+    bool flush_output();
+
+    //! \brief Выполнить один шаг автомата
+    //! \return true если шаг выполнен, false если нужно ждать готовности сокета
+    bool step();
+
+    //! \brief Ответить на аутентификацию
+    //! \details При успехе - "OK" (и билет возобновления, если клиент его запросил
+    //! или предъявил), иначе - "ERR" и завершение сессии
+    void on_authenticated();
+
+    //! \brief Начать приём элементов вектора
+    //! \param[in] vector_size Количество элементов
+    void on_vector_size(uint64_t vector_size);
+
+    //! \brief Отправить результаты текущего вектора
+    //! \details Статистики по согласованной маске в согласованном типе элементов
+    void send_result();
+
+public:
+    //! \brief Конструктор сессии
+    //! \param[in] sock Неблокирующий сокет клиента
+    //! \param[in] client_ip IP адрес клиента
+    //! \param[in] auth_manager Менеджер аутентификации
+    //! \param[in] logger Логгер
+    //! \param[in] stats Счётчики потока, обслуживающего сессию
+    //! \param[in] keep_alive_sec Простой между пакетами, с (0 - один пакет на подключение)
+    ClientSession(int sock, const std::string& client_ip, AuthManager& auth_manager,
+                  Logger& logger, SessionStats& stats, unsigned keep_alive_sec = 0);
+
+    //! \brief Продвинуть сессию на доступных данных
+    //! \return true если сессия продолжается, false если её нужно закрыть
+    bool handle_io();
+
+    //! \brief Завершить сессию по таймауту
+    void expire();
+
+    //! \brief Проверить, ждёт ли сессия готовности сокета к записи
+    //! \return true в состояниях отправки
+    bool wants_write() const;
+
+    //! \brief Проверить истечение срока ожидания
+    //! \param[in] now Текущее время
+    //! \return true если срок истёк
+    bool expired(std::chrono::steady_clock::time_point now) const { return now >= deadline; }
+
+    //! \brief Получить сокет сессии
+    //! \return Дескриптор сокета
+    int socket() const { return sock; }
+
+    //! \brief Получить текущее состояние
+    //! \return Состояние автомата
+    SessionState get_state() const { return state; }
+
+    //! \brief Получить IP адрес клиента
+    //! \return IP адрес
+    const std::string& get_client_ip() const { return client_ip; }
+};
+
+#endif // CLIENTSESSION_H
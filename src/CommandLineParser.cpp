@@ -32,6 +32,76 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
                        "Файл базы пользователей")
             ("log,l", po::value<std::string>(&log_file)->default_value("server.log"), 
                      "Файл журнала")
+            ("threads,t", po::value<unsigned>(&server_options.worker_threads)
+                              ->default_value(server_options.worker_threads),
+                         "Количество рабочих потоков (0 - без пула)")
+            ("mode,m", po::value<std::string>(&mode_name)->default_value("blocking"),
+                      "Режим обслуживания: blocking, epoll, sharded или coro")
+            ("io", po::value<std::string>(&io_name)->default_value("select"),
+                  "Ввод-вывод блокирующих сессий: select или uring")
+            ("backlog", po::value<int>(&server_options.listen_backlog)
+                            ->default_value(server_options.listen_backlog),
+                       "Длина очереди подключений listen()")
+            ("max-sessions", po::value<unsigned>(&server_options.max_sessions)->default_value(0),
+                            "Предел одновременных сессий (0 - без предела)")
+            ("shed-target", po::value<unsigned>(&server_options.shed_target_ms)->default_value(0),
+                           "Целевое время ожидания в очереди пула, мс (0 - без отсечения)")
+            ("huge-pages", po::value<std::string>(&huge_pages_name)->default_value("thp"),
+                          "Большие страницы для буферов векторов: none, thp или explicit")
+            ("compute-threads", po::value<unsigned>(&server_options.compute_threads)
+                                    ->default_value(server_options.compute_threads),
+                               "Потоков параллельного суммирования длинных векторов (0 - без пула)")
+            ("keep-alive", po::value<unsigned>(&server_options.keep_alive_sec)
+                               ->default_value(server_options.keep_alive_sec),
+                          "Простой соединения между пакетами векторов, с (0 - один пакет на подключение)")
+            ("ticket-lifetime", po::value<unsigned>(&server_options.ticket_lifetime_sec)
+                                    ->default_value(server_options.ticket_lifetime_sec),
+                               "Срок действия билета возобновления сессии, с")
+            ("watch-users", po::value<bool>(&server_options.watch_user_db)
+                                ->default_value(server_options.watch_user_db),
+                           "Перечитывать базу пользователей при изменении файла (SIGHUP - всегда)")
+            ("ip-rate", po::value<unsigned>(&server_options.ip_limits.rate)->default_value(0),
+                       "Подключений в секунду с одного IP (0 - без ограничения)")
+            ("ip-burst", po::value<unsigned>(&server_options.ip_limits.burst)
+                             ->default_value(server_options.ip_limits.burst),
+                        "Подключений подряд с одного IP без ожидания при --ip-rate")
+            ("ip-max-sessions", po::value<unsigned>(&server_options.ip_limits.max_sessions)->default_value(0),
+                               "Одновременных сессий с одного IP (0 - без ограничения)")
+            ("auth-fail-limit", po::value<unsigned>(&server_options.ip_limits.fail_limit)->default_value(0),
+                               "Неудачных входов подряд до блокировки IP; каждая неудача задерживает "
+                               "следующие подключения с IP (0 - без учёта)")
+            ("auth-block", po::value<unsigned>(&server_options.ip_limits.block_sec)
+                              ->default_value(server_options.ip_limits.block_sec),
+                          "Срок блокировки IP после --auth-fail-limit неудач, с")
+            ("log-level", po::value<std::string>(&log_level_name)->default_value("info"),
+                         "Наименьший уровень журнала: debug, info, warning или error "
+                         "(SIGUSR1 - подробнее, SIGUSR2 - короче)")
+            ("log-format", po::value<std::string>(&log_format_name)->default_value("text"),
+                          "Формат файла журнала: text или binary (читается утилитой logdecode)")
+            ("log-async", po::value<bool>(&server_options.log_options.async)
+                              ->default_value(server_options.log_options.async),
+                         "Записывать журнал в фоновом потоке")
+            ("log-queue", po::value<size_t>(&server_options.log_options.queue_capacity)
+                              ->default_value(server_options.log_options.queue_capacity),
+                         "Ёмкость очереди строк журнала при --log-async (степень двойки)")
+            ("log-flush-ms", po::value<unsigned>(&server_options.log_options.flush_interval_ms)
+                                 ->default_value(server_options.log_options.flush_interval_ms),
+                            "Интервал записи журнала при --log-async, мс")
+            ("log-overflow", po::value<std::string>(&log_overflow_name)->default_value("block"),
+                            "Поведение при заполненной очереди журнала: block, drop или count")
+            ("log-rotate-mb", po::value<unsigned>(&log_rotate_mb)->default_value(0),
+                             "Ротировать журнал по достижении размера, МБ (0 - без ротации по размеру)")
+            ("log-rotate-sec", po::value<unsigned>(&server_options.log_options.rotate_interval_sec)
+                                   ->default_value(0),
+                              "Ротировать журнал через указанный срок, с (0 - без ротации по времени)")
+            ("log-keep", po::value<unsigned>(&server_options.log_options.keep_segments)
+                             ->default_value(server_options.log_options.keep_segments),
+                        "Хранить ротированных файлов журнала (0 - все)")
+            ("log-compress", po::value<bool>(&server_options.log_options.compress_segments)
+                                 ->default_value(server_options.log_options.compress_segments),
+                            "Сжимать ротированные файлы журнала gzip в фоновом потоке")
+            ("compile-users", po::value<std::string>(&compiled_users_file),
+                             "Преобразовать текстовую базу --users в двоичную в указанный файл и выйти")
         ;
         
         po::variables_map vm;
@@ -64,6 +134,31 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
             throw std::runtime_error("Log file cannot be empty");
         }
         
+        if (server_options.listen_backlog <= 0) {
+            throw std::runtime_error("Listen backlog must be positive");
+        }
+        
+        if (server_options.ticket_lifetime_sec == 0) {
+            throw std::runtime_error("Ticket lifetime must be positive");
+        }
+        
+        size_t log_queue = server_options.log_options.queue_capacity;
+        if (log_queue < 2 || (log_queue & (log_queue - 1)) != 0) {
+            throw std::runtime_error("Log queue capacity must be a power of two");
+        }
+        
+        if (server_options.log_options.flush_interval_ms == 0) {
+            throw std::runtime_error("Log flush interval must be positive");
+        }
+        
+        server_options.mode = parse_server_mode(mode_name);
+        server_options.io_backend = parse_io_backend(io_name);
+        server_options.huge_pages = parse_huge_pages(huge_pages_name);
+        server_options.log_options.overflow = parse_log_overflow(log_overflow_name);
+        server_options.log_options.level = parse_log_level(log_level_name);
+        server_options.log_options.format = parse_log_format(log_format_name);
+        server_options.log_options.rotate_bytes = static_cast<uint64_t>(log_rotate_mb) * 1024 * 1024;
+        
         return true;
         
     } catch (const po::error& e) {
@@ -77,6 +172,13 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
 
 bool CommandLineParser::validate() const {
     try {
+        // В синхронном режиме файл ротирует поток сессии, записавший строку,
+        // под мьютексом журнала - остальные сессии ждут переименования файла
+        if (server_options.log_options.rotation_enabled() && !server_options.log_options.async) {
+            throw std::runtime_error("Ротация журнала (--log-rotate-mb, --log-rotate-sec) "
+                                     "требует --log-async true");
+        }
+        
         if (!fs::exists(user_db_file)) {
             throw std::runtime_error("Файл пользователей не найден: " + 
                                     fs::absolute(user_db_file).string());
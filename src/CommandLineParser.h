@@ -3,6 +3,7 @@
 
 #include <string>
 #include <boost/program_options.hpp>
+#include "ServerOptions.h"
 
 //! \brief Класс для разбора аргументов командной строки
 //! \details Парсит и валидирует параметры запуска сервера
@@ -14,6 +15,15 @@ private:
     int port;                       //!< Порт сервера
     std::string user_db_file;      //!< Файл базы пользователей
     std::string log_file;          //!< Файл журнала
+    ServerOptions server_options;  //!< Параметры параллельной обработки
+    std::string mode_name;         //!< Название режима обслуживания
+    std::string io_name;           //!< Название механизма ввода-вывода
+    std::string huge_pages_name;   //!< Название режима больших страниц
+    std::string log_overflow_name; //!< Название поведения журнала при заполненной очереди
+    std::string log_level_name;    //!< Название уровня журнала
+    std::string log_format_name;   //!< Название формата файла журнала
+    unsigned log_rotate_mb = 0;    //!< Размер файла журнала для ротации, МБ (0 - без ротации по размеру)
+    std::string compiled_users_file; //!< Файл для двоичной базы пользователей (пусто - запуск сервера)
     
 public:
     //! \brief Конструктор парсера командной строки
@@ -42,6 +52,14 @@ public:
     //! \brief Получить файл журнала
     //! \return Путь к файлу журнала
     std::string get_log_file() const { return log_file; }
+    
+    //! \brief Получить файл для преобразования базы пользователей
+    //! \return Путь к двоичной базе или пустая строка, если нужно запустить сервер
+    std::string get_compiled_users_file() const { return compiled_users_file; }
+    
+    //! \brief Получить параметры параллельной обработки
+    //! \return Параметры сервера
+    const ServerOptions& get_server_options() const { return server_options; }
 };
 
 #endif // COMMANDLINEPARSER_H
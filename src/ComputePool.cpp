@@ -0,0 +1,105 @@
+/*! \file ComputePool.cpp
+ *  \brief Реализация класса ComputePool
+ *  \details Содержит пул потоков для параллельных вычислений внутри вектора
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "ComputePool.h"
+#include <algorithm>
+
+ComputePool::ComputePool() : stopping(false), shared_jobs(0) {
+    unsigned cpu_count = std::thread::hardware_concurrency();
+    start(cpu_count > 1 ? cpu_count - 1 : 0);
+}
+
+ComputePool::~ComputePool() {
+    stop();
+}
+
+ComputePool& ComputePool::instance() {
+    static ComputePool pool;
+    return pool;
+}
+
+void ComputePool::start(unsigned threads) {
+    stopping = false;
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(&ComputePool::worker_loop, this);
+    }
+}
+
+void ComputePool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void ComputePool::set_threads(unsigned threads) {
+    if (threads == workers.size()) {
+        return;
+    }
+    stop();
+    start(threads);
+}
+
+void ComputePool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+        if (stopping) {
+            return;
+        }
+        Job& job = *jobs.front();
+        job.users++;
+        run_job(job, lock);
+        job.users--;
+        if (job.done == job.count && job.users == 0) {
+            job_finished.notify_all();
+        }
+    }
+}
+
+void ComputePool::run_job(Job& job, std::unique_lock<std::mutex>& lock) {
+    while (job.next < job.count) {
+        size_t index = job.next++;
+        if (job.next == job.count) {
+            // Индексы разобраны - новые потоки берут следующее задание
+            jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+        }
+        lock.unlock();
+        (*job.body)(index);
+        lock.lock();
+        job.done++;
+    }
+}
+
+void ComputePool::parallel_for(size_t count, const Body& body) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || workers.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.body = &body;
+    job.count = count;
+    shared_jobs.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobs.push_back(&job);
+    work_available.notify_all();
+    run_job(job, lock);
+    job_finished.wait(lock, [&job]() { return job.done == job.count && job.users == 0; });
+}
@@ -0,0 +1,97 @@
+#ifndef COMPUTEPOOL_H
+#define COMPUTEPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! \brief Общий пул потоков для вычислений внутри одного вектора
+//! \details Выполняет parallel_for: индексы задания разбираются потоками пула
+//! и вызывающим потоком через атомарный счётчик, вызывающий поток возвращается,
+//! когда обработаны все индексы. Несколько сессий могут выполнять задания
+//! одновременно - потоки пула берут задания из очереди по порядку поступления.
+//! В отличие от WorkerPool, потоки не блокируются на сети, поэтому их число
+//! разумно держать не больше числа ядер.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class ComputePool {
+public:
+    //! \brief Тело цикла: обработать индекс задания
+    using Body = std::function<void(size_t index)>;
+
+private:
+    //! \brief Задание parallel_for, живёт в стеке вызывающего потока
+    struct Job {
+        const Body* body;       //!< Тело цикла
+        size_t count;           //!< Количество индексов
+        size_t next = 0;        //!< Следующий свободный индекс
+        size_t done = 0;        //!< Обработано индексов
+        unsigned users = 0;     //!< Потоков пула, работающих с заданием
+    };
+
+    std::mutex mutex;                       //!< Защита очереди и счётчиков заданий
+    std::condition_variable work_available; //!< Появилось задание или остановка
+    std::condition_variable job_finished;   //!< Задание обработано
+    std::deque<Job*> jobs;                  //!< Задания с необработанными индексами
+    std::vector<std::thread> workers;       //!< Потоки пула
+    bool stopping;                          //!< Флаг остановки потоков
+    std::atomic<uint64_t> shared_jobs;      //!< Заданий, переданных потокам пула
+
+    ComputePool();
+
+    //! \brief Запустить потоки пула
+    void start(unsigned threads);
+
+    //! \brief Остановить и дождаться потоков пула
+    void stop();
+
+    //! \brief Цикл потока пула
+    void worker_loop();
+
+    //! \brief Обрабатывать индексы задания, пока они не закончатся
+    //! \param[in] job Задание
+    //! \param[in] lock Захваченный мьютекс пула (отпускается на время вызова тела)
+    void run_job(Job& job, std::unique_lock<std::mutex>& lock);
+
+public:
+    ~ComputePool();
+
+    ComputePool(const ComputePool&) = delete;
+    ComputePool& operator=(const ComputePool&) = delete;
+
+    //! \brief Получить пул процесса
+    //! \details При первом обращении запускает число ядер минус один поток:
+    //! вызывающий поток тоже обрабатывает индексы
+    //! \return Единственный экземпляр пула
+    static ComputePool& instance();
+
+    //! \brief Изменить количество потоков пула
+    //! \details Вызывается, пока нет выполняющихся заданий (при запуске сервера)
+    //! \param[in] threads Количество потоков (0 - выполнять задания в вызывающем потоке)
+    void set_threads(unsigned threads);
+
+    //! \brief Получить количество потоков пула
+    //! \return Количество потоков без учёта вызывающего
+    unsigned thread_count() const { return static_cast<unsigned>(workers.size()); }
+
+    //! \brief Получить количество заданий, переданных потокам пула
+    //! \details Задания из одного индекса и задания при пустом пуле не учитываются
+    //! \return Количество
+    uint64_t get_shared_jobs() const { return shared_jobs.load(std::memory_order_relaxed); }
+
+    //! \brief Выполнить тело для индексов 0..count-1
+    //! \details Индексы обрабатываются в произвольном порядке и разными потоками;
+    //! тело не должно выпускать исключений
+    //! \param[in] count Количество индексов
+    //! \param[in] body Тело цикла
+    void parallel_for(size_t count, const Body& body);
+};
+
+#endif // COMPUTEPOOL_H
@@ -0,0 +1,300 @@
+/*! \file CoroExecutor.cpp
+ *  \brief Реализация класса CoroExecutor
+ *  \details Содержит исполнитель сопрограммных сессий и операции async_*
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "CoroExecutor.h"
+#include "BufferPool.h"
+#include "CoroSession.h"
+#include "DataCalculator.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+namespace {
+
+//! \brief Преобразовать неуспешное ожидание в исключение
+//! \param[in] result Причина возобновления
+//! \param[in] timeout_message Сообщение при таймауте
+//! \throw std::runtime_error При таймауте или остановке исполнителя
+void check_wait(IoWaitResult result, const char* timeout_message) {
+    if (result == IoWaitResult::Timeout) {
+        throw std::runtime_error(timeout_message);
+    }
+    if (result == IoWaitResult::Cancelled) {
+        throw std::runtime_error("Server is shutting down");
+    }
+}
+
+} // namespace
+
+void CoroExecutor::IoAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    executor.suspend(fd, events, timeout_sec, handle, &result);
+}
+
+CoroExecutor::CoroExecutor(AuthManager& auth_manager, Logger& logger, int listen_fd,
+                           const SessionGate& gate, unsigned keep_alive_sec)
+    : auth_manager(auth_manager), logger(logger), listen_fd(listen_fd),
+      epoll_fd(-1), wake_fd(-1), gate(gate), keep_alive_sec(keep_alive_sec),
+      running(false), active_sessions(0),
+      last_sweep(std::chrono::steady_clock::now()) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        throw std::runtime_error("epoll_create1 failed: " + std::string(strerror(errno)));
+    }
+    
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        close(epoll_fd);
+        throw std::runtime_error("eventfd failed: " + std::string(strerror(errno)));
+    }
+    
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+    
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.fd = listen_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        close(wake_fd);
+        close(epoll_fd);
+        throw std::runtime_error("Failed to register listening socket in epoll: " +
+                                 std::string(strerror(errno)));
+    }
+}
+
+CoroExecutor::~CoroExecutor() {
+    close(wake_fd);
+    close(epoll_fd);
+}
+
+void CoroExecutor::suspend(int fd, uint32_t events, unsigned timeout_sec, std::coroutine_handle<> handle,
+                           IoWaitResult* result) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events | EPOLLONESHOT;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        throw std::runtime_error("epoll_ctl failed: " + std::string(strerror(errno)));
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+    waiters[fd] = Waiter{handle, deadline, result};
+}
+
+void CoroExecutor::resume(int fd, IoWaitResult result) {
+    auto it = waiters.find(fd);
+    if (it == waiters.end()) {
+        return;
+    }
+    Waiter waiter = it->second;
+    waiters.erase(it);
+    *waiter.result = result;
+    waiter.handle.resume();
+}
+
+void CoroExecutor::expire_waiters() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_sweep < std::chrono::milliseconds(SWEEP_INTERVAL_MS)) {
+        return;
+    }
+    last_sweep = now;
+    
+    std::vector<int> expired;
+    for (auto& entry : waiters) {
+        if (now >= entry.second.deadline) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        resume(fd, IoWaitResult::Timeout);
+    }
+}
+
+Task<bool> CoroExecutor::async_read_exact(int sock, void* buffer, size_t size) {
+    char* ptr = static_cast<char*>(buffer);
+    size_t total = 0;
+    
+    while (total < size) {
+        ssize_t n = recv(sock, ptr + total, size - total, 0);
+        if (n > 0) {
+            total += n;
+            SessionStats::add(stats.bytes_received, n);
+            continue;
+        }
+        if (n == 0) {
+            throw std::runtime_error("Connection closed by client during read");
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+        }
+        check_wait(co_await readable(sock),
+                   "Data reading timeout (possible type mismatch: client sends int32_t instead of double)");
+    }
+    co_return true;
+}
+
+Task<bool> CoroExecutor::async_send_exact(int sock, const void* buffer, size_t size) {
+    const char* ptr = static_cast<const char*>(buffer);
+    size_t total = 0;
+    
+    while (total < size) {
+        ssize_t n = send(sock, ptr + total, size - total, MSG_NOSIGNAL);
+        if (n > 0) {
+            total += n;
+            SessionStats::add(stats.bytes_sent, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw std::runtime_error("send failed: " + std::string(strerror(errno)));
+        }
+        check_wait(co_await writable(sock), "Data sending timeout (client not reading)");
+    }
+    co_return true;
+}
+
+Task<bool> CoroExecutor::async_recv_string(int sock, std::string& str, size_t max_len) {
+    PooledBuffer buffer(max_len + 1);
+    
+    for (;;) {
+        ssize_t n = recv(sock, buffer.data(), max_len, 0);
+        if (n > 0) {
+            SessionStats::add(stats.bytes_received, n);
+            buffer.data()[n] = '\0';
+            str = std::string(buffer.data());
+            co_return true;
+        }
+        if (n == 0) {
+            throw std::runtime_error("connection closed by client");
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+        }
+        check_wait(co_await readable(sock), "Receive timeout");
+    }
+}
+
+Task<bool> CoroExecutor::async_wait_data(int sock, unsigned idle_sec) {
+    for (;;) {
+        char probe;
+        ssize_t n = recv(sock, &probe, 1, MSG_PEEK);
+        if (n >= 0) {
+            co_return n > 0;
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+        }
+        if (co_await IoAwaiter(*this, sock, EPOLLIN, idle_sec) != IoWaitResult::Ready) {
+            co_return false;
+        }
+    }
+}
+
+DetachedTask CoroExecutor::serve(int sock, std::string client_ip) {
+    active_sessions++;
+    CoroSession session(*this, sock, client_ip, auth_manager, logger, stats, keep_alive_sec);
+    co_await session.run();
+    
+    close(sock);
+    gate.release(IpRateLimiter::parse_ip(client_ip));
+    active_sessions--;
+    SessionStats::add(stats.connections_closed);
+    logger.log_connection(client_ip, false);
+}
+
+void CoroExecutor::accept_clients() {
+    for (;;) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_sock = accept4(listen_fd, reinterpret_cast<struct sockaddr*>(&client_addr),
+                                  &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_sock < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && running) {
+                logger.log_error("accept failed: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+        
+        uint32_t client_address = client_addr.sin_addr.s_addr;
+        if (!gate.admit(client_sock, client_address, stats)) {
+            continue;
+        }
+        
+        char ip_str[INET_ADDRSTRLEN] = "unknown";
+        inet_ntop(AF_INET, &client_addr.sin_addr, ip_str, sizeof(ip_str));
+        logger.log_connection(ip_str, true);
+        SessionStats::add(stats.connections_accepted);
+        
+        // Сокет регистрируется без событий: интерес взводится при каждом ожидании
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLONESHOT;
+        ev.data.fd = client_sock;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_sock, &ev) < 0) {
+            logger.log_error("Failed to register client socket in epoll: " + std::string(strerror(errno)));
+            close(client_sock);
+            gate.release(client_address);
+            SessionStats::add(stats.connections_closed);
+            logger.log_connection(ip_str, false);
+            continue;
+        }
+        serve(client_sock, ip_str);
+    }
+}
+
+void CoroExecutor::run() {
+    running = true;
+    std::vector<struct epoll_event> events(MAX_EVENTS);
+    
+    while (running) {
+        int n = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, SWEEP_INTERVAL_MS);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            logger.log_error("epoll_wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+        
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd) {
+                continue;
+            }
+            if (fd == listen_fd) {
+                accept_clients();
+                continue;
+            }
+            resume(fd, IoWaitResult::Ready);
+        }
+        
+        expire_waiters();
+    }
+    
+    while (!waiters.empty()) {
+        resume(waiters.begin()->first, IoWaitResult::Cancelled);
+    }
+}
+
+void CoroExecutor::stop() {
+    running = false;
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void)written;
+}
@@ -0,0 +1,184 @@
+#ifndef COROEXECUTOR_H
+#define COROEXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <sys/epoll.h>
+
+#include "CoroTask.h"
+#include "DataCalculator.h"
+#include "SessionGate.h"
+#include "SessionStats.h"
+
+class AuthManager;
+class Logger;
+
+//! \brief Причина возобновления сопрограммы, ожидавшей сокет
+enum class IoWaitResult {
+    Ready,     //!< Сокет готов
+    Timeout,   //!< Истёк срок ожидания
+    Cancelled  //!< Исполнитель останавливается
+};
+
+//! \brief Однопоточный исполнитель сопрограммных сессий на epoll
+//! \details Принимает подключения и запускает для каждого сопрограмму CoroSession,
+//! которая выполняет протокол последовательным кодом. Операции async_* сначала
+//! пытаются выполнить recv()/send() сразу и приостанавливают сопрограмму только
+//! при EAGAIN; исполнитель возобновляет её по готовности сокета (EPOLLONESHOT)
+//! или по истечении срока ожидания. Ожидающая сессия занимает только кадры
+//! своих сопрограмм и одну запись в таблице ожиданий.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class CoroExecutor {
+public:
+    //! \brief Ожидание готовности сокета
+    class IoAwaiter {
+    private:
+        CoroExecutor& executor; //!< Исполнитель
+        int fd;                 //!< Сокет
+        uint32_t events;        //!< Ожидаемые события epoll
+        unsigned timeout_sec;   //!< Срок ожидания, с
+        IoWaitResult result;    //!< Причина возобновления
+
+    public:
+        IoAwaiter(CoroExecutor& executor, int fd, uint32_t events, unsigned timeout_sec)
+            : executor(executor), fd(fd), events(events), timeout_sec(timeout_sec), result(IoWaitResult::Ready) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        IoWaitResult await_resume() const noexcept { return result; }
+    };
+
+private:
+    static constexpr int MAX_EVENTS = 256;          //!< Событий за один вызов epoll_wait
+    static constexpr int SWEEP_INTERVAL_MS = 100;   //!< Период проверки таймаутов
+
+    //! \brief Приостановленная сопрограмма
+    struct Waiter {
+        std::coroutine_handle<> handle;                   //!< Кадр для возобновления
+        std::chrono::steady_clock::time_point deadline;   //!< Срок ожидания
+        IoWaitResult* result;                             //!< Куда записать причину возобновления
+    };
+
+    AuthManager& auth_manager;       //!< Менеджер аутентификации
+    Logger& logger;                  //!< Логгер
+    int listen_fd;                   //!< Прослушивающий сокет (неблокирующий)
+    int epoll_fd;                    //!< Дескриптор epoll
+    int wake_fd;                     //!< eventfd для пробуждения при остановке
+    SessionGate gate;                //!< Допуск подключений
+    unsigned keep_alive_sec;         //!< Простой сессии между пакетами, с (0 - один пакет)
+    SessionStats stats;              //!< Счётчики сессий исполнителя
+    std::atomic<bool> running;       //!< Флаг работы исполнителя
+    size_t active_sessions;          //!< Количество незавершённых сессий
+    std::unordered_map<int, Waiter> waiters;          //!< Ожидающие сопрограммы по сокету
+    std::chrono::steady_clock::time_point last_sweep; //!< Время последней проверки таймаутов
+
+    //! \brief Принять все ожидающие подключения
+    void accept_clients();
+
+    //! \brief Зарегистрировать ожидание сокета
+    //! \param[in] fd Сокет
+    //! \param[in] events События epoll
+    //! \param[in] timeout_sec Срок ожидания, с
+    //! \param[in] handle Сопрограмма
+    //! \param[out] result Причина возобновления
+    void suspend(int fd, uint32_t events, unsigned timeout_sec, std::coroutine_handle<> handle,
+                 IoWaitResult* result);
+
+    //! \brief Возобновить сопрограмму, ожидающую сокет
+    //! \param[in] fd Сокет
+    //! \param[in] result Причина возобновления
+    void resume(int fd, IoWaitResult result);
+
+    //! \brief Возобновить ожидания с истёкшим сроком
+    void expire_waiters();
+
+    //! \brief Обслужить сессию и закрыть сокет
+    //! \param[in] sock Неблокирующий сокет клиента
+    //! \param[in] client_ip IP адрес клиента
+    DetachedTask serve(int sock, std::string client_ip);
+
+public:
+    //! \brief Конструктор исполнителя
+    //! \param[in] auth_manager Менеджер аутентификации
+    //! \param[in] logger Логгер
+    //! \param[in] listen_fd Неблокирующий прослушивающий сокет
+    //! \param[in] gate Допуск подключений, общий для всех исполнителей (по умолчанию - без ограничений)
+    //! \param[in] keep_alive_sec Простой сессии между пакетами, с (0 - один пакет на подключение)
+    //! \throw std::runtime_error При ошибке создания epoll или eventfd
+    CoroExecutor(AuthManager& auth_manager, Logger& logger, int listen_fd,
+                 const SessionGate& gate = SessionGate(), unsigned keep_alive_sec = 0);
+
+    //! \brief Деструктор, освобождает epoll и eventfd
+    ~CoroExecutor();
+
+    CoroExecutor(const CoroExecutor&) = delete;
+    CoroExecutor& operator=(const CoroExecutor&) = delete;
+
+    //! \brief Ожидать готовности сокета к чтению
+    //! \param[in] fd Сокет
+    //! \return Объект ожидания
+    IoAwaiter readable(int fd) { return IoAwaiter(*this, fd, EPOLLIN, DataCalculator::DATA_PROCESSING_TIMEOUT_SEC); }
+
+    //! \brief Ожидать готовности сокета к записи
+    //! \param[in] fd Сокет
+    //! \return Объект ожидания
+    IoAwaiter writable(int fd) { return IoAwaiter(*this, fd, EPOLLOUT, DataCalculator::DATA_PROCESSING_TIMEOUT_SEC); }
+
+    //! \brief Прочитать точное количество байт
+    //! \param[in] sock Неблокирующий сокет
+    //! \param[out] buffer Буфер
+    //! \param[in] size Количество байт
+    //! \return true если успешно
+    //! \throw std::runtime_error При таймауте, закрытии соединения или ошибке recv
+    Task<bool> async_read_exact(int sock, void* buffer, size_t size);
+
+    //! \brief Отправить точное количество байт
+    //! \param[in] sock Неблокирующий сокет
+    //! \param[in] buffer Буфер с данными
+    //! \param[in] size Количество байт
+    //! \return true если успешно
+    //! \throw std::runtime_error При таймауте или ошибке send
+    Task<bool> async_send_exact(int sock, const void* buffer, size_t size);
+
+    //! \brief Принять строку (логин или хеш) одним recv
+    //! \param[in] sock Неблокирующий сокет
+    //! \param[out] str Принятая строка
+    //! \param[in] max_len Максимальная длина строки
+    //! \return true если успешно
+    //! \throw std::runtime_error При таймауте, закрытии соединения или ошибке recv
+    Task<bool> async_recv_string(int sock, std::string& str, size_t max_len = 1024);
+
+    //! \brief Дождаться начала следующего пакета
+    //! \param[in] sock Неблокирующий сокет
+    //! \param[in] idle_sec Наибольший простой между пакетами, с
+    //! \return true если данные есть, false если клиент закрыл соединение, простой
+    //! истёк или исполнитель останавливается
+    //! \throw std::runtime_error При ошибке recv
+    Task<bool> async_wait_data(int sock, unsigned idle_sec);
+
+    //! \brief Выполнять цикл событий до вызова stop()
+    //! \details После остановки возобновляет все ожидания с IoWaitResult::Cancelled,
+    //! чтобы сессии завершились и закрыли сокеты
+    void run();
+
+    //! \brief Запросить остановку исполнителя
+    //! \details Допускается вызов из другого потока и из обработчика сигнала
+    void stop();
+
+    //! \brief Получить количество незавершённых сессий
+    //! \return Количество сессий (только из потока исполнителя)
+    size_t session_count() const { return active_sessions; }
+
+    //! \brief Получить счётчики сессий исполнителя
+    //! \return Счётчики (допускается чтение из любого потока)
+    const SessionStats& get_stats() const { return stats; }
+};
+
+#endif // COROEXECUTOR_H
@@ -0,0 +1,163 @@
+/*! \file CoroSession.cpp
+ *  \brief Реализация класса CoroSession
+ *  \details Содержит сопрограмму клиентской сессии
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "CoroSession.h"
+#include "AuthManager.h"
+#include "BufferPool.h"
+#include "CoroExecutor.h"
+#include "DataCalculator.h"
+#include "Logger.h"
+#include "VectorStats.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <sys/socket.h>
+
+CoroSession::CoroSession(CoroExecutor& executor, int sock, const std::string& client_ip,
+                         AuthManager& auth_manager, Logger& logger, SessionStats& stats,
+                         unsigned keep_alive_sec)
+    : executor(executor), sock(sock), client_ip(client_ip), auth_manager(auth_manager),
+      logger(logger), stats(stats), keep_alive_sec(keep_alive_sec), authenticated(false) {
+}
+
+Task<void> CoroSession::run() {
+    uint64_t batches = 0;
+    try {
+        std::string login;
+        co_await executor.async_recv_string(sock, login);
+        if (login.empty()) {
+            throw std::runtime_error("Empty login received");
+        }
+        
+        LoginKind login_kind = AuthManager::parse_login_message(login);
+        if (login_kind == LoginKind::Resume) {
+            std::string ticket = login;
+            authenticated = auth_manager.resume(ticket, login, logger, client_ip);
+        } else {
+            std::string salt = auth_manager.generate_salt();
+            co_await executor.async_send_exact(sock, salt.data(), salt.size());
+            
+            std::string client_hash;
+            co_await executor.async_recv_string(sock, client_hash);
+            
+            authenticated = auth_manager.authenticate(login, client_hash, salt, logger, client_ip);
+        }
+        if (!authenticated) {
+            SessionStats::add(stats.auth_failures);
+            co_await executor.async_send_exact(sock, "ERR", 3);
+            co_return;
+        }
+        
+        std::string reply = "OK";
+        if (login_kind != LoginKind::Password) {
+            reply += auth_manager.issue_ticket(login);
+        }
+        co_await executor.async_send_exact(sock, reply.data(), reply.size());
+        LOG_BATCH(logger, LogEvent::BatchStarted, client_ip, 0);
+        do {
+            co_await process_data();
+            batches++;
+            SessionStats::add(stats.batches_processed);
+        } while (keep_alive_sec > 0 && co_await executor.async_wait_data(sock, keep_alive_sec));
+    } catch (const std::exception& e) {
+        if (authenticated) {
+            logger.log_error("Error processing data from " + client_ip + ": " + e.what());
+        } else {
+            logger.log_error("Session error [" + client_ip + "]: " + e.what());
+            send(sock, "ERR", 3, MSG_NOSIGNAL | MSG_DONTWAIT);
+        }
+    }
+    if (authenticated && keep_alive_sec > 0) {
+        LOG_BATCH(logger, LogEvent::ConnectionServed, client_ip, static_cast<uint32_t>(batches));
+    }
+}
+
+Task<void> CoroSession::process_data() {
+    uint32_t num_vectors;
+    co_await executor.async_read_exact(sock, &num_vectors, sizeof(num_vectors));
+    
+    DataRequest request;
+    uint64_t payload_length = 0;
+    BatchHeader kind;
+    while ((kind = DataCalculator::classify_batch_header(num_vectors, request)) == BatchHeader::Negotiation) {
+        if (!DataCalculator::apply_negotiation_header(num_vectors, request, logger)) {
+            co_await executor.async_send_exact(sock, "ERR", 3);
+            throw std::runtime_error("Rejected negotiation header " + std::to_string(num_vectors));
+        }
+        co_await executor.async_send_exact(sock, "OK", 2);
+        co_await executor.async_read_exact(sock, &num_vectors, sizeof(num_vectors));
+    }
+    if (kind == BatchHeader::Misplaced) {
+        co_await executor.async_send_exact(sock, "ERR", 3);
+        throw std::runtime_error("Frame header after negotiation");
+    }
+    if (kind == BatchHeader::Frame) {
+        FrameHeader frame;
+        frame.magic = num_vectors;
+        co_await executor.async_read_exact(sock, reinterpret_cast<char*>(&frame) + sizeof(frame.magic),
+                                           sizeof(frame) - sizeof(frame.magic));
+        if (!DataCalculator::parse_frame_header(frame, request, logger)) {
+            co_await executor.async_send_exact(sock, "ERR", 3);
+            throw std::runtime_error("Rejected frame header");
+        }
+        num_vectors = frame.num_vectors;
+        payload_length = frame.payload_length;
+    } else {
+        num_vectors = DataCalculator::normalize_vector_count(num_vectors, logger);
+    }
+    LOG_DEBUG(logger, "Client " + client_ip + " will send " + std::to_string(num_vectors) + " vectors");
+    
+    co_await DataCalculator::dispatch_element_type(request.element_type, [&](auto tag) {
+        return process_vectors<typename decltype(tag)::type>(num_vectors, request, payload_length);
+    });
+    
+    LOG_BATCH(logger, LogEvent::BatchProcessed, client_ip, num_vectors);
+}
+
+template<typename T>
+Task<void> CoroSession::process_vectors(uint32_t num_vectors, DataRequest request, uint64_t payload_length) {
+    PooledBuffer chunk(DataCalculator::STREAM_CHUNK_SIZE);
+    
+    for (uint32_t vector_idx = 0; vector_idx < num_vectors; vector_idx++) {
+        uint64_t vector_size;
+        if (request.framed) {
+            co_await executor.async_read_exact(sock, &vector_size, sizeof(vector_size));
+            vector_size = DataCalculator::take_frame_vector_size(vector_size, request,
+                                                                 vector_idx + 1 == num_vectors, payload_length);
+        } else {
+            uint32_t size_header;
+            co_await executor.async_read_exact(sock, &size_header, sizeof(size_header));
+            if (size_header == DataCalculator::VECTOR_SIZE_EXTENDED) {
+                co_await executor.async_read_exact(sock, &vector_size, sizeof(vector_size));
+                vector_size = DataCalculator::normalize_extended_vector_size(vector_size, logger);
+            } else {
+                vector_size = DataCalculator::normalize_vector_size(size_header, logger);
+            }
+        }
+        LOG_DEBUG(logger, "Vector " + std::to_string(vector_idx) + " has " +
+                          std::to_string(vector_size) + " elements");
+        
+        StatsAccumulator<T> accumulator(request.stats_mask, vector_size);
+        uint64_t remaining = vector_size * sizeof(T);
+        while (remaining > 0) {
+            size_t chunk_bytes = static_cast<size_t>(std::min<uint64_t>(remaining, chunk.size()));
+            co_await executor.async_read_exact(sock, chunk.data(), chunk_bytes);
+            if (request.swap_bytes) {
+                DataCalculator::swap_byte_order(chunk.data(), chunk_bytes / sizeof(T), sizeof(T));
+            }
+            accumulator.add(chunk.as<T>(), chunk_bytes / sizeof(T));
+            remaining -= chunk_bytes;
+        }
+        char results[StatsAccumulator<T>::MAX_RESULT_SIZE];
+        size_t results_size = accumulator.write_results(results, request.swap_bytes);
+        
+        co_await executor.async_send_exact(sock, results, results_size);
+        SessionStats::add(stats.vectors_processed);
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef COROSESSION_H
+#define COROSESSION_H
+
+#include <cstdint>
+#include <string>
+
+#include "CoroTask.h"
+#include "DataCalculator.h"
+#include "SessionStats.h"
+
+class AuthManager;
+class CoroExecutor;
+class Logger;
+
+//! \brief Клиентская сессия в виде сопрограммы
+//! \details Выполняет протокол Server::handle_client и DataCalculator::process_client_data
+//! тем же последовательным кодом, но каждая операция ввода-вывода - co_await на
+//! неблокирующем сокете. Пока клиент молчит, сессия приостановлена в CoroExecutor
+//! и не занимает поток.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class CoroSession {
+private:
+    CoroExecutor& executor;            //!< Исполнитель сессии
+    int sock;                          //!< Неблокирующий сокет клиента
+    std::string client_ip;             //!< IP адрес клиента
+    AuthManager& auth_manager;         //!< Менеджер аутентификации
+    Logger& logger;                    //!< Логгер
+    SessionStats& stats;               //!< Счётчики исполнителя
+    unsigned keep_alive_sec;           //!< Простой между пакетами, с (0 - один пакет)
+    bool authenticated;                //!< Результат аутентификации
+
+    //! \brief Обработать пакет: принять кадр версии 2 или согласовать тип элементов
+    //! и маску операций, принять векторы и отправить статистики
+    //! \throw std::runtime_error При ошибке протокола или ввода-вывода
+    Task<void> process_data();
+
+    //! \brief Принять векторы и отправить запрошенные статистики
+    //! \tparam T Тип элементов
+    //! \param[in] num_vectors Количество векторов
+    //! \param[in] request Параметры обработки
+    //! \param[in] payload_length Длина нагрузки кадра версии 2 (без кадра не используется)
+    //! \throw std::runtime_error При ошибке протокола или ввода-вывода
+    template<typename T>
+    Task<void> process_vectors(uint32_t num_vectors, DataRequest request, uint64_t payload_length);
+
+public:
+    //! \brief Конструктор сессии
+    //! \param[in] executor Исполнитель сессии
+    //! \param[in] sock Неблокирующий сокет клиента
+    //! \param[in] client_ip IP адрес клиента
+    //! \param[in] auth_manager Менеджер аутентификации
+    //! \param[in] logger Логгер
+    //! \param[in] stats Счётчики исполнителя
+    //! \param[in] keep_alive_sec Простой между пакетами, с (0 - один пакет на подключение)
+    CoroSession(CoroExecutor& executor, int sock, const std::string& client_ip,
+                AuthManager& auth_manager, Logger& logger, SessionStats& stats,
+                unsigned keep_alive_sec = 0);
+
+    //! \brief Выполнить сессию от логина до последнего результата
+    //! \details При keep_alive_sec > 0 после пакета ждёт следующий, пока клиент не закроет
+    //! соединение или не промолчит keep_alive_sec секунд.
+    //! Ошибки журналируются; до аутентификации клиенту отправляется "ERR".
+    //! Сокет не закрывается
+    Task<void> run();
+
+    //! \brief Проверить результат аутентификации
+    //! \return true если клиент аутентифицирован
+    bool is_authenticated() const { return authenticated; }
+};
+
+#endif // COROSESSION_H
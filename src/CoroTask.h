@@ -0,0 +1,124 @@
+#ifndef COROTASK_H
+#define COROTASK_H
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+template<typename T = void>
+class Task;
+
+namespace coro_detail {
+
+//! \brief Общая часть обещания задачи: продолжение и исключение
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine(); //!< Ожидающая сопрограмма
+    std::exception_ptr error;                                     //!< Исключение тела сопрограммы
+
+    //! \brief Ожидание завершения: передаёт управление ожидающей сопрограмме
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+            return handle.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+//! \brief Обещание задачи, возвращающей значение
+template<typename T>
+struct Promise : PromiseBase {
+    T value{}; //!< Результат сопрограммы
+
+    Task<T> get_return_object();
+    void return_value(T result) { value = std::move(result); }
+};
+
+//! \brief Обещание задачи без значения
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+};
+
+} // namespace coro_detail
+
+//! \brief Ленивая сопрограмма-задача
+//! \details Тело начинает выполняться при co_await и по завершении симметрично
+//! возвращает управление ожидающей сопрограмме, поэтому цепочка вложенных задач
+//! не растит стек. Исключение тела пробрасывается из co_await.
+//! \tparam T Тип результата
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+template<typename T>
+class Task {
+public:
+    using promise_type = coro_detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit Task(handle_type handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    //! \brief Деструктор, освобождает кадр сопрограммы
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+
+    T await_resume() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(handle.promise().value);
+        }
+    }
+
+private:
+    handle_type handle; //!< Кадр сопрограммы
+};
+
+namespace coro_detail {
+
+template<typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace coro_detail
+
+//! \brief Отсоединённая сопрограмма верхнего уровня
+//! \details Запускается сразу и освобождает свой кадр по завершении.
+//! Тело не должно выпускать исключений.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+#endif // COROTASK_H
@@ -8,9 +8,15 @@
 
 #include "DataCalculator.h"
 #include "Logger.h"
+#include "IoUring.h"
+#include "BufferPool.h"
+#include "SimdKernels.h"
+#include "ComputePool.h"
+#include "VectorStats.h"
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <bit>
 #include <limits>
 #include <vector>
 #include <stdexcept>
@@ -20,7 +26,245 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 
+namespace {
+
+//! \brief Буфер приёма сессии
+//! \details Накапливает всё, что пришло от клиента, и выдаёт данные по частям
+class InputBuffer {
+private:
+    int sock;                //!< Сокет клиента
+    PooledBuffer data;       //!< Принятые данные
+    size_t begin;            //!< Начало неразобранных данных
+    size_t end;              //!< Конец принятых данных
+
+public:
+    InputBuffer(int sock, size_t capacity) : sock(sock), data(capacity), begin(0), end(0) {}
+
+    //! \brief Количество принятых, но не разобранных байт
+    size_t available() const { return end - begin; }
+
+    //! \brief Начало неразобранных данных
+    char* peek() { return data.data() + begin; }
+
+    //! \brief Отметить байты разобранными
+    void consume(size_t size) { begin += size; }
+
+    //! \brief Дождаться, пока в буфере окажется не меньше size байт
+    void ensure(size_t size) {
+        if (available() >= size) {
+            return;
+        }
+        memmove(data.data(), data.data() + begin, available());
+        end -= begin;
+        begin = 0;
+        while (end < size) {
+            end += DataCalculator::read_some(sock, data.data() + end, data.size() - end);
+        }
+    }
+
+    //! \brief Дождаться начала следующего пакета
+    //! \param[in] idle_sec Наибольший простой между пакетами, с
+    //! \return true если данные есть, false если клиент закрыл соединение или простой истёк
+    //! \throw std::runtime_error При ошибке select или recv
+    bool wait_for_data(unsigned idle_sec) {
+        if (available() > 0) {
+            return true;
+        }
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(sock, &read_fds);
+        struct timeval timeout;
+        timeout.tv_sec = idle_sec;
+        timeout.tv_usec = 0;
+        int ready = select(sock + 1, &read_fds, nullptr, nullptr, &timeout);
+        if (ready < 0 && errno != EINTR) {
+            throw std::runtime_error("select failed: " + std::string(strerror(errno)));
+        }
+        if (ready <= 0) {
+            return false;
+        }
+        char probe;
+        ssize_t n = recv(sock, &probe, 1, MSG_PEEK);
+        if (n < 0) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+        }
+        return n > 0;
+    }
+
+    //! \brief Извлечь ровно size байт (не больше размера буфера)
+    void take(void* dst, size_t size) {
+        ensure(size);
+        memcpy(dst, peek(), size);
+        consume(size);
+    }
+};
+
+//! \brief Принять векторы пакета и отправить запрошенные статистики
+//! \tparam T Тип элементов
+//! \param[in] input Буфер приёма сессии
+//! \param[in] client_sock Сокет клиента
+//! \param[in] num_vectors Количество векторов
+//! \param[in] request Параметры обработки
+//! \param[in] payload_length Длина нагрузки кадра версии 2 (без кадра не используется)
+//! \param[in] logger Логгер
+//! \param[in] stats Счётчики сессий (nullptr - не учитывать)
+template<typename T>
+void process_vectors(InputBuffer& input, int client_sock, uint32_t num_vectors, const DataRequest& request,
+                     uint64_t payload_length, Logger& logger, SessionStats* stats) {
+    std::string results;
+    char vector_results[StatsAccumulator<T>::MAX_RESULT_SIZE];
+    if (request.framed) {
+        // Количество векторов проверено заранее, результаты всего кадра помещаются без перераспределений
+        results.reserve(num_vectors * StatsAccumulator<T>::result_size(request.stats_mask));
+    }
+    
+    // Готовые результаты уходят одним send, прежде чем ждать новых данных клиента
+    auto flush_results = [&]() {
+        if (results.empty()) {
+            return;
+        }
+        if (!DataCalculator::send_exact(client_sock, results.data(), results.size())) {
+            throw std::runtime_error("Failed to send results");
+        }
+        if (stats) {
+            SessionStats::add(stats->bytes_sent, results.size());
+        }
+        results.clear();
+    };
+    
+    for (uint32_t vector_idx = 0; vector_idx < num_vectors; vector_idx++) {
+        size_t header_bytes = request.framed ? sizeof(uint64_t) : sizeof(uint32_t);
+        if (input.available() < header_bytes) {
+            flush_results();
+        }
+        uint64_t vector_size;
+        if (request.framed) {
+            input.take(&vector_size, sizeof(vector_size));
+            vector_size = DataCalculator::take_frame_vector_size(vector_size, request,
+                                                                 vector_idx + 1 == num_vectors, payload_length);
+        } else {
+            uint32_t size_header;
+            input.take(&size_header, sizeof(size_header));
+            if (size_header == DataCalculator::VECTOR_SIZE_EXTENDED) {
+                if (input.available() < sizeof(uint64_t)) {
+                    flush_results();
+                }
+                input.take(&vector_size, sizeof(vector_size));
+                header_bytes += sizeof(vector_size);
+                vector_size = DataCalculator::normalize_extended_vector_size(vector_size, logger);
+            } else {
+                vector_size = DataCalculator::normalize_vector_size(size_header, logger);
+            }
+        }
+        
+        // Элементы сворачиваются в статистики по мере поступления, вектор целиком не хранится
+        StatsAccumulator<T> accumulator(request.stats_mask, vector_size);
+        uint64_t remaining = vector_size * sizeof(T);
+        while (remaining > 0) {
+            if (input.available() < sizeof(T)) {
+                flush_results();
+                input.ensure(sizeof(T));
+            }
+            size_t chunk = static_cast<size_t>(
+                std::min<uint64_t>(remaining, input.available() / sizeof(T) * sizeof(T)));
+            if (request.swap_bytes) {
+                DataCalculator::swap_byte_order(input.peek(), chunk / sizeof(T), sizeof(T));
+            }
+            accumulator.add_unaligned(input.peek(), chunk / sizeof(T));
+            input.consume(chunk);
+            remaining -= chunk;
+        }
+        results.append(vector_results, accumulator.write_results(vector_results, request.swap_bytes));
+        
+        if (stats) {
+            SessionStats::add(stats->vectors_processed);
+            SessionStats::add(stats->bytes_received, header_bytes + vector_size * sizeof(T));
+        }
+    }
+    flush_results();
+}
+
+//! \brief Принять пакет векторов и отправить результаты
+//! \details Пакет начинается с кадра версии 2 или с заголовков согласования и количества
+//! векторов; согласование действует только на этот пакет
+//! \param[in] input Буфер приёма сессии
+//! \param[in] client_sock Сокет клиента
+//! \param[in] logger Логгер
+//! \param[in] client_ip IP адрес клиента
+//! \param[in] stats Счётчики сессий (nullptr - не учитывать)
+//! \return Количество векторов пакета
+//! \throw std::runtime_error При ошибке протокола или ввода-вывода
+uint32_t process_batch(InputBuffer& input, int client_sock, Logger& logger, const std::string& client_ip,
+                       SessionStats* stats) {
+    uint32_t num_vectors;
+    input.take(&num_vectors, sizeof(num_vectors));
+    
+    DataRequest request;
+    uint64_t payload_length = 0;
+    BatchHeader kind;
+    while ((kind = DataCalculator::classify_batch_header(num_vectors, request)) == BatchHeader::Negotiation) {
+        if (!DataCalculator::apply_negotiation_header(num_vectors, request, logger)) {
+            DataCalculator::send_exact(client_sock, "ERR", 3);
+            throw std::runtime_error("Rejected negotiation header " + std::to_string(num_vectors));
+        }
+        DataCalculator::send_exact(client_sock, "OK", 2);
+        if (stats) {
+            SessionStats::add(stats->bytes_sent, 2);
+        }
+        input.take(&num_vectors, sizeof(num_vectors));
+    }
+    if (kind == BatchHeader::Misplaced) {
+        DataCalculator::send_exact(client_sock, "ERR", 3);
+        throw std::runtime_error("Frame header after negotiation");
+    }
+    if (kind == BatchHeader::Frame) {
+        // Кадр версии 2 проверяется один раз, размеры векторов далее без эвристик
+        FrameHeader frame;
+        frame.magic = num_vectors;
+        input.take(reinterpret_cast<char*>(&frame) + sizeof(frame.magic), sizeof(frame) - sizeof(frame.magic));
+        if (stats) {
+            SessionStats::add(stats->bytes_received, sizeof(frame));
+        }
+        if (!DataCalculator::parse_frame_header(frame, request, logger)) {
+            DataCalculator::send_exact(client_sock, "ERR", 3);
+            throw std::runtime_error("Rejected frame header");
+        }
+        num_vectors = frame.num_vectors;
+        payload_length = frame.payload_length;
+    } else {
+        num_vectors = DataCalculator::normalize_vector_count(num_vectors, logger);
+    }
+    
+    LOG_DEBUG(logger, "Client " + client_ip + " will send " + std::to_string(num_vectors) + " vectors");
+    
+    DataCalculator::dispatch_element_type(request.element_type, [&](auto tag) {
+        process_vectors<typename decltype(tag)::type>(input, client_sock, num_vectors, request,
+                                                      payload_length, logger, stats);
+    });
+    
+    return num_vectors;
+}
+
+}
+
+IoBackend DataCalculator::io_backend = IoBackend::Select;
+thread_local uint64_t DataCalculator::io_syscalls = 0;
+
+IoBackend DataCalculator::set_io_backend(IoBackend backend) {
+    if (backend == IoBackend::Uring && !IoUring::is_supported()) {
+        backend = IoBackend::Select;
+    }
+    io_backend = backend;
+    return io_backend;
+}
+
 bool DataCalculator::read_exact(int sock, void* buffer, size_t size) {
+    if (io_backend == IoBackend::Uring) {
+        if (IoUring* ring = IoUring::for_current_thread()) {
+            return ring->read_exact(sock, buffer, size, DATA_PROCESSING_TIMEOUT_SEC);
+        }
+    }
+    
     try {
         struct timeval timeout;
         timeout.tv_sec = DATA_PROCESSING_TIMEOUT_SEC;
@@ -35,6 +279,7 @@ bool DataCalculator::read_exact(int sock, void* buffer, size_t size) {
             FD_SET(sock, &read_fds);
             
             int select_result = select(sock + 1, &read_fds, nullptr, nullptr, &timeout);
+            io_syscalls++;
             
             if (select_result == -1) {
                 throw std::runtime_error("select() failed: " + std::string(strerror(errno)));
@@ -43,6 +288,7 @@ bool DataCalculator::read_exact(int sock, void* buffer, size_t size) {
             }
             
             ssize_t n = recv(sock, ptr + total, size - total, 0);
+            io_syscalls++;
             if (n <= 0) {
                 if (n == 0) {
                     throw std::runtime_error("Connection closed by client during read");
@@ -61,7 +307,53 @@ bool DataCalculator::read_exact(int sock, void* buffer, size_t size) {
     }
 }
 
+size_t DataCalculator::read_some(int sock, void* buffer, size_t size) {
+    if (io_backend == IoBackend::Uring) {
+        if (IoUring* ring = IoUring::for_current_thread()) {
+            return ring->read_some(sock, buffer, size, DATA_PROCESSING_TIMEOUT_SEC);
+        }
+    }
+    
+    bool waited = false;
+    for (;;) {
+        ssize_t n = recv(sock, buffer, size, waited ? 0 : MSG_DONTWAIT);
+        io_syscalls++;
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        if (n == 0) {
+            throw std::runtime_error("Connection closed by client during read");
+        }
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+        }
+        
+        struct timeval timeout;
+        timeout.tv_sec = DATA_PROCESSING_TIMEOUT_SEC;
+        timeout.tv_usec = 0;
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(sock, &read_fds);
+        
+        int select_result = select(sock + 1, &read_fds, nullptr, nullptr, &timeout);
+        io_syscalls++;
+        if (select_result == -1) {
+            throw std::runtime_error("select() failed: " + std::string(strerror(errno)));
+        } else if (select_result == 0) {
+            throw std::runtime_error("Data reading timeout (possible type mismatch: client sends int32_t instead of double)");
+        }
+        waited = true;
+    }
+}
+
 bool DataCalculator::send_exact(int sock, const void* buffer, size_t size) {
+    if (io_backend == IoBackend::Uring) {
+        if (IoUring* ring = IoUring::for_current_thread()) {
+            return ring->send_exact(sock, buffer, size, DATA_PROCESSING_TIMEOUT_SEC);
+        }
+    }
+    
     try {
         struct timeval timeout;
         timeout.tv_sec = DATA_PROCESSING_TIMEOUT_SEC;
@@ -76,6 +368,7 @@ bool DataCalculator::send_exact(int sock, const void* buffer, size_t size) {
             FD_SET(sock, &write_fds);
             
             int select_result = select(sock + 1, nullptr, &write_fds, nullptr, &timeout);
+            io_syscalls++;
             
             if (select_result == -1) {
                 throw std::runtime_error("select() failed for send: " + std::string(strerror(errno)));
@@ -84,6 +377,7 @@ bool DataCalculator::send_exact(int sock, const void* buffer, size_t size) {
             }
             
             ssize_t n = send(sock, ptr + total, size - total, 0);
+            io_syscalls++;
             if (n <= 0) {
                 if (n == 0) {
                     throw std::runtime_error("Connection closed by client during send");
@@ -102,27 +396,243 @@ bool DataCalculator::send_exact(int sock, const void* buffer, size_t size) {
     }
 }
 
+bool DataCalculator::send_then_read(int sock, const void* out, size_t out_size, void* in, size_t in_size) {
+    if (io_backend == IoBackend::Uring) {
+        if (IoUring* ring = IoUring::for_current_thread()) {
+            return ring->send_then_read(sock, out, out_size, in, in_size, DATA_PROCESSING_TIMEOUT_SEC);
+        }
+    }
+    return send_exact(sock, out, out_size) && read_exact(sock, in, in_size);
+}
+
 double DataCalculator::calculate_sum_of_squares(const std::vector<double>& vec) {
-    try {
-        double sum = 0.0;
-        for (double val : vec) {
-            if (val != 0.0 && std::abs(val) > std::numeric_limits<double>::max() / std::abs(val)) {
-                throw std::overflow_error("Potential overflow in value squaring");
+    return calculate_sum_of_squares(vec.data(), vec.size());
+}
+
+template<typename T>
+SquareSumAccumulator<T>::SquareSumAccumulator(uint64_t expected_count) {
+    if constexpr (!std::is_integral_v<T>) {
+        if (expected_count >= DataCalculator::PARALLEL_REDUCTION_THRESHOLD) {
+            staging.reserve(DataCalculator::PARALLEL_REDUCTION_THRESHOLD * sizeof(T));
+            pending = expected_count;
+        }
+    }
+}
+
+template<typename T>
+void SquareSumAccumulator<T>::add_blocks(const T* data, size_t count) {
+    if constexpr (!std::is_integral_v<T>) {
+        const size_t block_size = DataCalculator::PARALLEL_BLOCK_SIZE;
+        std::vector<double> partials((count + block_size - 1) / block_size);
+        ComputePool::instance().parallel_for(partials.size(), [&](size_t block) {
+            size_t begin = block * block_size;
+            partials[block] = SimdKernels::sum_of_squares(data + begin, std::min(block_size, count - begin));
+        });
+        // Блоки складываются по порядку: результат не зависит ни от числа потоков,
+        // ни от того, какими порциями вектор пришёл из сети
+        for (double block_sum : partials) {
+            sum += block_sum;
+        }
+        // Квадраты неотрицательны: переполнение и inf/nan на входе видны по сумме
+        if (!std::isfinite(sum)) {
+            throw std::overflow_error("Potential overflow in sum accumulation");
+        }
+    }
+}
+
+template<typename T>
+void SquareSumAccumulator<T>::add(const T* data, size_t count) {
+    if constexpr (std::is_integral_v<T>) {
+        // Пока сумма не больше максимума T, прибавление квадрата не переполняет
+        // Accumulator; после насыщения остальные элементы не влияют на результат
+        const Accumulator limit = static_cast<Accumulator>(std::numeric_limits<T>::max());
+        for (size_t i = 0; i < count && sum <= limit; i++) {
+            T val;
+            memcpy(&val, data + i, sizeof(val));
+            Accumulator wide = static_cast<Accumulator>(val);
+            sum += wide * wide;
+        }
+    } else if (staging.data() && pending > 0) {
+        // Порции длинного вектора собираются в блок порога и суммируются параллельно
+        const size_t capacity = DataCalculator::PARALLEL_REDUCTION_THRESHOLD;
+        while (count > 0) {
+            size_t take = static_cast<size_t>(std::min<uint64_t>({count, capacity - staged, pending}));
+            if (take == 0) {
+                // Элементы сверх заявленной длины
+                add_blocks(data, count);
+                return;
             }
-            double square = val * val;
-            
-            if (sum != 0.0 && std::abs(square) > std::numeric_limits<double>::max() - std::abs(sum)) {
-                throw std::overflow_error("Potential overflow in sum accumulation");
+            memcpy(staging.as<T>() + staged, data, take * sizeof(T));
+            staged += take;
+            pending -= take;
+            data += take;
+            count -= take;
+            if (staged == capacity || pending == 0) {
+                add_blocks(staging.as<T>(), staged);
+                staged = 0;
             }
-            
-            sum += square;
         }
-        return handle_overflow(sum);
-    } catch (const std::exception& e) {
-        throw;
+    } else if (count >= DataCalculator::PARALLEL_REDUCTION_THRESHOLD) {
+        add_blocks(data, count);
+    } else {
+        // Квадраты неотрицательны, поэтому переполнение (и inf/nan на входе)
+        // видно по нефинитной сумме порции - поэлементные проверки не нужны
+        double partial = SimdKernels::sum_of_squares(data, count);
+        if (!std::isfinite(partial) || !std::isfinite(sum + partial)) {
+            throw std::overflow_error("Potential overflow in sum accumulation");
+        }
+        sum += partial;
+    }
+}
+
+template<typename T>
+void SquareSumAccumulator<T>::add_unaligned(const char* bytes, size_t count) {
+    // Ядра и целочисленный цикл читают без требований к выравниванию
+    add(reinterpret_cast<const T*>(bytes), count);
+}
+
+template<typename T>
+T SquareSumAccumulator<T>::result() const {
+    if constexpr (std::is_same_v<T, double>) {
+        return DataCalculator::handle_overflow(sum);
+    } else {
+        // Сумма, не помещающаяся в T, ограничивается его максимумом
+        const T max_value = std::numeric_limits<T>::max();
+        if (sum > static_cast<Accumulator>(max_value)) {
+            return max_value;
+        }
+        return static_cast<T>(sum);
+    }
+}
+
+template class SquareSumAccumulator<int32_t>;
+template class SquareSumAccumulator<int64_t>;
+template class SquareSumAccumulator<float>;
+template class SquareSumAccumulator<double>;
+
+bool DataCalculator::parse_element_type(uint32_t header, ElementType& type) {
+    ElementType code = static_cast<ElementType>(header >> 24);
+    switch (code) {
+        case ElementType::Int32:
+        case ElementType::Int64:
+        case ElementType::Float:
+        case ElementType::Double:
+            type = code;
+            return true;
+    }
+    return false;
+}
+
+bool DataCalculator::apply_negotiation_header(uint32_t header, DataRequest& request, Logger& logger) {
+    if (is_element_type_header(header)) {
+        if (!parse_element_type(header, request.element_type)) {
+            LOG_DEBUG(logger, "Unsupported element type code " + std::to_string(header >> 24));
+            return false;
+        }
+        LOG_DEBUG(logger, std::string("Negotiated element type ") + element_type_name(request.element_type));
+        request.negotiated = true;
+        return true;
+    }
+    uint8_t stats_mask = static_cast<uint8_t>(header >> 24);
+    if (stats_mask == 0) {
+        LOG_DEBUG(logger, "Empty operation mask");
+        return false;
+    }
+    request.stats_mask = stats_mask;
+    request.negotiated = true;
+    LOG_DEBUG(logger, "Negotiated operation mask " + std::to_string(stats_mask));
+    return true;
+}
+
+bool DataCalculator::parse_frame_header(FrameHeader& frame, DataRequest& request, Logger& logger) {
+    if (frame.version != FRAME_VERSION) {
+        LOG_DEBUG(logger, "Unsupported frame version " + std::to_string(frame.version));
+        return false;
+    }
+    if (frame.flags & ~FRAME_BIG_ENDIAN) {
+        LOG_DEBUG(logger, "Unknown frame flags " + std::to_string(frame.flags));
+        return false;
+    }
+    bool big_endian = (frame.flags & FRAME_BIG_ENDIAN) != 0;
+    request.swap_bytes = big_endian != (std::endian::native == std::endian::big);
+    if (request.swap_bytes) {
+        frame.num_vectors = __builtin_bswap32(frame.num_vectors);
+        frame.payload_length = __builtin_bswap64(frame.payload_length);
+    }
+    
+    ElementType type;
+    if (!parse_element_type(static_cast<uint32_t>(frame.element_type) << 24, type)) {
+        LOG_DEBUG(logger, "Unsupported element type code " + std::to_string(frame.element_type));
+        return false;
+    }
+    if (frame.stats_mask == 0) {
+        LOG_DEBUG(logger, "Empty operation mask");
+        return false;
+    }
+    if (frame.num_vectors == 0 || frame.num_vectors > MAX_REASONABLE_VECTORS) {
+        LOG_DEBUG(logger, "Unreasonable frame vector count " + std::to_string(frame.num_vectors));
+        return false;
+    }
+    // Каждый вектор занимает хотя бы свой размер и не больше MAX_STREAMING_VECTOR_SIZE элементов
+    const uint64_t min_length = uint64_t(frame.num_vectors) * sizeof(uint64_t);
+    const uint64_t max_length = uint64_t(frame.num_vectors) *
+                                (sizeof(uint64_t) + MAX_STREAMING_VECTOR_SIZE * element_size(type));
+    if (frame.payload_length < min_length || frame.payload_length > max_length) {
+        LOG_DEBUG(logger, "Frame payload length " + std::to_string(frame.payload_length) +
+                          " does not fit " + std::to_string(frame.num_vectors) + " vectors");
+        return false;
+    }
+    
+    request.element_type = type;
+    request.stats_mask = frame.stats_mask;
+    request.framed = true;
+    LOG_DEBUG(logger, "Frame v2: " + std::to_string(frame.num_vectors) + " vectors of " +
+                      element_type_name(type) + (big_endian ? ", big-endian" : ", little-endian"));
+    return true;
+}
+
+uint64_t DataCalculator::take_frame_vector_size(uint64_t raw_size, const DataRequest& request, bool last,
+                                                uint64_t& payload_remaining) {
+    uint64_t vector_size = request.swap_bytes ? __builtin_bswap64(raw_size) : raw_size;
+    const size_t width = element_size(request.element_type);
+    if (payload_remaining < sizeof(uint64_t) || vector_size > (payload_remaining - sizeof(uint64_t)) / width) {
+        throw std::runtime_error("Vector size " + std::to_string(vector_size) + " exceeds frame payload");
+    }
+    payload_remaining -= sizeof(uint64_t) + vector_size * width;
+    if (last && payload_remaining != 0) {
+        throw std::runtime_error("Frame payload length mismatch: " + std::to_string(payload_remaining) +
+                                 " bytes left after the last vector");
+    }
+    return vector_size;
+}
+
+void DataCalculator::swap_byte_order(void* data, size_t count, size_t width) {
+    char* bytes = static_cast<char*>(data);
+    if (width == sizeof(uint32_t)) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t value;
+            memcpy(&value, bytes + i * sizeof(value), sizeof(value));
+            value = __builtin_bswap32(value);
+            memcpy(bytes + i * sizeof(value), &value, sizeof(value));
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t value;
+            memcpy(&value, bytes + i * sizeof(value), sizeof(value));
+            value = __builtin_bswap64(value);
+            memcpy(bytes + i * sizeof(value), &value, sizeof(value));
+        }
     }
 }
 
+size_t DataCalculator::element_size(ElementType type) {
+    return dispatch_element_type(type, [](auto tag) { return sizeof(typename decltype(tag)::type); });
+}
+
+const char* DataCalculator::element_type_name(ElementType type) {
+    return dispatch_element_type(type, [](auto tag) { return ElementTraits<typename decltype(tag)::type>::name; });
+}
+
 double DataCalculator::handle_overflow(double value) {
     const double max_value = std::numeric_limits<double>::max();
     const double min_value = -std::numeric_limits<double>::max();
@@ -136,93 +646,80 @@ double DataCalculator::handle_overflow(double value) {
     return value;
 }
 
-
-bool DataCalculator::process_client_data(int client_sock, Logger& logger, const std::string& client_ip) {
-    try {
-        logger.log_data(client_ip, "Processing client data");
+uint32_t DataCalculator::normalize_vector_count(uint32_t num_vectors, Logger& logger) {
+    LOG_DEBUG(logger, "Raw num_vectors: " + std::to_string(num_vectors));
+    
+    if (num_vectors > MAX_REASONABLE_VECTORS) {
+        uint32_t swapped = ntohl(num_vectors);
+        LOG_DEBUG(logger, "Large vector count detected (" + std::to_string(num_vectors) + 
+                         "), swapped would be: " + std::to_string(swapped));
         
-        uint32_t num_vectors;
-        if (!read_exact(client_sock, &num_vectors, sizeof(num_vectors))) {
-            throw std::runtime_error("Failed to read number of vectors");
+        if (swapped <= MAX_REASONABLE_VECTORS && swapped > 0) {
+            num_vectors = swapped;
+            LOG_DEBUG(logger, "Using swapped value: " + std::to_string(num_vectors));
+        } else {
+            throw std::runtime_error("Unreasonable vector count: " + std::to_string(num_vectors));
         }
-        
-        logger.log_debug("Raw num_vectors: " + std::to_string(num_vectors));
-        
-        if (num_vectors > MAX_REASONABLE_VECTORS) {
-            uint32_t swapped = ntohl(num_vectors);
-            logger.log_debug("Large vector count detected (" + std::to_string(num_vectors) + 
-                            "), swapped would be: " + std::to_string(swapped));
-            
-            if (swapped <= MAX_REASONABLE_VECTORS && swapped > 0) {
-                num_vectors = swapped;
-                logger.log_debug("Using swapped value: " + std::to_string(num_vectors));
-            } else {
-                throw std::runtime_error("Unreasonable vector count: " + std::to_string(num_vectors));
-            }
+    }
+    
+    if (num_vectors == 0) {
+        throw std::runtime_error("Zero vectors requested");
+    }
+    return num_vectors;
+}
+
+uint32_t DataCalculator::normalize_vector_size(uint32_t vector_size, Logger& logger) {
+    if (vector_size > MAX_REASONABLE_VECTOR_SIZE) {
+        uint32_t swapped_size = ntohl(vector_size);
+        if (swapped_size <= MAX_REASONABLE_VECTOR_SIZE) {
+            vector_size = swapped_size;
+            LOG_DEBUG(logger, "Corrected vector size to " + std::to_string(vector_size));
+        } else {
+            throw std::runtime_error("Unreasonable vector size: " + std::to_string(vector_size));
         }
-        
-        if (num_vectors == 0) {
-            throw std::runtime_error("Zero vectors requested");
+    }
+    return vector_size;
+}
+
+uint64_t DataCalculator::normalize_extended_vector_size(uint64_t vector_size, Logger& logger) {
+    if (vector_size > MAX_STREAMING_VECTOR_SIZE) {
+        uint64_t swapped_size = __builtin_bswap64(vector_size);
+        if (swapped_size <= MAX_STREAMING_VECTOR_SIZE) {
+            vector_size = swapped_size;
+            LOG_DEBUG(logger, "Corrected extended vector size to " + std::to_string(vector_size));
+        } else {
+            throw std::runtime_error("Unreasonable vector size: " + std::to_string(vector_size));
+        }
+    }
+    return vector_size;
+}
+
+bool DataCalculator::process_client_data(int client_sock, Logger& logger, const std::string& client_ip,
+                                         SessionStats* stats, unsigned keep_alive_sec) {
+    uint64_t batches = 0;
+    auto log_batches = [&]() {
+        if (keep_alive_sec > 0) {
+            LOG_BATCH(logger, LogEvent::ConnectionServed, client_ip, static_cast<uint32_t>(batches));
         }
+    };
+    
+    try {
+        LOG_BATCH(logger, LogEvent::BatchStarted, client_ip, 0);
         
-        logger.log_debug("Client " + client_ip + " will send " + std::to_string(num_vectors) + " vectors");
+        InputBuffer input(client_sock, BATCH_BUFFER_SIZE);
         
-        for (uint32_t vector_idx = 0; vector_idx < num_vectors; vector_idx++) {
-            logger.log_debug("Processing vector " + std::to_string(vector_idx + 1) + 
-                           "/" + std::to_string(num_vectors));
-            
-            uint32_t vector_size;
-            if (!read_exact(client_sock, &vector_size, sizeof(vector_size))) {
-                throw std::runtime_error("Failed to read size for vector " + std::to_string(vector_idx));
-            }
-            
-            if (vector_size > MAX_REASONABLE_VECTOR_SIZE) {
-                uint32_t swapped_size = ntohl(vector_size);
-                if (swapped_size <= MAX_REASONABLE_VECTOR_SIZE) {
-                    vector_size = swapped_size;
-                    logger.log_debug("Corrected vector size to " + std::to_string(vector_size));
-                } else {
-                    throw std::runtime_error("Unreasonable vector size: " + std::to_string(vector_size));
-                }
-            }
-            
-            logger.log_debug("Vector " + std::to_string(vector_idx) + " has " + 
-                            std::to_string(vector_size) + " elements");
-            
-            if (vector_size == 0) {
-                double zero_result = 0.0;
-                if (!send_exact(client_sock, &zero_result, sizeof(zero_result))) {
-                    throw std::runtime_error("Failed to send result for empty vector");
-                }
-                logger.log_debug("Vector " + std::to_string(vector_idx) + " (empty) result: 0.0");
-                continue;
-            }
-            
-            std::vector<double> vector_data(vector_size);
-            size_t total_bytes_to_read = vector_size * sizeof(double);
-            
-            if (!read_exact(client_sock, vector_data.data(), total_bytes_to_read)) {
-                throw std::runtime_error("Failed to read data for vector " + std::to_string(vector_idx) + 
-                                       ", expected " + std::to_string(total_bytes_to_read) + " bytes");
-            }
-            
-            if (vector_size > 0) {
-                logger.log_debug("First value of vector " + std::to_string(vector_idx) + 
-                               ": " + std::to_string(vector_data[0]));
-            }
-            
-            double vector_result = calculate_sum_of_squares(vector_data);
-            
-            if (!send_exact(client_sock, &vector_result, sizeof(vector_result))) {
-                throw std::runtime_error("Failed to send result for vector " + std::to_string(vector_idx));
+        // Рукопожатие оплачено один раз: пакеты принимаются, пока клиент не закроет
+        // соединение или не промолчит keep_alive_sec секунд
+        do {
+            uint32_t num_vectors = process_batch(input, client_sock, logger, client_ip, stats);
+            batches++;
+            if (stats) {
+                SessionStats::add(stats->batches_processed);
             }
-            
-            logger.log_debug("Vector " + std::to_string(vector_idx) + 
-                            " result: " + std::to_string(vector_result));
-        }
+            LOG_BATCH(logger, LogEvent::BatchProcessed, client_ip, num_vectors);
+        } while (keep_alive_sec > 0 && input.wait_for_data(keep_alive_sec));
         
-        logger.log_data(client_ip, "Successfully processed " + 
-                       std::to_string(num_vectors) + " vectors");
+        log_batches();
         return true;
         
     } catch (const std::exception& e) {
@@ -236,6 +733,7 @@ bool DataCalculator::process_client_data(int client_sock, Logger& logger, const
         }
         
         logger.log_error("Error processing data from " + client_ip + ": " + error_msg);
+        log_batches();
         return false;
     }
 }
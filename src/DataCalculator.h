@@ -2,8 +2,116 @@
 #define DATACALCULATOR_H
 
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 #include <string>
+#include "SessionStats.h"
+#include "BufferPool.h"
+
+//! \brief Механизм ввода-вывода блокирующих сессий
+enum class IoBackend {
+    Select,  //!< select() + recv()/send() на каждый фрагмент
+    Uring    //!< io_uring: операция и связанный таймаут одним вызовом
+};
+
+//! \brief Тип элементов векторов, согласуемый с клиентом
+//! \details Значение - код типа в заголовке согласования ("TYP" и код)
+enum class ElementType : uint8_t {
+    Int32 = 'i',  //!< int32_t
+    Int64 = 'l',  //!< int64_t
+    Float = 'f',  //!< float
+    Double = 'd'  //!< double (без согласования)
+};
+
+//! \brief Статистики вектора, запрашиваемые маской операций
+//! \details Результаты возвращаются подряд в порядке возрастания битов: среднее и
+//! дисперсия - в double, остальные - в типе элементов
+enum StatOp : uint8_t {
+    STAT_SUM_OF_SQUARES = 1 << 0,  //!< Сумма квадратов (без согласования - единственная)
+    STAT_SUM = 1 << 1,             //!< Сумма
+    STAT_MIN = 1 << 2,             //!< Минимум
+    STAT_MAX = 1 << 3,             //!< Максимум
+    STAT_MEAN = 1 << 4,            //!< Среднее
+    STAT_VARIANCE = 1 << 5,        //!< Дисперсия (генеральная)
+    STAT_L1_NORM = 1 << 6,         //!< Сумма модулей
+    STAT_LINF_NORM = 1 << 7        //!< Наибольший модуль
+};
+
+//! \brief Параметры обработки векторов, согласованные с клиентом
+struct DataRequest {
+    ElementType element_type = ElementType::Double;  //!< Тип элементов
+    uint8_t stats_mask = STAT_SUM_OF_SQUARES;        //!< Запрошенные статистики (StatOp)
+    bool framed = false;                             //!< Кадр версии 2: 64-битные размеры, длина нагрузки задана
+    bool swap_bytes = false;                         //!< Порядок байт кадра отличается от порядка байт хоста
+    bool negotiated = false;                         //!< В пакете приняты заголовки согласования
+};
+
+//! \brief Вид заголовка в начале пакета
+//! \details Кадр версии 2 допустим только первым заголовком пакета: он сам задаёт тип
+//! элементов и маску, поэтому после "TYP"/"OPS" отклоняется ответом "ERR"
+enum class BatchHeader {
+    Frame,        //!< Кадр версии 2
+    Negotiation,  //!< Заголовок согласования "TYP" или "OPS"
+    VectorCount,  //!< Количество векторов старого формата
+    Misplaced     //!< Кадр после заголовков согласования
+};
+
+//! \brief Флаги заголовка кадра
+enum FrameFlag : uint8_t {
+    FRAME_BIG_ENDIAN = 1 << 0  //!< Числа кадра и результаты - в порядке big-endian
+};
+
+//! \brief Заголовок кадра протокола версии 2
+//! \details Передаётся вместо количества векторов. Сигнатура - байты "VEC2", флаги
+//! задают порядок байт всех остальных чисел кадра: количества векторов, длины нагрузки,
+//! 8-байтовых размеров векторов, элементов и результатов. Нагрузка - num_vectors раз
+//! размер вектора и его элементы, payload_length - её длина в байтах
+struct FrameHeader {
+    uint32_t magic;          //!< Сигнатура "VEC2"
+    uint8_t version;         //!< Версия протокола
+    uint8_t flags;           //!< Флаги FrameFlag
+    uint8_t element_type;    //!< Код ElementType
+    uint8_t stats_mask;      //!< Запрошенные статистики (StatOp)
+    uint32_t num_vectors;    //!< Количество векторов
+    uint32_t reserved;       //!< Резерв, нули
+    uint64_t payload_length; //!< Длина нагрузки после заголовка, байт
+};
+static_assert(sizeof(FrameHeader) == 24, "FrameHeader must match the wire layout");
+
+//! \brief Свойства типа элементов
+//! \details Accumulator - тип суммы: достаточно широкий, чтобы квадрат элемента
+//! и сумма до насыщения не переполнялись
+//! \tparam T Тип элементов
+template<typename T>
+struct ElementTraits;
+
+template<>
+struct ElementTraits<int32_t> {
+    using Accumulator = int64_t;                            //!< Квадрат не больше 2^62
+    static constexpr ElementType type = ElementType::Int32; //!< Код типа
+    static constexpr const char* name = "int32";            //!< Название для журнала
+};
+
+template<>
+struct ElementTraits<int64_t> {
+    using Accumulator = unsigned __int128;                  //!< Квадрат не больше 2^126
+    static constexpr ElementType type = ElementType::Int64; //!< Код типа
+    static constexpr const char* name = "int64";            //!< Название для журнала
+};
+
+template<>
+struct ElementTraits<float> {
+    using Accumulator = double;                             //!< Квадраты float суммируются без потери точности
+    static constexpr ElementType type = ElementType::Float; //!< Код типа
+    static constexpr const char* name = "float";            //!< Название для журнала
+};
+
+template<>
+struct ElementTraits<double> {
+    using Accumulator = double;                              //!< Сумма того же типа
+    static constexpr ElementType type = ElementType::Double; //!< Код типа
+    static constexpr const char* name = "double";            //!< Название для журнала
+};
 
 //! \brief Класс для вычисления суммы квадратов векторов
 //! \details Обрабатывает данные от клиентов, вычисляет сумму квадратов с проверкой переполнения
@@ -14,11 +122,65 @@ class DataCalculator {
 private:
     static constexpr uint32_t MAX_REASONABLE_VECTORS = 1000;      //!< Максимальное разумное количество векторов
     static constexpr uint32_t MAX_REASONABLE_VECTOR_SIZE = 1000000; //!< Максимальный разумный размер вектора
+    static constexpr uint64_t MAX_STREAMING_VECTOR_SIZE = uint64_t(1) << 40; //!< Предел 64-битного размера вектора
+    static constexpr size_t BATCH_BUFFER_SIZE = 64 * 1024;          //!< Буфер приёма пакета векторов
     
+    static IoBackend io_backend; //!< Выбранный механизм ввода-вывода
     
 public:
     static constexpr int DATA_PROCESSING_TIMEOUT_SEC = 1; //!< Таймаут обработки данных в секундах
+    
+    //! \brief Признак 64-битного размера вектора
+    //! \details Вместо 4-байтового размера клиент отправляет это значение и следом
+    //! 8-байтовый размер; так передаются векторы длиннее MAX_REASONABLE_VECTOR_SIZE
+    static constexpr uint32_t VECTOR_SIZE_EXTENDED = 0xFFFFFFFF;
+    
+    //! \brief Заголовок согласования типа элементов
+    //! \details Вместо количества векторов клиент может отправить байты "TYP" и код
+    //! ElementType; сервер отвечает "OK" или "ERR" при неизвестном типе, затем
+    //! следует количество векторов. Младшие байты заголовка ненулевые, поэтому он не
+    //! совпадает ни с количеством векторов, ни с количеством в обратном порядке байт
+    static constexpr uint32_t ELEMENT_TYPE_MARKER = 0x00505954;
+    static constexpr uint32_t ELEMENT_TYPE_MARKER_MASK = 0x00FFFFFF; //!< Байты "TYP" заголовка
+    
+    //! \brief Заголовок маски операций
+    //! \details Байты "OPS" и маска StatOp; согласуется так же, как тип элементов,
+    //! в любом порядке с ним. Нулевая маска отклоняется
+    static constexpr uint32_t STATS_MASK_MARKER = 0x0053504F;
+    
+    //! \brief Сигнатура кадра протокола версии 2 (байты "VEC2")
+    //! \details Как количество векторов в любом порядке байт больше MAX_REASONABLE_VECTORS,
+    //! поэтому клиент старого формата не может отправить её случайно
+    static constexpr uint32_t FRAME_MAGIC = 0x32434556;
+    static constexpr uint8_t FRAME_VERSION = 2;  //!< Версия протокола кадра
+    
+    static constexpr size_t STREAM_CHUNK_SIZE = 64 * 1024; //!< Порция элементов при потоковом приёме, байт
+    
+    //! \brief Наименьший массив, суммируемый параллельно в ComputePool, элементов
+    //! \details Меньшие массивы суммируются в вызывающем потоке: раздача заданий
+    //! стоит дороже, чем выигрыш от нескольких ядер
+    static constexpr size_t PARALLEL_REDUCTION_THRESHOLD = size_t(1) << 18;
+    
+    //! \brief Блок параллельного суммирования, элементов (256 КБ - помещается в L2)
+    //! \details Границы блоков зависят только от длины массива, а частичные суммы
+    //! складываются по порядку блоков, поэтому результат не зависит от числа потоков
+    static constexpr size_t PARALLEL_BLOCK_SIZE = size_t(1) << 15;
+    
+    //! \brief Счётчик системных вызовов ввода-вывода текущего потока
+    //! \details Используется для сравнения механизмов ввода-вывода в бенчмарке
+    static thread_local uint64_t io_syscalls;
+    
+    //! \brief Выбрать механизм ввода-вывода
+    //! \details При недоступности io_uring сохраняется механизм select
+    //! \param[in] backend Желаемый механизм
+    //! \return Фактически установленный механизм
+    static IoBackend set_io_backend(IoBackend backend);
+    
+    //! \brief Получить текущий механизм ввода-вывода
+    //! \return Механизм ввода-вывода
+    static IoBackend get_io_backend() { return io_backend; }
 
+    //! \brief Прочитать точное количество байт из сокета
     //! \param[in] sock Сокет для чтения
     //! \param[out] buffer Буфер для данных
     //! \param[in] size Количество байт для чтения
@@ -26,6 +188,16 @@ public:
     //! \throw std::runtime_error При ошибке чтения
     static bool read_exact(int sock, void* buffer, size_t size);
     
+    //! \brief Прочитать доступные данные из сокета
+    //! \details Сначала пробует recv без ожидания; ждёт данных (select или io_uring)
+    //! только если сокет пуст
+    //! \param[in] sock Сокет для чтения
+    //! \param[out] buffer Буфер для данных
+    //! \param[in] size Размер буфера
+    //! \return Количество прочитанных байт (не меньше одного)
+    //! \throw std::runtime_error При таймауте, закрытии соединения или ошибке чтения
+    static size_t read_some(int sock, void* buffer, size_t size);
+    
     //! \brief Отправить точное количество байт в сокет
     //! \param[in] sock Сокет для отправки
     //! \param[in] buffer Буфер с данными
@@ -34,12 +206,159 @@ public:
     //! \throw std::runtime_error При ошибке отправки
     static bool send_exact(int sock, const void* buffer, size_t size);
     
+    //! \brief Отправить результат и принять следующий заголовок
+    //! \details С io_uring обе операции выполняются одним вызовом io_uring_enter
+    //! \param[in] sock Сокет клиента
+    //! \param[in] out Отправляемые данные
+    //! \param[in] out_size Размер отправляемых данных
+    //! \param[out] in Буфер приёма
+    //! \param[in] in_size Количество байт для приёма
+    //! \return true если успешно
+    //! \throw std::runtime_error При ошибке отправки или чтения
+    static bool send_then_read(int sock, const void* out, size_t out_size, void* in, size_t in_size);
+    
     //! \brief Обработать данные от клиента
+    //! \details Принимает всё доступное в буфер сессии и разбирает из него столько
+    //! целых векторов, сколько поместилось; результаты копятся и уходят одним send
+    //! перед тем, как сессии придётся ждать новых данных. Элементы сворачиваются
+    //! в сумму по мере поступления, поэтому память сессии не зависит от длины вектора.
+    //! Данные начинаются либо с кадра версии 2 (FrameHeader, без подтверждения, "ERR"
+    //! при отклонении), либо со старого формата: заголовки согласования и количество
+    //! векторов, порядок байт которых угадывается по величине.
+    //! При keep_alive_sec > 0 после пакета ждёт следующий: закрытие соединения клиентом
+    //! или простой дольше keep_alive_sec между пакетами - штатное завершение.
     //! \param[in] client_sock Сокет клиента
     //! \param[in] logger Логгер для записи событий
     //! \param[in] client_ip IP адрес клиента
+    //! \param[in] stats Счётчики сессий (nullptr - не учитывать)
+    //! \param[in] keep_alive_sec Наибольший простой между пакетами, с (0 - один пакет)
     //! \return true если обработка успешна, false при ошибке
-    static bool process_client_data(int client_sock, class Logger& logger, const std::string& client_ip);
+    static bool process_client_data(int client_sock, class Logger& logger, const std::string& client_ip,
+                                    SessionStats* stats = nullptr, unsigned keep_alive_sec = 0);
+    
+    //! \brief Проверить количество векторов и исправить порядок байт
+    //! \param[in] num_vectors Значение, полученное от клиента
+    //! \param[in] logger Логгер для отладочных сообщений
+    //! \return Количество векторов в порядке байт хоста
+    //! \throw std::runtime_error При нулевом или неразумном количестве
+    static uint32_t normalize_vector_count(uint32_t num_vectors, class Logger& logger);
+    
+    //! \brief Проверить размер вектора и исправить порядок байт
+    //! \param[in] vector_size Значение, полученное от клиента
+    //! \param[in] logger Логгер для отладочных сообщений
+    //! \return Размер вектора в порядке байт хоста
+    //! \throw std::runtime_error При неразумном размере
+    static uint32_t normalize_vector_size(uint32_t vector_size, class Logger& logger);
+    
+    //! \brief Проверить 64-битный размер вектора и исправить порядок байт
+    //! \param[in] vector_size Значение, полученное от клиента
+    //! \param[in] logger Логгер для отладочных сообщений
+    //! \return Размер вектора в порядке байт хоста
+    //! \throw std::runtime_error При размере больше MAX_STREAMING_VECTOR_SIZE
+    static uint64_t normalize_extended_vector_size(uint64_t vector_size, class Logger& logger);
+    
+    //! \brief Проверить, является ли заголовок данных заголовком согласования типа
+    //! \param[in] header Первые 4 байта данных клиента
+    //! \return true если это "TYP" и код типа
+    static bool is_element_type_header(uint32_t header) {
+        return (header & ELEMENT_TYPE_MARKER_MASK) == ELEMENT_TYPE_MARKER;
+    }
+    
+    //! \brief Разобрать заголовок согласования типа
+    //! \param[in] header Заголовок согласования
+    //! \param[out] type Тип элементов
+    //! \return true если тип поддерживается
+    static bool parse_element_type(uint32_t header, ElementType& type);
+    
+    //! \brief Проверить, является ли заголовок данных заголовком маски операций
+    //! \param[in] header Первые 4 байта данных клиента
+    //! \return true если это "OPS" и маска
+    static bool is_stats_mask_header(uint32_t header) {
+        return (header & ELEMENT_TYPE_MARKER_MASK) == STATS_MASK_MARKER;
+    }
+    
+    //! \brief Проверить, является ли заголовок данных заголовком согласования
+    //! \param[in] header Первые 4 байта данных клиента
+    //! \return true для заголовков "TYP" и "OPS"
+    static bool is_negotiation_header(uint32_t header) {
+        return is_element_type_header(header) || is_stats_mask_header(header);
+    }
+    
+    //! \brief Проверить, начинается ли кадр с сигнатуры протокола версии 2
+    //! \param[in] header Первые 4 байта данных клиента
+    //! \return true если это "VEC2"
+    static bool is_frame_header(uint32_t header) { return header == FRAME_MAGIC; }
+    
+    //! \brief Определить вид очередного заголовка в начале пакета
+    //! \details Единое правило для сессий всех режимов (см. BatchHeader)
+    //! \param[in] header Очередные 4 байта данных клиента
+    //! \param[in] request Параметры пакета, согласованные до этого заголовка
+    //! \return Вид заголовка
+    static BatchHeader classify_batch_header(uint32_t header, const DataRequest& request) {
+        if (is_frame_header(header)) {
+            return request.negotiated ? BatchHeader::Misplaced : BatchHeader::Frame;
+        }
+        return is_negotiation_header(header) ? BatchHeader::Negotiation : BatchHeader::VectorCount;
+    }
+    
+    //! \brief Разобрать и проверить заголовок кадра версии 2
+    //! \details Переводит числа заголовка в порядок байт хоста. Проверяются версия,
+    //! флаги, тип элементов, маска, количество векторов и то, что длина нагрузки
+    //! достижима при таком количестве векторов
+    //! \param[in,out] frame Принятый заголовок
+    //! \param[out] request Параметры обработки кадра
+    //! \param[in] logger Логгер для отладочных сообщений
+    //! \return true если заголовок принят, false - отклонён (ответ "ERR")
+    static bool parse_frame_header(FrameHeader& frame, DataRequest& request, class Logger& logger);
+    
+    //! \brief Проверить размер вектора кадра и учесть его в длине нагрузки
+    //! \param[in] raw_size 8-байтовый размер в порядке байт кадра
+    //! \param[in] request Параметры обработки кадра
+    //! \param[in] last Последний вектор кадра: нагрузка должна закончиться на нём
+    //! \param[in,out] payload_remaining Неразобранная длина нагрузки, байт
+    //! \return Количество элементов
+    //! \throw std::runtime_error Если вектор выходит за длину нагрузки или не исчерпывает её
+    static uint64_t take_frame_vector_size(uint64_t raw_size, const DataRequest& request, bool last,
+                                           uint64_t& payload_remaining);
+    
+    //! \brief Изменить порядок байт элементов на обратный
+    //! \param[in,out] data Элементы (без требований к выравниванию)
+    //! \param[in] count Количество элементов
+    //! \param[in] width Размер элемента: 4 или 8 байт
+    static void swap_byte_order(void* data, size_t count, size_t width);
+    
+    //! \brief Применить заголовок согласования к параметрам обработки
+    //! \param[in] header Заголовок "TYP" или "OPS"
+    //! \param[in,out] request Параметры обработки
+    //! \param[in] logger Логгер для отладочных сообщений
+    //! \return true если заголовок принят (ответ "OK"), false - отклонён (ответ "ERR")
+    static bool apply_negotiation_header(uint32_t header, DataRequest& request, class Logger& logger);
+    
+    //! \brief Получить размер элемента
+    //! \param[in] type Тип элементов
+    //! \return Размер в байтах
+    static size_t element_size(ElementType type);
+    
+    //! \brief Получить название типа элементов
+    //! \param[in] type Тип элементов
+    //! \return Название ("int32", "int64", "float", "double")
+    static const char* element_type_name(ElementType type);
+    
+    //! \brief Вызвать обобщённую функцию для типа элементов
+    //! \details Переводит тип, согласованный во время работы, в параметр шаблона:
+    //! функция получает std::type_identity<T> и инстанцируется для каждого типа
+    //! \param[in] type Тип элементов
+    //! \param[in] fn Функция
+    //! \return Результат функции
+    template<typename Fn>
+    static decltype(auto) dispatch_element_type(ElementType type, Fn&& fn) {
+        switch (type) {
+            case ElementType::Int32: return fn(std::type_identity<int32_t>{});
+            case ElementType::Int64: return fn(std::type_identity<int64_t>{});
+            case ElementType::Float: return fn(std::type_identity<float>{});
+            default: return fn(std::type_identity<double>{});
+        }
+    }
     
     //! \brief Вычислить сумму квадратов вектора
     //! \param[in] vec Вектор значений
@@ -47,6 +366,15 @@ public:
     //! \throw std::overflow_error При переполнении вычислений
     static double calculate_sum_of_squares(const std::vector<double>& vec);
     
+    //! \brief Вычислить сумму квадратов массива
+    //! \tparam T Тип элементов
+    //! \param[in] data Элементы
+    //! \param[in] size Количество элементов
+    //! \return Сумма квадратов элементов (см. SquareSumAccumulator::result)
+    //! \throw std::overflow_error При переполнении вычислений с плавающей точкой
+    template<typename T>
+    static T calculate_sum_of_squares(const T* data, size_t size);
+    
     //! \brief Обработать переполнение значения
     //! \param[in] value Проверяемое значение
     //! \return Значение с ограничением по диапазону
@@ -54,4 +382,64 @@ public:
     static double handle_overflow(double value);
 };
 
+//! \brief Накопитель суммы квадратов для потоковой обработки
+//! \details Принимает элементы вектора порциями по мере поступления из сети
+//! с теми же проверками переполнения, что и DataCalculator::calculate_sum_of_squares.
+//! Порция float/double суммируется векторным ядром SimdKernels, переполнение проверяется
+//! один раз на порцию; порции от DataCalculator::PARALLEL_REDUCTION_THRESHOLD элементов
+//! делятся на блоки, которые суммируются в ComputePool. Сетевые порции меньше порога,
+//! поэтому для вектора не короче порога (expected_count) они копируются в промежуточный
+//! блок из BufferPool и суммируются блоками по мере его заполнения: границы блоков
+//! отсчитываются от начала вектора, и результат побитово совпадает с
+//! calculate_sum_of_squares для всего вектора. Целые суммируются
+//! в ElementTraits<T>::Accumulator до насыщения на максимуме T.
+//! \tparam T Тип элементов
+template<typename T = double>
+class SquareSumAccumulator {
+private:
+    using Accumulator = typename ElementTraits<T>::Accumulator;
+
+    Accumulator sum = 0;   //!< Накопленная сумма
+    PooledBuffer staging;  //!< Промежуточный блок длинного вектора
+    size_t staged = 0;     //!< Элементов в промежуточном блоке
+    uint64_t pending = 0;  //!< Элементов вектора, ещё не поступивших в промежуточный блок
+
+    //! \brief Просуммировать массив блоками PARALLEL_BLOCK_SIZE в ComputePool
+    //! \param[in] data Элементы
+    //! \param[in] count Количество элементов
+    //! \throw std::overflow_error При переполнении суммы или inf/nan на входе
+    void add_blocks(const T* data, size_t count);
+
+public:
+    //! \brief Конструктор накопителя
+    //! \param[in] expected_count Длина вектора, если известна заранее; для float/double
+    //! от PARALLEL_REDUCTION_THRESHOLD элементов включает промежуточный блок
+    explicit SquareSumAccumulator(uint64_t expected_count = 0);
+
+    //! \brief Добавить элементы
+    //! \param[in] data Элементы
+    //! \param[in] count Количество элементов
+    //! \throw std::overflow_error При переполнении суммы float/double или inf/nan на входе
+    void add(const T* data, size_t count);
+
+    //! \brief Добавить элементы из невыровненного буфера
+    //! \param[in] bytes Байты элементов
+    //! \param[in] count Количество элементов
+    //! \throw std::overflow_error При переполнении суммы float/double или inf/nan на входе
+    void add_unaligned(const char* bytes, size_t count);
+
+    //! \brief Получить сумму квадратов
+    //! \details При заданной expected_count вызывается после добавления всех элементов
+    //! \return Сумма; для целых и float - не больше максимума T
+    //! \throw std::overflow_error При недопустимом значении (inf/nan)
+    T result() const;
+};
+
+template<typename T>
+T DataCalculator::calculate_sum_of_squares(const T* data, size_t size) {
+    SquareSumAccumulator<T> accumulator;
+    accumulator.add(data, size);
+    return accumulator.result();
+}
+
 #endif // DATACALCULATOR_H
@@ -0,0 +1,204 @@
+/*! \file EpollLoop.cpp
+ *  \brief Реализация класса EpollLoop
+ *  \details Содержит реализацию цикла событий epoll для клиентских сессий
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "EpollLoop.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+EpollLoop::EpollLoop(AuthManager& auth_manager, Logger& logger, int listen_fd, int cpu,
+                     const SessionGate& gate, unsigned keep_alive_sec)
+    : auth_manager(auth_manager), logger(logger), listen_fd(listen_fd),
+      epoll_fd(-1), wake_fd(-1), cpu(cpu), gate(gate), keep_alive_sec(keep_alive_sec), running(false),
+      last_sweep(std::chrono::steady_clock::now()) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        throw std::runtime_error("epoll_create1 failed: " + std::string(strerror(errno)));
+    }
+    
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        close(epoll_fd);
+        throw std::runtime_error("eventfd failed: " + std::string(strerror(errno)));
+    }
+    
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+    
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.fd = listen_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        close(wake_fd);
+        close(epoll_fd);
+        throw std::runtime_error("Failed to register listening socket in epoll: " +
+                                 std::string(strerror(errno)));
+    }
+}
+
+EpollLoop::~EpollLoop() {
+    for (auto& entry : sessions) {
+        close(entry.first);
+        gate.release(IpRateLimiter::parse_ip(entry.second->get_client_ip()));
+        SessionStats::add(stats.connections_closed);
+        logger.log_connection(entry.second->get_client_ip(), false);
+    }
+    sessions.clear();
+    close(wake_fd);
+    close(epoll_fd);
+}
+
+void EpollLoop::accept_clients() {
+    for (;;) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_sock = accept4(listen_fd, reinterpret_cast<struct sockaddr*>(&client_addr),
+                                  &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_sock < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && running) {
+                logger.log_error("accept failed: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+        
+        uint32_t client_address = client_addr.sin_addr.s_addr;
+        if (!gate.admit(client_sock, client_address, stats)) {
+            continue;
+        }
+        
+        char ip_str[INET_ADDRSTRLEN] = "unknown";
+        inet_ntop(AF_INET, &client_addr.sin_addr, ip_str, sizeof(ip_str));
+        logger.log_connection(ip_str, true);
+        SessionStats::add(stats.connections_accepted);
+        
+        auto session = std::make_unique<ClientSession>(client_sock, ip_str, auth_manager, logger, stats,
+                                                       keep_alive_sec);
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = client_sock;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_sock, &ev) < 0) {
+            logger.log_error("Failed to register client socket in epoll: " + std::string(strerror(errno)));
+            close(client_sock);
+            gate.release(client_address);
+            SessionStats::add(stats.connections_closed);
+            logger.log_connection(ip_str, false);
+            continue;
+        }
+        sessions.emplace(client_sock, std::move(session));
+    }
+}
+
+void EpollLoop::update_interest(const ClientSession& session) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = session.wants_write() ? EPOLLOUT : EPOLLIN;
+    ev.data.fd = session.socket();
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session.socket(), &ev);
+}
+
+void EpollLoop::close_session(int fd) {
+    auto it = sessions.find(fd);
+    if (it == sessions.end()) {
+        return;
+    }
+    std::string client_ip = it->second->get_client_ip();
+    sessions.erase(it);
+    close(fd);
+    gate.release(IpRateLimiter::parse_ip(client_ip));
+    SessionStats::add(stats.connections_closed);
+    logger.log_connection(client_ip, false);
+}
+
+void EpollLoop::expire_sessions() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_sweep < std::chrono::milliseconds(SWEEP_INTERVAL_MS)) {
+        return;
+    }
+    last_sweep = now;
+    
+    std::vector<int> expired;
+    for (auto& entry : sessions) {
+        if (entry.second->expired(now)) {
+            entry.second->expire();
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        close_session(fd);
+    }
+}
+
+void EpollLoop::run() {
+    if (cpu >= 0) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+            logger.log_error("Failed to pin event loop to CPU " + std::to_string(cpu));
+        }
+    }
+    
+    running = true;
+    std::vector<struct epoll_event> events(MAX_EVENTS);
+    
+    while (running) {
+        int n = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, SWEEP_INTERVAL_MS);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            logger.log_error("epoll_wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+        
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd) {
+                continue;
+            }
+            if (fd == listen_fd) {
+                accept_clients();
+                continue;
+            }
+            
+            auto it = sessions.find(fd);
+            if (it == sessions.end()) {
+                continue;
+            }
+            ClientSession& session = *it->second;
+            bool was_writing = session.wants_write();
+            if (!session.handle_io()) {
+                close_session(fd);
+            } else if (session.wants_write() != was_writing) {
+                update_interest(session);
+            }
+        }
+        
+        expire_sessions();
+    }
+}
+
+void EpollLoop::stop() {
+    running = false;
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void)written;
+}
@@ -0,0 +1,92 @@
+#ifndef EPOLLLOOP_H
+#define EPOLLLOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ClientSession.h"
+#include "SessionGate.h"
+#include "SessionStats.h"
+
+class AuthManager;
+class Logger;
+
+//! \brief Цикл событий epoll для неблокирующих клиентских сессий
+//! \details Один поток обслуживает все свои сессии: принимает подключения
+//! с прослушивающего сокета, продвигает автоматы ClientSession по готовности
+//! сокетов и закрывает сессии с истёкшим сроком ожидания.
+//! Несколько циклов могут разделять один прослушивающий сокет (EPOLLEXCLUSIVE)
+//! либо каждый цикл может владеть своим сокетом SO_REUSEPORT (шард).
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class EpollLoop {
+private:
+    static constexpr int MAX_EVENTS = 256;          //!< Событий за один вызов epoll_wait
+    static constexpr int SWEEP_INTERVAL_MS = 100;   //!< Период проверки таймаутов
+
+    AuthManager& auth_manager;       //!< Менеджер аутентификации
+    Logger& logger;                  //!< Логгер
+    int listen_fd;                   //!< Прослушивающий сокет (неблокирующий)
+    int epoll_fd;                    //!< Дескриптор epoll
+    int wake_fd;                     //!< eventfd для пробуждения при остановке
+    int cpu;                         //!< Ядро для привязки потока (-1 - без привязки)
+    SessionGate gate;                //!< Допуск подключений
+    unsigned keep_alive_sec;         //!< Простой сессии между пакетами, с (0 - один пакет)
+    SessionStats stats;              //!< Счётчики сессий этого цикла
+    std::atomic<bool> running;       //!< Флаг работы цикла
+    std::unordered_map<int, std::unique_ptr<ClientSession>> sessions; //!< Активные сессии
+    std::chrono::steady_clock::time_point last_sweep;                 //!< Время последней проверки таймаутов
+
+    //! \brief Принять все ожидающие подключения
+    void accept_clients();
+
+    //! \brief Обновить интерес epoll по состоянию сессии
+    //! \param[in] session Сессия
+    void update_interest(const ClientSession& session);
+
+    //! \brief Закрыть сессию и освободить сокет
+    //! \param[in] fd Сокет сессии
+    void close_session(int fd);
+
+    //! \brief Закрыть сессии с истёкшим сроком ожидания
+    void expire_sessions();
+
+public:
+    //! \brief Конструктор цикла
+    //! \param[in] auth_manager Менеджер аутентификации
+    //! \param[in] logger Логгер
+    //! \param[in] listen_fd Неблокирующий прослушивающий сокет
+    //! \param[in] cpu Ядро, к которому привязывается поток цикла (-1 - без привязки)
+    //! \param[in] gate Допуск подключений, общий для всех циклов (по умолчанию - без ограничений)
+    //! \param[in] keep_alive_sec Простой сессии между пакетами, с (0 - один пакет на подключение)
+    //! \throw std::runtime_error При ошибке создания epoll или eventfd
+    EpollLoop(AuthManager& auth_manager, Logger& logger, int listen_fd, int cpu = -1,
+              const SessionGate& gate = SessionGate(), unsigned keep_alive_sec = 0);
+
+    //! \brief Деструктор, закрывает оставшиеся сессии
+    ~EpollLoop();
+
+    EpollLoop(const EpollLoop&) = delete;
+    EpollLoop& operator=(const EpollLoop&) = delete;
+
+    //! \brief Выполнять цикл событий до вызова stop()
+    void run();
+
+    //! \brief Запросить остановку цикла
+    //! \details Допускается вызов из другого потока и из обработчика сигнала
+    void stop();
+
+    //! \brief Получить количество активных сессий
+    //! \return Количество сессий (только из потока цикла)
+    size_t session_count() const { return sessions.size(); }
+    
+    //! \brief Получить счётчики сессий цикла
+    //! \return Счётчики (допускается чтение из любого потока)
+    const SessionStats& get_stats() const { return stats; }
+};
+
+#endif // EPOLLLOOP_H
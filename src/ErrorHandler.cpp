@@ -12,6 +12,7 @@
 #include <sstream>
 #include <cerrno>
 #include <cstring>
+#include <system_error>
 
 ErrorHandler::ErrorHandler(std::shared_ptr<Logger> logger) 
     : logger(logger) {}
@@ -20,10 +21,11 @@ void ErrorHandler::handle_network_error(const std::string& context, int error_co
     std::stringstream ss;
     ss << "Network error [" << context << "]";
     
+    int saved_errno = errno;
     if (error_code != 0) {
-        ss << ": " << strerror(error_code) << " (code: " << error_code << ")";
-    } else if (errno != 0) {
-        ss << ": " << strerror(errno) << " (errno: " << errno << ")";
+        ss << ": " << std::system_category().message(error_code) << " (code: " << error_code << ")";
+    } else if (saved_errno != 0) {
+        ss << ": " << std::system_category().message(saved_errno) << " (errno: " << saved_errno << ")";
     }
     
     std::string message = ss.str();
@@ -4,7 +4,8 @@
 #include <memory>
 
 //! \brief Класс для обработки ошибок сервера
-//! \details Обрабатывает различные типы ошибок: сетевые, аутентификации, вычислений, I/O
+//! \details Обрабатывает различные типы ошибок: сетевые, аутентификации, вычислений, I/O.
+//! Не хранит изменяемого состояния и может использоваться несколькими потоками
 //! \author Осетров М.С.
 //! \date 2025
 //! \copyright ПГУ
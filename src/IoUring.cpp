@@ -0,0 +1,306 @@
+/*! \file IoUring.cpp
+ *  \brief Реализация класса IoUring
+ *  \details Содержит реализацию операций чтения и записи через io_uring
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "IoUring.h"
+#include "DataCalculator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    enum : uint64_t {
+        TAG_TRANSFER = 1, //!< Метка основной операции
+        TAG_TIMEOUT = 2,  //!< Метка связанного таймаута
+        TAG_SEND = 3      //!< Метка предварительной отправки
+    };
+
+    int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+        DataCalculator::io_syscalls++;
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    bool is_timeout(int res) {
+        return res == -ECANCELED || res == -ETIME;
+    }
+}
+
+IoUring::IoUring()
+    : ring_fd(-1), sq_ring_ptr(MAP_FAILED), sq_ring_size(0), cq_ring_ptr(MAP_FAILED),
+      cq_ring_size(0), sqes(nullptr), sqes_size(0), pending(0) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd = sys_io_uring_setup(RING_ENTRIES, &params);
+    if (ring_fd < 0) {
+        throw std::runtime_error("io_uring_setup failed: " + std::string(strerror(errno)));
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+
+    sq_ring_ptr = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr == MAP_FAILED) {
+        close(ring_fd);
+        throw std::runtime_error("io_uring SQ ring mmap failed");
+    }
+
+    if (single_mmap) {
+        cq_ring_ptr = sq_ring_ptr;
+    } else {
+        cq_ring_ptr = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring_ptr == MAP_FAILED) {
+            munmap(sq_ring_ptr, sq_ring_size);
+            close(ring_fd);
+            throw std::runtime_error("io_uring CQ ring mmap failed");
+        }
+    }
+
+    sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes_ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd, IORING_OFF_SQES);
+    if (sqes_ptr == MAP_FAILED) {
+        if (!single_mmap) munmap(cq_ring_ptr, cq_ring_size);
+        munmap(sq_ring_ptr, sq_ring_size);
+        close(ring_fd);
+        throw std::runtime_error("io_uring SQE mmap failed");
+    }
+    sqes = static_cast<struct io_uring_sqe*>(sqes_ptr);
+
+    char* sq = static_cast<char*>(sq_ring_ptr);
+    sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cq_ring_ptr);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+    munmap(sqes, sqes_size);
+    if (cq_ring_ptr != sq_ring_ptr) {
+        munmap(cq_ring_ptr, cq_ring_size);
+    }
+    munmap(sq_ring_ptr, sq_ring_size);
+    close(ring_fd);
+}
+
+bool IoUring::is_supported() {
+    static const bool supported = []() {
+        try {
+            IoUring probe;
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }();
+    return supported;
+}
+
+IoUring* IoUring::for_current_thread() {
+    thread_local std::unique_ptr<IoUring> ring;
+    thread_local bool attempted = false;
+    if (!attempted) {
+        attempted = true;
+        try {
+            ring.reset(new IoUring());
+        } catch (const std::exception&) {
+            ring.reset();
+        }
+    }
+    return ring.get();
+}
+
+io_uring_sqe* IoUring::get_sqe() {
+    unsigned tail = *sq_tail + pending;
+    unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    if (tail - head >= RING_ENTRIES) {
+        throw std::runtime_error("io_uring submission queue overflow");
+    }
+    unsigned index = tail & *sq_mask;
+    sq_array[index] = index;
+    pending++;
+    struct io_uring_sqe* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+void IoUring::prepare_with_timeout(uint8_t opcode, int sock, const void* buffer, size_t size,
+                                   int msg_flags, int timeout_sec, uint64_t user_data, void* ts) {
+    struct io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = opcode;
+    sqe->fd = sock;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->msg_flags = static_cast<uint32_t>(msg_flags);
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = user_data;
+
+    struct __kernel_timespec* timeout = static_cast<struct __kernel_timespec*>(ts);
+    timeout->tv_sec = timeout_sec;
+    timeout->tv_nsec = 0;
+
+    struct io_uring_sqe* timeout_sqe = get_sqe();
+    timeout_sqe->opcode = IORING_OP_LINK_TIMEOUT;
+    timeout_sqe->fd = -1;
+    timeout_sqe->addr = reinterpret_cast<uint64_t>(timeout);
+    timeout_sqe->len = 1;
+    timeout_sqe->user_data = TAG_TIMEOUT;
+}
+
+void IoUring::submit_and_wait(unsigned wait_nr, int* results, size_t results_size) {
+    __atomic_store_n(sq_tail, *sq_tail + pending, __ATOMIC_RELEASE);
+    unsigned to_submit = pending;
+    pending = 0;
+
+    unsigned completed = 0;
+    while (completed < wait_nr) {
+        int ret = sys_io_uring_enter(ring_fd, to_submit, wait_nr - completed, IORING_ENTER_GETEVENTS);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                to_submit = 0;
+                continue;
+            }
+            throw std::runtime_error("io_uring_enter failed: " + std::string(strerror(errno)));
+        }
+        to_submit = 0;
+
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const struct io_uring_cqe& cqe = cqes[head & *cq_mask];
+            if (cqe.user_data < results_size) {
+                results[cqe.user_data] = cqe.res;
+            }
+            head++;
+            completed++;
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+
+int IoUring::transfer(uint8_t opcode, int sock, const void* buffer, size_t size, int msg_flags, int timeout_sec) {
+    struct __kernel_timespec ts;
+    int results[4] = {0, 0, 0, 0};
+    prepare_with_timeout(opcode, sock, buffer, size, msg_flags, timeout_sec, TAG_TRANSFER, &ts);
+    submit_and_wait(2, results, 4);
+    return results[TAG_TRANSFER];
+}
+
+bool IoUring::read_exact(int sock, void* buffer, size_t size, int timeout_sec) {
+    char* ptr = static_cast<char*>(buffer);
+    size_t total = 0;
+    while (total < size) {
+        int res = transfer(IORING_OP_RECV, sock, ptr + total, size - total, MSG_WAITALL, timeout_sec);
+        if (res > 0) {
+            total += res;
+        } else if (res == 0) {
+            throw std::runtime_error("Connection closed by client during read");
+        } else if (is_timeout(res)) {
+            throw std::runtime_error("Data reading timeout (possible type mismatch: client sends int32_t instead of double)");
+        } else if (res != -EINTR && res != -EAGAIN) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(-res)));
+        }
+    }
+    return true;
+}
+
+size_t IoUring::read_some(int sock, void* buffer, size_t size, int timeout_sec) {
+    for (;;) {
+        int res = transfer(IORING_OP_RECV, sock, buffer, size, 0, timeout_sec);
+        if (res > 0) {
+            return static_cast<size_t>(res);
+        } else if (res == 0) {
+            throw std::runtime_error("Connection closed by client during read");
+        } else if (is_timeout(res)) {
+            throw std::runtime_error("Data reading timeout (possible type mismatch: client sends int32_t instead of double)");
+        } else if (res != -EINTR && res != -EAGAIN) {
+            throw std::runtime_error("recv failed: " + std::string(strerror(-res)));
+        }
+    }
+}
+
+bool IoUring::send_exact(int sock, const void* buffer, size_t size, int timeout_sec) {
+    const char* ptr = static_cast<const char*>(buffer);
+    size_t total = 0;
+    while (total < size) {
+        int res = transfer(IORING_OP_SEND, sock, ptr + total, size - total,
+                           MSG_NOSIGNAL | MSG_WAITALL, timeout_sec);
+        if (res > 0) {
+            total += res;
+        } else if (res == 0) {
+            throw std::runtime_error("Connection closed by client during send");
+        } else if (is_timeout(res)) {
+            throw std::runtime_error("Data sending timeout (client not reading)");
+        } else if (res != -EINTR && res != -EAGAIN) {
+            throw std::runtime_error("send failed: " + std::string(strerror(-res)));
+        }
+    }
+    return true;
+}
+
+bool IoUring::send_then_read(int sock, const void* out, size_t out_size, void* in, size_t in_size, int timeout_sec) {
+    struct __kernel_timespec ts;
+    int results[4] = {0, 0, 0, 0};
+
+    struct io_uring_sqe* send_sqe = get_sqe();
+    send_sqe->opcode = IORING_OP_SEND;
+    send_sqe->fd = sock;
+    send_sqe->addr = reinterpret_cast<uint64_t>(out);
+    send_sqe->len = static_cast<uint32_t>(out_size);
+    send_sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    send_sqe->user_data = TAG_SEND;
+
+    prepare_with_timeout(IORING_OP_RECV, sock, in, in_size, MSG_WAITALL, timeout_sec, TAG_TRANSFER, &ts);
+    submit_and_wait(3, results, 4);
+
+    int sent = results[TAG_SEND];
+    if (sent < 0 && sent != -EINTR && sent != -EAGAIN) {
+        throw std::runtime_error("send failed: " + std::string(strerror(-sent)));
+    }
+    size_t sent_bytes = sent > 0 ? static_cast<size_t>(sent) : 0;
+    if (sent_bytes < out_size) {
+        send_exact(sock, static_cast<const char*>(out) + sent_bytes, out_size - sent_bytes, timeout_sec);
+    }
+
+    int received = results[TAG_TRANSFER];
+    if (received == 0) {
+        throw std::runtime_error("Connection closed by client during read");
+    } else if (is_timeout(received)) {
+        throw std::runtime_error("Data reading timeout (possible type mismatch: client sends int32_t instead of double)");
+    } else if (received < 0 && received != -EINTR && received != -EAGAIN) {
+        throw std::runtime_error("recv failed: " + std::string(strerror(-received)));
+    }
+    size_t received_bytes = received > 0 ? static_cast<size_t>(received) : 0;
+    if (received_bytes < in_size) {
+        read_exact(sock, static_cast<char*>(in) + received_bytes, in_size - received_bytes, timeout_sec);
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+#ifndef IOURING_H
+#define IOURING_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+//! \brief Минимальное кольцо io_uring для блокирующих сессий
+//! \details Обёртка над системными вызовами io_uring_setup/io_uring_enter без liburing.
+//! Каждая операция чтения или записи отправляется вместе со связанным таймаутом
+//! (IORING_OP_LINK_TIMEOUT), поэтому ожидание и передача данных укладываются
+//! в один вызов io_uring_enter вместо пары select() + recv()/send().
+//! Кольцо принадлежит одному потоку (см. for_current_thread()).
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class IoUring {
+private:
+    static constexpr unsigned RING_ENTRIES = 8; //!< Размер очереди отправки
+
+    int ring_fd;                  //!< Дескриптор кольца
+    void* sq_ring_ptr;            //!< Отображение кольца отправки
+    size_t sq_ring_size;          //!< Размер отображения кольца отправки
+    void* cq_ring_ptr;            //!< Отображение кольца завершений
+    size_t cq_ring_size;          //!< Размер отображения кольца завершений
+    io_uring_sqe* sqes;           //!< Массив элементов отправки
+    size_t sqes_size;             //!< Размер массива элементов отправки
+
+    unsigned* sq_head;            //!< Голова кольца отправки (пишет ядро)
+    unsigned* sq_tail;            //!< Хвост кольца отправки (пишет приложение)
+    unsigned* sq_mask;            //!< Маска кольца отправки
+    unsigned* sq_array;           //!< Индексы элементов отправки
+    unsigned* cq_head;            //!< Голова кольца завершений (пишет приложение)
+    unsigned* cq_tail;            //!< Хвост кольца завершений (пишет ядро)
+    unsigned* cq_mask;            //!< Маска кольца завершений
+    io_uring_cqe* cqes;           //!< Массив завершений
+    unsigned pending;             //!< Подготовлено, но не отправлено элементов
+
+    //! \brief Конструктор кольца
+    //! \throw std::runtime_error Если ядро не поддерживает io_uring
+    IoUring();
+
+    //! \brief Получить свободный элемент очереди отправки
+    //! \return Обнулённый элемент отправки
+    io_uring_sqe* get_sqe();
+
+    //! \brief Подготовить операцию со связанным таймаутом
+    //! \param[in] opcode Код операции (IORING_OP_RECV или IORING_OP_SEND)
+    //! \param[in] sock Сокет
+    //! \param[in] buffer Буфер данных
+    //! \param[in] size Размер буфера
+    //! \param[in] msg_flags Флаги recv/send
+    //! \param[in] timeout_sec Таймаут операции в секундах
+    //! \param[in] user_data Метка операции
+    //! \param[in] ts Хранилище таймаута (должно жить до завершения операции)
+    void prepare_with_timeout(uint8_t opcode, int sock, const void* buffer, size_t size,
+                              int msg_flags, int timeout_sec, uint64_t user_data, void* ts);
+
+    //! \brief Отправить подготовленные элементы и дождаться завершений
+    //! \param[in] wait_nr Количество ожидаемых завершений
+    //! \param[out] results Результаты по метке операции (индекс = user_data)
+    //! \param[in] results_size Размер массива результатов
+    void submit_and_wait(unsigned wait_nr, int* results, size_t results_size);
+
+    //! \brief Выполнить одну операцию со связанным таймаутом
+    //! \return Результат операции (байты или -errno)
+    int transfer(uint8_t opcode, int sock, const void* buffer, size_t size, int msg_flags, int timeout_sec);
+
+public:
+    //! \brief Деструктор, освобождает кольцо
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    //! \brief Проверить поддержку io_uring ядром
+    //! \return true если кольцо удалось создать
+    static bool is_supported();
+
+    //! \brief Получить кольцо текущего потока
+    //! \return Кольцо или nullptr, если io_uring недоступен
+    static IoUring* for_current_thread();
+
+    //! \brief Прочитать точное количество байт
+    //! \param[in] sock Сокет
+    //! \param[out] buffer Буфер
+    //! \param[in] size Количество байт
+    //! \param[in] timeout_sec Таймаут ожидания данных
+    //! \return true если успешно
+    //! \throw std::runtime_error При таймауте, закрытии соединения или ошибке recv
+    bool read_exact(int sock, void* buffer, size_t size, int timeout_sec);
+
+    //! \brief Прочитать доступные данные (не меньше одного байта)
+    //! \param[in] sock Сокет
+    //! \param[out] buffer Буфер
+    //! \param[in] size Размер буфера
+    //! \param[in] timeout_sec Таймаут ожидания данных
+    //! \return Количество прочитанных байт
+    //! \throw std::runtime_error При таймауте, закрытии соединения или ошибке recv
+    size_t read_some(int sock, void* buffer, size_t size, int timeout_sec);
+
+    //! \brief Отправить точное количество байт
+    //! \param[in] sock Сокет
+    //! \param[in] buffer Буфер
+    //! \param[in] size Количество байт
+    //! \param[in] timeout_sec Таймаут отправки
+    //! \return true если успешно
+    //! \throw std::runtime_error При таймауте или ошибке send
+    bool send_exact(int sock, const void* buffer, size_t size, int timeout_sec);
+
+    //! \brief Отправить данные и прочитать ответ одним вызовом io_uring_enter
+    //! \param[in] sock Сокет
+    //! \param[in] out Отправляемые данные
+    //! \param[in] out_size Размер отправляемых данных
+    //! \param[out] in Буфер приёма
+    //! \param[in] in_size Количество байт для приёма
+    //! \param[in] timeout_sec Таймаут ожидания данных
+    //! \return true если успешно
+    //! \throw std::runtime_error При таймауте, закрытии соединения или ошибке
+    bool send_then_read(int sock, const void* out, size_t out_size, void* in, size_t in_size, int timeout_sec);
+};
+
+#endif // IOURING_H
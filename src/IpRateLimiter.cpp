@@ -0,0 +1,186 @@
+/*! \file IpRateLimiter.cpp
+ *  \brief Реализация класса IpRateLimiter
+ *  \details Содержит GCRA, учёт неудачных входов и таблицу записей по IP адресам
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "IpRateLimiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+static_assert(IpRateLimiter::TABLE_SIZE == IpRateLimiter::WAYS << IpRateLimiter::SET_BITS,
+              "TABLE_SIZE must equal WAYS * 2^SET_BITS");
+
+namespace {
+
+constexpr int64_t NS_PER_SEC = 1000000000;
+constexpr int64_t NS_PER_MS = 1000000;
+
+} // namespace
+
+IpRateLimiter::IpRateLimiter(const IpLimits& limits)
+    : limits(limits), emission_ns(0), tolerance_ns(0), entries(new Entry[TABLE_SIZE]), blocked_ips(0) {
+    if (limits.rate > 0) {
+        emission_ns = NS_PER_SEC / limits.rate;
+        // Всплеск из burst подключений: последнее приходит на (burst - 1) интервалов раньше срока
+        tolerance_ns = emission_ns * (std::max(limits.burst, 1u) - 1);
+    }
+}
+
+int64_t IpRateLimiter::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool IpRateLimiter::is_reusable(const Entry& entry, int64_t now) {
+    if (entry.active.load(std::memory_order_relaxed) > 0 ||
+        entry.tat.load(std::memory_order_relaxed) > now ||
+        entry.delayed_until.load(std::memory_order_relaxed) > now ||
+        entry.blocked_until.load(std::memory_order_relaxed) > now) {
+        return false;
+    }
+    return entry.failures.load(std::memory_order_relaxed) == 0 ||
+           now - entry.last_seen.load(std::memory_order_relaxed) > IDLE_EXPIRY_SEC * NS_PER_SEC;
+}
+
+IpRateLimiter::Entry* IpRateLimiter::find(uint32_t ip, int64_t now, bool create) {
+    Entry* set = &entries[static_cast<size_t>((ip * 0x9E3779B1u) >> (32 - SET_BITS)) * WAYS];
+    for (size_t way = 0; way < WAYS; way++) {
+        if (set[way].ip.load(std::memory_order_acquire) == ip) {
+            set[way].last_seen.store(now, std::memory_order_relaxed);
+            return &set[way];
+        }
+    }
+    if (!create) {
+        return nullptr;
+    }
+    
+    for (size_t attempt = 0; attempt < WAYS; attempt++) {
+        Entry* victim = nullptr;
+        uint32_t victim_ip = 0;
+        int64_t oldest = std::numeric_limits<int64_t>::max();
+        for (size_t way = 0; way < WAYS; way++) {
+            uint32_t current = set[way].ip.load(std::memory_order_acquire);
+            if (current == 0) {
+                victim = &set[way];
+                victim_ip = 0;
+                break;
+            }
+            int64_t last_seen = set[way].last_seen.load(std::memory_order_relaxed);
+            if (last_seen < oldest && is_reusable(set[way], now)) {
+                victim = &set[way];
+                victim_ip = current;
+                oldest = last_seen;
+            }
+        }
+        if (!victim) {
+            return nullptr;
+        }
+        uint32_t expected = victim_ip;
+        if (victim->ip.compare_exchange_strong(expected, ip, std::memory_order_acq_rel)) {
+            victim->failures.store(0, std::memory_order_relaxed);
+            victim->tat.store(0, std::memory_order_relaxed);
+            victim->delayed_until.store(0, std::memory_order_relaxed);
+            victim->blocked_until.store(0, std::memory_order_relaxed);
+            victim->last_seen.store(now, std::memory_order_relaxed);
+            return victim;
+        }
+        if (expected == ip) {
+            return victim;
+        }
+    }
+    return nullptr;
+}
+
+IpVerdict IpRateLimiter::try_acquire(uint32_t ip) {
+    if (ip == 0) {
+        return IpVerdict::Allowed;
+    }
+    int64_t now = now_ns();
+    Entry* entry = find(ip, now, true);
+    if (!entry) {
+        return IpVerdict::Allowed;
+    }
+    if (entry->blocked_until.load(std::memory_order_relaxed) > now) {
+        return IpVerdict::Blocked;
+    }
+    if (entry->delayed_until.load(std::memory_order_relaxed) > now) {
+        return IpVerdict::RateLimited;
+    }
+    
+    if (emission_ns > 0) {
+        int64_t tat = entry->tat.load(std::memory_order_relaxed);
+        int64_t next;
+        do {
+            int64_t arrival = std::max(tat, now);
+            if (arrival - now > tolerance_ns) {
+                return IpVerdict::RateLimited;
+            }
+            next = arrival + emission_ns;
+        } while (!entry->tat.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+    }
+    
+    if (limits.max_sessions > 0) {
+        uint32_t active = entry->active.load(std::memory_order_relaxed);
+        do {
+            if (active >= limits.max_sessions) {
+                return IpVerdict::TooManySessions;
+            }
+        } while (!entry->active.compare_exchange_weak(active, active + 1, std::memory_order_relaxed));
+    }
+    return IpVerdict::Allowed;
+}
+
+void IpRateLimiter::release(uint32_t ip) {
+    if (ip == 0 || limits.max_sessions == 0) {
+        return;
+    }
+    Entry* entry = find(ip, now_ns(), false);
+    if (!entry) {
+        return;
+    }
+    uint32_t active = entry->active.load(std::memory_order_relaxed);
+    while (active > 0 && !entry->active.compare_exchange_weak(active, active - 1, std::memory_order_relaxed)) {
+    }
+}
+
+bool IpRateLimiter::record_auth(uint32_t ip, bool success) {
+    if (ip == 0 || limits.fail_limit == 0) {
+        return false;
+    }
+    int64_t now = now_ns();
+    Entry* entry = find(ip, now, !success);
+    if (!entry) {
+        return false;
+    }
+    if (success) {
+        entry->failures.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    
+    uint32_t failures = entry->failures.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (failures >= limits.fail_limit) {
+        entry->failures.store(0, std::memory_order_relaxed);
+        entry->blocked_until.store(now + int64_t(limits.block_sec) * NS_PER_SEC, std::memory_order_relaxed);
+        blocked_ips.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    unsigned shift = std::min(failures - 1, MAX_PENALTY_SHIFT);
+    entry->delayed_until.store(now + (int64_t(PENALTY_BASE_MS) * NS_PER_MS << shift), std::memory_order_relaxed);
+    return false;
+}
+
+uint32_t IpRateLimiter::parse_ip(const std::string& ip) {
+    struct in_addr addr;
+    if (inet_pton(AF_INET, ip.c_str(), &addr) != 1) {
+        return 0;
+    }
+    return addr.s_addr;
+}
@@ -0,0 +1,128 @@
+#ifndef IPRATELIMITER_H
+#define IPRATELIMITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//! \brief Ограничения подключений с одного IP адреса
+struct IpLimits {
+    unsigned rate = 0;          //!< Подключений в секунду с IP (0 - без ограничения)
+    unsigned burst = 20;        //!< Подключений подряд без ожидания при ограниченном темпе
+    unsigned max_sessions = 0;  //!< Одновременных сессий с IP (0 - без ограничения)
+    unsigned fail_limit = 0;    //!< Неудачных входов подряд до блокировки IP (0 - без учёта неудач)
+    unsigned block_sec = 60;    //!< Срок блокировки IP, с
+
+    //! \brief Проверить, включено ли хотя бы одно ограничение
+    //! \return true если ограничитель нужен
+    bool enabled() const { return rate > 0 || max_sessions > 0 || fail_limit > 0; }
+};
+
+//! \brief Решение ограничителя по новому подключению
+enum class IpVerdict {
+    Allowed,         //!< Подключение допущено
+    RateLimited,     //!< Превышен темп подключений или действует задержка после неудачного входа
+    TooManySessions, //!< Достигнут предел одновременных сессий с IP
+    Blocked          //!< IP заблокирован после серии неудачных входов
+};
+
+//! \brief Ограничитель подключений по IP адресу клиента
+//! \details Темп подключений ограничивается алгоритмом GCRA (эквивалент
+//! корзины маркеров): состояние корзины - одно 64-битное "теоретическое время
+//! прибытия", которое меняется одной операцией CAS. Каждая неудачная
+//! аутентификация запрещает подключения с IP на задержку, удваивающуюся с каждой
+//! неудачей подряд (до MAX_PENALTY_SHIFT удвоений), поэтому перебор паролей
+//! замедляется, не занимая потоков сервера: преждевременные подключения сразу
+//! получают "ERR". После fail_limit неудач подряд IP блокируется на block_sec.
+//! Записи хранятся в таблице фиксированного размера из наборов по WAYS записей
+//! (набор выбирается хешем адреса). Запись без сессий и действующих запретов
+//! занимается другим адресом; счётчик неудач забывается через IDLE_EXPIRY_SEC.
+//! Если весь набор занят, новый адрес допускается без учёта. Все методы
+//! не блокируют; при гонках за одну запись учёт приблизительный.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class IpRateLimiter {
+public:
+    static constexpr size_t TABLE_SIZE = 16384;         //!< Записей в таблице
+    static constexpr size_t WAYS = 4;                   //!< Записей в наборе
+    static constexpr unsigned SET_BITS = 12;            //!< log2 количества наборов
+    static constexpr unsigned PENALTY_BASE_MS = 250;    //!< Задержка после первой неудачи, мс
+    static constexpr unsigned MAX_PENALTY_SHIFT = 5;    //!< Наибольшее число удвоений задержки
+    static constexpr unsigned IDLE_EXPIRY_SEC = 600;    //!< Простой, после которого забываются неудачи
+
+private:
+    //! \brief Состояние одного IP адреса
+    struct alignas(64) Entry {
+        std::atomic<uint32_t> ip{0};             //!< Адрес (сетевой порядок, 0 - свободна)
+        std::atomic<uint32_t> active{0};         //!< Одновременных сессий
+        std::atomic<uint32_t> failures{0};       //!< Неудачных входов подряд
+        std::atomic<int64_t> tat{0};             //!< Теоретическое время прибытия GCRA, нс
+        std::atomic<int64_t> delayed_until{0};   //!< Конец задержки после неудачного входа, нс
+        std::atomic<int64_t> blocked_until{0};   //!< Конец блокировки, нс
+        std::atomic<int64_t> last_seen{0};       //!< Последнее обращение, нс
+    };
+
+    IpLimits limits;                        //!< Ограничения
+    int64_t emission_ns;                    //!< Интервал между подключениями при темпе rate, нс
+    int64_t tolerance_ns;                   //!< Допуск всплеска, нс
+    std::unique_ptr<Entry[]> entries;       //!< Таблица записей
+    std::atomic<uint64_t> blocked_ips;      //!< Заблокировано адресов за время работы
+
+    //! \brief Найти запись адреса
+    //! \param[in] ip Адрес
+    //! \param[in] now Текущее время, нс
+    //! \param[in] create Занять запись, если адреса нет в таблице
+    //! \return Запись или nullptr (адреса нет или набор занят активными адресами)
+    Entry* find(uint32_t ip, int64_t now, bool create);
+
+    //! \brief Проверить, можно ли отдать запись другому адресу
+    //! \param[in] entry Запись
+    //! \param[in] now Текущее время, нс
+    //! \return true если запись не хранит действующих ограничений
+    static bool is_reusable(const Entry& entry, int64_t now);
+
+    //! \brief Текущее время монотонных часов, нс
+    static int64_t now_ns();
+
+public:
+    //! \brief Конструктор
+    //! \param[in] limits Ограничения
+    explicit IpRateLimiter(const IpLimits& limits);
+
+    IpRateLimiter(const IpRateLimiter&) = delete;
+    IpRateLimiter& operator=(const IpRateLimiter&) = delete;
+
+    //! \brief Решить, допустить ли подключение
+    //! \details При Allowed и max_sessions > 0 по завершении сессии нужно вызвать release()
+    //! \param[in] ip Адрес клиента (сетевой порядок)
+    //! \return Решение
+    IpVerdict try_acquire(uint32_t ip);
+
+    //! \brief Отметить завершение сессии, допущенной try_acquire()
+    //! \param[in] ip Адрес клиента (сетевой порядок)
+    void release(uint32_t ip);
+
+    //! \brief Учесть результат аутентификации
+    //! \param[in] ip Адрес клиента (сетевой порядок)
+    //! \param[in] success true при успешном входе
+    //! \return true если адрес только что заблокирован
+    bool record_auth(uint32_t ip, bool success);
+
+    //! \brief Получить ограничения
+    //! \return Ограничения
+    const IpLimits& get_limits() const { return limits; }
+
+    //! \brief Получить количество блокировок адресов
+    //! \return Количество блокировок
+    uint64_t blocked_count() const { return blocked_ips.load(std::memory_order_relaxed); }
+
+    //! \brief Разобрать IPv4 адрес
+    //! \param[in] ip Адрес в точечной записи
+    //! \return Адрес (сетевой порядок) или 0 при ошибке
+    static uint32_t parse_ip(const std::string& ip);
+};
+
+#endif // IPRATELIMITER_H
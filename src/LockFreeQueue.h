@@ -0,0 +1,111 @@
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+//! \brief Ограниченная неблокирующая очередь MPMC
+//! \details Кольцевой буфер с порядковыми номерами ячеек (схема Вьюкова).
+//! Несколько потоков могут одновременно добавлять и извлекать элементы
+//! без мьютексов; при заполнении push() возвращает false.
+//! \tparam T Тип элемента (должен быть перемещаемым и конструируемым по умолчанию)
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+template <typename T>
+class LockFreeQueue {
+private:
+    //! \brief Ячейка кольцевого буфера
+    struct Cell {
+        std::atomic<size_t> sequence; //!< Порядковый номер ячейки
+        T value;                      //!< Хранимое значение
+    };
+
+    static constexpr size_t CACHE_LINE = 64; //!< Размер строки кэша
+
+    std::unique_ptr<Cell[]> buffer;                  //!< Кольцевой буфер
+    size_t mask;                                     //!< Маска индекса (ёмкость - 1)
+    alignas(CACHE_LINE) std::atomic<size_t> head;    //!< Позиция записи
+    alignas(CACHE_LINE) std::atomic<size_t> tail;    //!< Позиция чтения
+
+public:
+    //! \brief Конструктор очереди
+    //! \param[in] capacity Ёмкость очереди (степень двойки, не меньше 2)
+    //! \throw std::invalid_argument Если ёмкость не является степенью двойки
+    explicit LockFreeQueue(size_t capacity)
+        : buffer(new Cell[capacity]), mask(capacity - 1), head(0), tail(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("Queue capacity must be a power of two");
+        }
+        for (size_t i = 0; i < capacity; i++) {
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    //! \brief Добавить элемент в очередь
+    //! \param[in] value Добавляемое значение
+    //! \return true если элемент добавлен, false если очередь заполнена
+    bool push(const T& value) {
+        T copy(value);
+        return push(std::move(copy));
+    }
+
+    //! \brief Добавить элемент в очередь перемещением
+    //! \param[in] value Добавляемое значение (не изменяется, если очередь заполнена)
+    //! \return true если элемент добавлен, false если очередь заполнена
+    bool push(T&& value) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = buffer[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //! \brief Извлечь элемент из очереди
+    //! \param[out] value Извлечённое значение
+    //! \return true если элемент извлечён, false если очередь пуста
+    bool pop(T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = buffer[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //! \brief Получить ёмкость очереди
+    //! \return Максимальное количество элементов
+    size_t capacity() const { return mask + 1; }
+};
+
+#endif // LOCKFREEQUEUE_H
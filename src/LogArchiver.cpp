@@ -0,0 +1,208 @@
+/*! \file LogArchiver.cpp
+ *  \brief Реализация класса LogArchiver
+ *  \details Содержит фоновое сжатие ротированных файлов журнала и удаление старых
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "LogArchiver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <tuple>
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cryptopp/files.h>
+#include <cryptopp/gzip.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t STAMP_SIZE = 15; //!< Длина метки времени ГГГГММДД-ЧЧММСС
+constexpr const char* TEMP_SUFFIX = ".tmp"; //!< Суффикс недописанного сжатого файла
+constexpr int LOWEST_PRIORITY = 19;         //!< Значение nice фонового потока
+
+//! \brief Разобранное имя ротированного файла
+struct SegmentName {
+    std::string stamp;  //!< Метка времени
+    unsigned index;     //!< Номер ротации в пределах секунды
+    std::string path;   //!< Путь файла
+};
+
+//! \brief Проверить, что символы строки - цифры
+bool all_digits(const std::string& text, size_t from, size_t count) {
+    if (from + count > text.size() || count == 0) {
+        return false;
+    }
+    return std::all_of(text.begin() + from, text.begin() + from + count,
+                       [](unsigned char c) { return std::isdigit(c) != 0; });
+}
+
+//! \brief Разобрать суффикс имени после "<журнал>."
+//! \return true если это ротированный файл
+bool parse_segment(std::string suffix, SegmentName& name) {
+    const std::string compressed = LogArchiver::COMPRESSED_SUFFIX;
+    if (suffix.size() > compressed.size() &&
+        suffix.compare(suffix.size() - compressed.size(), compressed.size(), compressed) == 0) {
+        suffix.resize(suffix.size() - compressed.size());
+    }
+    if (!all_digits(suffix, 0, 8) || suffix.size() < STAMP_SIZE || suffix[8] != '-' ||
+        !all_digits(suffix, 9, 6)) {
+        return false;
+    }
+    name.stamp = suffix.substr(0, STAMP_SIZE);
+    name.index = 0;
+    if (suffix.size() == STAMP_SIZE) {
+        return true;
+    }
+    if (suffix[STAMP_SIZE] != '-' || !all_digits(suffix, STAMP_SIZE + 1, suffix.size() - STAMP_SIZE - 1) ||
+        suffix.size() - STAMP_SIZE - 1 > 9) {
+        return false;
+    }
+    name.index = static_cast<unsigned>(std::stoul(suffix.substr(STAMP_SIZE + 1)));
+    return true;
+}
+
+} // namespace
+
+LogArchiver::LogArchiver(const std::string& log_path, unsigned keep_segments, bool compress)
+    : log_path(log_path), keep_segments(keep_segments), compress(compress), stopping(false),
+      compressed(0), removed(0) {
+    worker = std::thread(&LogArchiver::archive_loop, this);
+}
+
+LogArchiver::~LogArchiver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::string LogArchiver::next_segment_path() const {
+    std::time_t now = std::time(nullptr);
+    struct tm local_time;
+    localtime_r(&now, &local_time);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local_time);
+
+    std::string base = log_path + "." + stamp;
+    std::string path = base;
+    for (unsigned index = 1; fs::exists(path) || fs::exists(path + COMPRESSED_SUFFIX); index++) {
+        path = base + "-" + std::to_string(index);
+    }
+    return path;
+}
+
+void LogArchiver::submit(const std::string& segment_path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(segment_path);
+    }
+    work_ready.notify_one();
+}
+
+std::vector<std::string> LogArchiver::list_segments() const {
+    fs::path log(log_path);
+    fs::path dir = log.has_parent_path() ? log.parent_path() : fs::path(".");
+    std::string prefix = log.filename().string() + ".";
+
+    std::vector<SegmentName> names;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        std::string filename = entry.path().filename().string();
+        SegmentName name;
+        if (filename.size() > prefix.size() && filename.compare(0, prefix.size(), prefix) == 0 &&
+            parse_segment(filename.substr(prefix.size()), name)) {
+            name.path = (log.has_parent_path() ? entry.path() : fs::path(filename)).string();
+            names.push_back(std::move(name));
+        }
+    }
+    std::sort(names.begin(), names.end(), [](const SegmentName& a, const SegmentName& b) {
+        return std::tie(a.stamp, a.index) < std::tie(b.stamp, b.index);
+    });
+
+    std::vector<std::string> result;
+    result.reserve(names.size());
+    for (auto& name : names) {
+        result.push_back(std::move(name.path));
+    }
+    return result;
+}
+
+std::string LogArchiver::compress_file(const std::string& path) {
+    std::string target = path + COMPRESSED_SUFFIX;
+    std::string temp = target + TEMP_SUFFIX;
+    try {
+        // FileSource читает файл порциями - память не зависит от размера журнала
+        CryptoPP::FileSource source(path.c_str(), true,
+                                    new CryptoPP::Gzip(new CryptoPP::FileSink(temp.c_str())));
+    } catch (const std::exception& e) {
+        std::error_code ec;
+        fs::remove(temp, ec);
+        throw std::runtime_error("Cannot compress log segment " + path + ": " + e.what());
+    }
+    std::error_code ec;
+    fs::rename(temp, target, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        throw std::runtime_error("Cannot rename compressed log segment " + temp + ": " + ec.message());
+    }
+    fs::remove(path, ec);
+    return target;
+}
+
+void LogArchiver::enforce_retention() {
+    if (keep_segments == 0) {
+        return;
+    }
+    std::vector<std::string> segments = list_segments();
+    for (size_t i = 0; i + keep_segments < segments.size(); i++) {
+        std::error_code ec;
+        if (fs::remove(segments[i], ec)) {
+            removed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void LogArchiver::archive_loop() {
+    // Сжатие не должно отнимать процессор у сессий, но и не должно стоять совсем:
+    // при nice 19 поток получает малую долю процессора даже под полной нагрузкой
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), LOWEST_PRIORITY);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        work_ready.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;
+        }
+        std::string segment = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+
+        // Файл мог быть удалён как старый, пока ждал в очереди
+        if (compress && fs::exists(segment)) {
+            try {
+                compress_file(segment);
+                compressed.fetch_add(1, std::memory_order_relaxed);
+            } catch (const std::exception& e) {
+                std::cerr << "Log rotation: " << e.what() << std::endl;
+            }
+        }
+        enforce_retention();
+
+        lock.lock();
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef LOGARCHIVER_H
+#define LOGARCHIVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! \brief Обслуживание ротированных файлов журнала
+//! \details Поток записи журнала только переименовывает заполненный файл и
+//! передаёт его имя в submit(). Фоновый поток с наименьшим приоритетом (nice 19)
+//! сжимает файл в gzip (сначала во временный файл, затем атомарное
+//! переименование в ".gz" и удаление исходного) и удаляет самые старые файлы
+//! сверх keep_segments - в том числе ещё не сжатые, если поток отстал.
+//! Файлы называются "<журнал>.ГГГГММДД-ЧЧММСС" с суффиксом "-N" при нескольких
+//! ротациях за секунду и ".gz" после сжатия.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class LogArchiver {
+public:
+    static constexpr const char* COMPRESSED_SUFFIX = ".gz"; //!< Суффикс сжатого файла
+
+private:
+    std::string log_path;             //!< Путь текущего файла журнала
+    unsigned keep_segments;           //!< Хранимых ротированных файлов (0 - все)
+    bool compress;                    //!< Сжимать ротированные файлы
+
+    std::mutex mutex;                      //!< Защита очереди
+    std::condition_variable work_ready;    //!< Новый файл или остановка
+    std::deque<std::string> pending;       //!< Файлы, ожидающие обслуживания
+    bool stopping;                         //!< Флаг остановки фонового потока
+    std::atomic<uint64_t> compressed;      //!< Сжато файлов
+    std::atomic<uint64_t> removed;         //!< Удалено старых файлов
+    std::thread worker;                    //!< Фоновый поток
+
+    //! \brief Цикл фонового потока
+    void archive_loop();
+
+    //! \brief Удалить самые старые файлы сверх keep_segments
+    void enforce_retention();
+
+public:
+    //! \brief Конструктор, запускает фоновый поток
+    //! \param[in] log_path Путь файла журнала
+    //! \param[in] keep_segments Хранимых ротированных файлов (0 - все)
+    //! \param[in] compress Сжимать ротированные файлы
+    LogArchiver(const std::string& log_path, unsigned keep_segments, bool compress);
+
+    //! \brief Деструктор, обслуживает оставшиеся файлы и останавливает поток
+    ~LogArchiver();
+
+    LogArchiver(const LogArchiver&) = delete;
+    LogArchiver& operator=(const LogArchiver&) = delete;
+
+    //! \brief Выбрать имя для ротируемого файла
+    //! \details Имя по текущему времени; занятые имена пропускаются
+    //! \return Путь, в который переименовать файл журнала
+    std::string next_segment_path() const;
+
+    //! \brief Передать ротированный файл фоновому потоку
+    //! \details Не ждёт сжатия
+    //! \param[in] segment_path Путь ротированного файла
+    void submit(const std::string& segment_path);
+
+    //! \brief Получить ротированные файлы журнала, от старых к новым
+    //! \return Пути файлов (сжатых и несжатых)
+    std::vector<std::string> list_segments() const;
+
+    //! \brief Получить количество сжатых файлов
+    //! \return Количество
+    uint64_t get_compressed() const { return compressed.load(std::memory_order_relaxed); }
+
+    //! \brief Получить количество удалённых старых файлов
+    //! \return Количество
+    uint64_t get_removed() const { return removed.load(std::memory_order_relaxed); }
+
+    //! \brief Сжать файл в gzip и удалить исходный
+    //! \param[in] path Путь файла
+    //! \return Путь сжатого файла
+    //! \throw std::runtime_error При ошибке чтения или записи (исходный файл сохраняется)
+    static std::string compress_file(const std::string& path);
+};
+
+#endif // LOGARCHIVER_H
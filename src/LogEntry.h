@@ -0,0 +1,97 @@
+#ifndef LOGENTRY_H
+#define LOGENTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+//! \brief Запись очереди журнала со встроенным буфером
+//! \details Короткие записи (двоичные события и обычные строки журнала) хранятся
+//! во встроенном буфере: построение записи и её перемещение в очередь и из
+//! очереди - копирование байт без обращения к куче. Запись длиннее
+//! INLINE_CAPACITY переносится в std::string целиком.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class LogEntry {
+public:
+    static constexpr size_t INLINE_CAPACITY = 88; //!< Размер встроенного буфера (вся запись - 128 байт)
+
+private:
+    uint32_t length = 0;                 //!< Байт во встроенном буфере
+    bool spilled = false;                //!< Запись перенесена в spill
+    char inline_bytes[INLINE_CAPACITY];  //!< Встроенный буфер
+    std::string spill;                   //!< Длинная запись
+
+    //! \brief Скопировать состояние другой записи, забрав её строку
+    void take(LogEntry& other) {
+        length = other.length;
+        spilled = other.spilled;
+        if (!spilled) {
+            memcpy(inline_bytes, other.inline_bytes, length);
+        }
+        spill = std::move(other.spill);
+        other.length = 0;
+        other.spilled = false;
+    }
+
+public:
+    LogEntry() = default;
+
+    //! \brief Запись из готовой строки
+    //! \param[in] text Строка (перемещается, если не помещается во встроенный буфер)
+    explicit LogEntry(std::string&& text) {
+        if (text.size() <= INLINE_CAPACITY) {
+            memcpy(inline_bytes, text.data(), text.size());
+            length = static_cast<uint32_t>(text.size());
+        } else {
+            spill = std::move(text);
+            spilled = true;
+        }
+    }
+
+    LogEntry(LogEntry&& other) noexcept { take(other); }
+
+    LogEntry& operator=(LogEntry&& other) noexcept {
+        if (this != &other) {
+            take(other);
+        }
+        return *this;
+    }
+
+    LogEntry(const LogEntry&) = delete;
+    LogEntry& operator=(const LogEntry&) = delete;
+
+    //! \brief Дописать байты
+    //! \param[in] bytes Байты
+    //! \param[in] count Количество байт
+    void append(const void* bytes, size_t count) {
+        if (!spilled && length + count <= INLINE_CAPACITY) {
+            memcpy(inline_bytes + length, bytes, count);
+            length += static_cast<uint32_t>(count);
+            return;
+        }
+        if (!spilled) {
+            spill.assign(inline_bytes, length);
+            spilled = true;
+        }
+        spill.append(static_cast<const char*>(bytes), count);
+    }
+
+    //! \brief Получить байты записи
+    char* data() { return spilled ? spill.data() : inline_bytes; }
+
+    //! \brief Получить байты записи
+    const char* data() const { return spilled ? spill.data() : inline_bytes; }
+
+    //! \brief Получить длину записи
+    size_t size() const { return spilled ? spill.size() : length; }
+
+    //! \brief Проверить, хранится ли запись в куче
+    //! \return true если запись длиннее INLINE_CAPACITY
+    bool is_spilled() const { return spilled; }
+};
+
+#endif // LOGENTRY_H
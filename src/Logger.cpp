@@ -8,64 +8,326 @@
 
 #include "Logger.h"
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 #include <ctime>
 #include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+//! \brief Режим открытия файла журнала
+std::ios::openmode file_mode(bool binary) {
+    return binary ? std::ios::app | std::ios::binary : std::ios::app;
+}
+
+} // namespace
 
 std::string Logger::get_current_time() {
+    // localtime_r и strftime дороже самой записи в очередь - форматируем раз в секунду
+    thread_local std::time_t cached_second = 0;
+    thread_local char buffer[80] = {0};
     std::time_t now = std::time(nullptr);
-    char buffer[80];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+    if (now != cached_second) {
+        struct tm local_time;
+        localtime_r(&now, &local_time);
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_time);
+        cached_second = now;
+    }
     return std::string(buffer);
 }
 
-Logger::Logger(const std::string& filename) {
-    log_file.open(filename, std::ios::app);
+Logger::Logger(const std::string& filename, const LoggerOptions& options)
+    : options(options), filename(filename), file_bytes(0), file_opened(std::chrono::steady_clock::now()),
+      rotations(0), flush_requested(false), stopping(false), enqueued(0), written(0), dropped(0),
+      level(static_cast<int>(options.level)) {
+    log_file.open(filename, file_mode(is_binary()));
     if (!log_file.is_open()) {
         throw std::runtime_error("Cannot open log file: " + filename);
     }
-    log("=== Server started ===");
+    if (options.rotation_enabled()) {
+        std::error_code ec;
+        file_bytes = fs::file_size(filename, ec);
+        if (ec) {
+            file_bytes = 0;
+        }
+        archiver = std::make_unique<LogArchiver>(filename, options.keep_segments, options.compress_segments);
+    }
+    if (options.async) {
+        queue = std::make_unique<LockFreeQueue<LogEntry>>(options.queue_capacity);
+        writer = std::thread(&Logger::writer_loop, this);
+    }
+    if (is_binary()) {
+        // Каждый сеанс записи начинается с привязки тиков к настенному времени
+        write_entry(BinaryLogRecord::session());
+    }
+    write(LogEvent::Message, "=== Server started ===");
 }
 
 Logger::~Logger() {
     if (log_file.is_open()) {
-        log("=== Server stopped ===");
+        write(LogEvent::Message, "=== Server stopped ===");
+    }
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex);
+            stopping = true;
+        }
+        writer_wakeup.notify_one();
+        writer.join();
+    }
+    if (log_file.is_open()) {
         log_file.close();
     }
 }
 
 void Logger::log(const std::string& message) {
-    std::string entry = "[" + get_current_time() + "] " + message;
-    std::cout << entry << std::endl;
-    
-    if (log_file.is_open()) {
-        log_file << entry << std::endl;
-        log_file.flush();
+    if (is_enabled(LogLevel::Info)) {
+        write(LogEvent::Message, message);
+    }
+}
+
+LogLevel Logger::adjust_level(int delta) {
+    int current = level.load(std::memory_order_relaxed);
+    int next;
+    do {
+        next = std::clamp(current + delta, static_cast<int>(LogLevel::Debug), static_cast<int>(LogLevel::Error));
+    } while (!level.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    return static_cast<LogLevel>(next);
+}
+
+void Logger::write(LogEvent event, const std::string& message) {
+    if (is_binary()) {
+        write_entry(BinaryLogRecord(event).add(message).finish());
+        return;
     }
+    const char* prefix = event == LogEvent::Error ? "ERROR: " : event == LogEvent::Debug ? "DEBUG: " : "";
+    write_entry(LogEntry("[" + get_current_time() + "] " + prefix + message));
 }
 
-void Logger::log_auth(const std::string& ip, const std::string& login, 
+void Logger::write_entry(LogEntry&& entry) {
+    if (queue) {
+        enqueue(std::move(entry));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (!is_binary()) {
+        std::cout.write(entry.data(), static_cast<std::streamsize>(entry.size())) << std::endl;
+        entry.append("\n", 1);
+    }
+    write_file(entry.data(), entry.size());
+}
+
+void Logger::write_file(const char* data, size_t size) {
+    if (rotation_due(size)) {
+        rotate();
+    }
+    if (!log_file.is_open()) {
+        return;
+    }
+    log_file.write(data, static_cast<std::streamsize>(size));
+    log_file.flush();
+    file_bytes += size;
+}
+
+bool Logger::rotation_due(size_t incoming) const {
+    if (!archiver || file_bytes == 0) {
+        return false;
+    }
+    if (options.rotate_bytes > 0 && file_bytes + incoming > options.rotate_bytes) {
+        return true;
+    }
+    return options.rotate_interval_sec > 0 &&
+           std::chrono::steady_clock::now() - file_opened >= std::chrono::seconds(options.rotate_interval_sec);
+}
+
+void Logger::rotate() {
+    // Переименование и открытие - операции над каталогом; сжатие файла выполняет archiver
+    std::string segment = archiver->next_segment_path();
+    log_file.close();
+    std::error_code ec;
+    fs::rename(filename, segment, ec);
+    log_file.open(filename, file_mode(is_binary()));
+    file_opened = std::chrono::steady_clock::now();
+    file_bytes = 0;
+    if (ec) {
+        // Продолжаем прежний файл; следующая попытка - через rotate_bytes или rotate_interval_sec
+        std::cerr << "Log rotation failed: " << ec.message() << std::endl;
+        return;
+    }
+    rotations.fetch_add(1, std::memory_order_relaxed);
+    archiver->submit(segment);
+    if (is_binary() && log_file.is_open()) {
+        // Каждый файл читается logdecode отдельно - начинаем его с записи сеанса
+        LogEntry session = BinaryLogRecord::session();
+        log_file.write(session.data(), static_cast<std::streamsize>(session.size()));
+        file_bytes = session.size();
+    }
+}
+
+void Logger::enqueue(LogEntry&& entry) {
+    while (!queue->push(std::move(entry))) {
+        if (options.overflow != LogOverflow::Block) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Очередь полна: поток записи спит до конца интервала - будим его
+        wake_writer();
+        std::this_thread::yield();
+    }
+    enqueued.fetch_add(1, std::memory_order_release);
+}
+
+void Logger::wake_writer() {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        flush_requested = true;
+    }
+    writer_wakeup.notify_one();
+}
+
+void Logger::write_batch(std::string& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    if (!is_binary()) {
+        std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        std::cout.flush();
+    }
+    write_file(batch.data(), batch.size());
+    batch.clear();
+}
+
+void Logger::writer_loop() {
+    std::string batch;
+    batch.reserve(BATCH_SIZE + 1024);
+    LogEntry entry;
+    uint64_t reported_drops = 0;
+
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    for (;;) {
+        writer_wakeup.wait_for(lock, std::chrono::milliseconds(options.flush_interval_ms),
+                               [this]() { return stopping || flush_requested; });
+        bool stop = stopping;
+        flush_requested = false;
+        lock.unlock();
+
+        uint64_t count = 0;
+        while (queue->pop(entry)) {
+            batch.append(entry.data(), entry.size());
+            if (!is_binary()) {
+                batch += '\n';
+            }
+            count++;
+            if (batch.size() >= BATCH_SIZE) {
+                write_batch(batch);
+            }
+        }
+        if (options.overflow == LogOverflow::Count) {
+            uint64_t drops = dropped.load(std::memory_order_relaxed);
+            if (drops != reported_drops) {
+                std::string notice = "WARNING: " + std::to_string(drops - reported_drops) +
+                                     " log records dropped (queue full)";
+                if (is_binary()) {
+                    LogEntry record = BinaryLogRecord(LogEvent::Message).add(notice).finish();
+                    batch.append(record.data(), record.size());
+                } else {
+                    batch += "[" + get_current_time() + "] " + notice + "\n";
+                }
+                reported_drops = drops;
+            }
+        }
+        write_batch(batch);
+
+        lock.lock();
+        written.fetch_add(count, std::memory_order_release);
+        written_cv.notify_all();
+        if (stop) {
+            return;
+        }
+    }
+}
+
+void Logger::flush() {
+    if (!queue) {
+        return;
+    }
+    uint64_t target = enqueued.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    flush_requested = true;
+    writer_wakeup.notify_one();
+    written_cv.wait(lock, [this, target]() {
+        return stopping || written.load(std::memory_order_acquire) >= target;
+    });
+}
+
+void Logger::log_auth(const std::string& ip, const std::string& login,
                       bool success, const std::string& details) {
+    if (!is_enabled(success ? LogLevel::Info : LogLevel::Warning)) {
+        return;
+    }
+    if (is_binary()) {
+        write_entry(BinaryLogRecord(LogEvent::Auth)
+                        .add_ip(ip).add(login).add_flag(success).add(details).finish());
+        return;
+    }
     std::string status = success ? "SUCCESS" : "FAILED";
     std::string msg = "AUTH [" + ip + "] user '" + login + "' : " + status;
     if (!details.empty()) {
         msg += " (" + details + ")";
     }
-    log(msg);
+    write(LogEvent::Message, msg);
 }
 
 void Logger::log_connection(const std::string& ip, bool connected) {
-    std::string action = connected ? "connected" : "disconnected";
-    log("CLIENT [" + ip + "] " + action);
+    if (!is_enabled(LogLevel::Info)) {
+        return;
+    }
+    if (is_binary()) {
+        write_entry(BinaryLogRecord(LogEvent::Connection).add_ip(ip).add_flag(connected).finish());
+        return;
+    }
+    write(LogEvent::Message, "CLIENT [" + ip + "] " + (connected ? "connected" : "disconnected"));
 }
 
 void Logger::log_data(const std::string& ip, const std::string& operation) {
-    log("DATA [" + ip + "] " + operation);
+    if (!is_enabled(LogLevel::Info)) {
+        return;
+    }
+    if (is_binary()) {
+        write_entry(BinaryLogRecord(LogEvent::Data).add_ip(ip).add(operation).finish());
+        return;
+    }
+    write(LogEvent::Message, "DATA [" + ip + "] " + operation);
+}
+
+void Logger::log_batch(LogEvent event, const std::string& ip, uint32_t count) {
+    if (!is_enabled(LogLevel::Info)) {
+        return;
+    }
+    if (is_binary()) {
+        BinaryLogRecord record(event);
+        record.add_ip(ip);
+        if (event != LogEvent::BatchStarted) {
+            record.add_count(count);
+        }
+        write_entry(record.finish());
+        return;
+    }
+    write(LogEvent::Message, "DATA [" + ip + "] " + BinaryLogDecoder::describe_batch(event, count));
 }
 
 void Logger::log_error(const std::string& error) {
-    log("ERROR: " + error);
+    if (is_enabled(LogLevel::Error)) {
+        write(LogEvent::Error, error);
+    }
 }
 
 void Logger::log_debug(const std::string& msg) {
-    log("DEBUG: " + msg);
+    if (is_enabled(LogLevel::Debug)) {
+        write(LogEvent::Debug, msg);
+    }
 }
@@ -1,56 +1,275 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "BinaryLog.h"
+#include "LockFreeQueue.h"
+#include "LogArchiver.h"
+
+//! \brief Наименьший уровень, вкомпилированный в макросы LOG_* (0 - Debug ... 3 - Error)
+//! \details Задаётся при сборке: make LOG_MIN_LEVEL=1 убирает отладочные вызовы из кода
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+
+//! \brief Уровень важности записи журнала
+enum class LogLevel : int {
+    Debug = 0,    //!< Подробности протокола, по строке на пакет и вектор
+    Info = 1,     //!< Подключения, аутентификация, обработка пакетов
+    Warning = 2,  //!< Неудачные входы
+    Error = 3,    //!< Ошибки
+    Off = 4       //!< Журнал выключен
+};
+
+//! \brief Записать через метод call, если уровень level включён
+//! \details Аргументы call не вычисляются, если уровень ниже LOGGER_MIN_LEVEL
+//! (ветка удаляется компилятором) или ниже текущего уровня логгера
+#define LOGGER_CALL(logger, level, call)                                  \
+    do {                                                                  \
+        if (Logger::is_compiled(level) && (logger).is_enabled(level)) {   \
+            (logger).call;                                                \
+        }                                                                 \
+    } while (0)
+
+//! \brief Отладочное сообщение без затрат при выключенном уровне Debug
+#define LOG_DEBUG(logger, message) LOGGER_CALL(logger, LogLevel::Debug, log_debug(message))
+//! \brief Событие обработки данных без затрат при выключенном уровне Info
+#define LOG_DATA(logger, ip, operation) LOGGER_CALL(logger, LogLevel::Info, log_data(ip, operation))
+//! \brief Событие пакета векторов (LogEvent::Batch*) без затрат при выключенном уровне Info
+#define LOG_BATCH(logger, event, ip, count) LOGGER_CALL(logger, LogLevel::Info, log_batch(event, ip, count))
+//! \brief Общее сообщение без затрат при выключенном уровне Info
+#define LOG_INFO(logger, message) LOGGER_CALL(logger, LogLevel::Info, log(message))
+
+//! \brief Поведение асинхронного логгера при заполненной очереди
+enum class LogOverflow {
+    Block,  //!< Ждать, пока поток записи освободит место
+    Drop,   //!< Отбросить запись
+    Count   //!< Отбросить запись и сообщить в журнале количество отброшенных
+};
+
+//! \brief Формат файла журнала
+enum class LogFormat {
+    Text,   //!< Строки текста, дублируются в консоль
+    Binary  //!< Записи BinaryLogRecord без форматирования; читаются утилитой logdecode
+};
+
+//! \brief Параметры логгера
+struct LoggerOptions {
+    bool async = false;                        //!< Записывать журнал в фоновом потоке
+    size_t queue_capacity = 8192;              //!< Ёмкость очереди записей (степень двойки)
+    unsigned flush_interval_ms = 50;           //!< Интервал записи накопленных строк, мс
+    LogOverflow overflow = LogOverflow::Block; //!< Поведение при заполненной очереди
+    LogLevel level = LogLevel::Info;           //!< Наименьший записываемый уровень
+    LogFormat format = LogFormat::Text;        //!< Формат файла журнала
+    uint64_t rotate_bytes = 0;                 //!< Размер файла для ротации, байт (0 - без ротации по размеру)
+    unsigned rotate_interval_sec = 0;          //!< Срок записи в один файл, с (0 - без ротации по времени)
+    unsigned keep_segments = 10;               //!< Хранимых ротированных файлов (0 - все)
+    bool compress_segments = true;             //!< Сжимать ротированные файлы gzip
+
+    //! \brief Проверить, включена ли ротация
+    //! \return true если задан размер или срок файла
+    bool rotation_enabled() const { return rotate_bytes > 0 || rotate_interval_sec > 0; }
+};
 
 //! \brief Класс для логирования событий сервера
-//! \details Записывает логи в файл и выводит в консоль
+//! \details Записывает логи в файл и выводит в консоль.
+//! Методы потокобезопасны. В синхронном режиме строка записывается и
+//! сбрасывается под мьютексом в вызывающем потоке. В асинхронном режиме
+//! готовая строка перемещается в неблокирующую очередь LockFreeQueue, а
+//! фоновый поток раз в flush_interval_ms собирает накопленные строки и
+//! записывает их в файл и консоль одним вызовом на пачку.
+//! В двоичном формате событие кодируется записью BinaryLogRecord: вид,
+//! тики и аргументы как есть, без времени в тексте и склейки строк; в
+//! консоль такие записи не выводятся. Записи идут через очередь в
+//! LogEntry: короткие копируются во встроенный буфер ячейки без выделения памяти.
+//! При ротации файл, превысивший rotate_bytes или rotate_interval_sec,
+//! переименовывается и открывается заново тем потоком, который пишет в
+//! файл: в асинхронном режиме - потоком записи, в синхронном - потоком,
+//! записавшим строку, под log_mutex (поэтому сервер требует --log-async);
+//! сжатие и удаление старых файлов выполняет LogArchiver в фоне.
+//! Записи ниже текущего уровня отбрасываются; уровень меняется на ходу
+//! (set_level(), adjust_level() безопасен в обработчике сигнала).
 //! \author Осетров М.С.
 //! \date 2025
 //! \copyright ПГУ
 class Logger {
 private:
+    static constexpr size_t BATCH_SIZE = 64 * 1024; //!< Размер пачки, после которого она записывается сразу
+
     std::ofstream log_file;    //!< Файл журнала
-    
+    std::mutex log_mutex;      //!< Мьютекс записи в журнал и консоль
+    LoggerOptions options;     //!< Параметры
+    std::string filename;      //!< Имя файла журнала
+
+    uint64_t file_bytes;                                 //!< Размер текущего файла
+    std::chrono::steady_clock::time_point file_opened;   //!< Начало записи в текущий файл
+    std::unique_ptr<LogArchiver> archiver;               //!< Сжатие и удаление ротированных файлов
+    std::atomic<uint64_t> rotations;                     //!< Выполнено ротаций
+
+    std::unique_ptr<LockFreeQueue<LogEntry>> queue; //!< Очередь записей асинхронного режима
+    std::thread writer;                    //!< Поток записи
+    std::mutex writer_mutex;               //!< Защита флагов потока записи
+    std::condition_variable writer_wakeup; //!< Запрос внеочередной записи или остановки
+    std::condition_variable written_cv;    //!< Пачка записана
+    bool flush_requested;                  //!< Запрошена внеочередная запись
+    bool stopping;                         //!< Флаг остановки потока записи
+    std::atomic<uint64_t> enqueued;        //!< Строк поставлено в очередь
+    std::atomic<uint64_t> written;         //!< Строк записано потоком записи
+    std::atomic<uint64_t> dropped;         //!< Строк отброшено при заполненной очереди
+    std::atomic<int> level;                //!< Текущий наименьший уровень (LogLevel)
+
     //! \brief Получить текущее время в формате строки
+    //! \details Строка кэшируется в потоке и форматируется заново раз в секунду
     //! \return Строка с текущим временем
     std::string get_current_time();
-    
+
+    //! \brief Проверить, пишется ли журнал в двоичном формате
+    bool is_binary() const { return options.format == LogFormat::Binary; }
+
+    //! \brief Записать текстовое событие без проверки уровня
+    //! \param[in] event Вид события (Message, Error или Debug)
+    //! \param[in] message Сообщение
+    void write(LogEvent event, const std::string& message);
+
+    //! \brief Записать готовую строку или двоичную запись
+    //! \param[in] entry Строка без перевода строки или байты записи
+    void write_entry(LogEntry&& entry);
+
+    //! \brief Поставить готовую запись в очередь согласно LoggerOptions::overflow
+    //! \param[in] entry Строка без перевода строки или байты записи
+    void enqueue(LogEntry&& entry);
+
+    //! \brief Записать байты в файл, при необходимости ротировав его
+    //! \details Вызывается только из потока, владеющего файлом
+    //! \param[in] data Байты
+    //! \param[in] size Количество байт
+    void write_file(const char* data, size_t size);
+
+    //! \brief Проверить, пора ли ротировать файл перед записью
+    //! \param[in] incoming Размер записываемых байт
+    //! \return true если файл не пуст и превышен размер или срок
+    bool rotation_due(size_t incoming) const;
+
+    //! \brief Переименовать файл журнала, открыть новый и передать старый LogArchiver
+    //! \details При ошибке переименования запись продолжается в прежний файл
+    void rotate();
+
+    //! \brief Разбудить поток записи
+    void wake_writer();
+
+    //! \brief Записать пачку строк в консоль и файл (двоичную - только в файл)
+    //! \details Ротация выполняется только между пачками
+    //! \param[in,out] batch Пачка (очищается)
+    void write_batch(std::string& batch);
+
+    //! \brief Цикл потока записи
+    void writer_loop();
+
 public:
     //! \brief Конструктор логгера
+    //! \details При включённой ротации запускает фоновый поток LogArchiver
     //! \param[in] filename Имя файла журнала
+    //! \param[in] options Параметры (по умолчанию - синхронная запись)
     //! \throw std::runtime_error При ошибке открытия файла
-    explicit Logger(const std::string& filename);
-    
-    //! \brief Деструктор логгера
+    //! \throw std::invalid_argument Если ёмкость очереди не степень двойки
+    explicit Logger(const std::string& filename, const LoggerOptions& options = LoggerOptions());
+
+    //! \brief Деструктор логгера, записывает оставшиеся строки
     ~Logger();
-    
-    //! \brief Записать общее сообщение
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    //! \brief Проверить, вкомпилирован ли уровень в макросы LOG_*
+    //! \param[in] level Уровень
+    //! \return true если уровень не ниже LOGGER_MIN_LEVEL
+    static constexpr bool is_compiled(LogLevel level) { return static_cast<int>(level) >= LOGGER_MIN_LEVEL; }
+
+    //! \brief Проверить, записываются ли сообщения уровня
+    //! \param[in] level Уровень
+    //! \return true если уровень не ниже текущего
+    bool is_enabled(LogLevel level) const {
+        return static_cast<int>(level) >= this->level.load(std::memory_order_relaxed);
+    }
+
+    //! \brief Установить наименьший записываемый уровень
+    //! \param[in] level Уровень
+    void set_level(LogLevel level) { this->level.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+    //! \brief Получить наименьший записываемый уровень
+    //! \return Уровень
+    LogLevel get_level() const { return static_cast<LogLevel>(level.load(std::memory_order_relaxed)); }
+
+    //! \brief Сдвинуть уровень в пределах Debug..Error
+    //! \details Не блокирует и не выделяет память - можно вызывать из обработчика сигнала
+    //! \param[in] delta -1 - подробнее, +1 - короче
+    //! \return Новый уровень
+    LogLevel adjust_level(int delta);
+
+    //! \brief Записать общее сообщение (уровень Info)
     //! \param[in] message Сообщение для записи
     void log(const std::string& message);
-    
-    //! \brief Записать событие аутентификации
+
+    //! \brief Записать событие аутентификации (Info при успехе, Warning при неудаче)
     //! \param[in] ip IP адрес клиента
     //! \param[in] login Логин пользователя
     //! \param[in] success Результат аутентификации
     //! \param[in] details Детали аутентификации (по умолчанию пустая строка)
-    void log_auth(const std::string& ip, const std::string& login, 
+    void log_auth(const std::string& ip, const std::string& login,
                   bool success, const std::string& details = "");
-    
-    //! \brief Записать событие подключения/отключения
+
+    //! \brief Записать событие подключения/отключения (уровень Info)
     //! \param[in] ip IP адрес клиента
     //! \param[in] connected Флаг подключения (true) или отключения (false)
     void log_connection(const std::string& ip, bool connected);
-    
-    //! \brief Записать событие обработки данных
+
+    //! \brief Записать событие обработки данных (уровень Info)
     //! \param[in] ip IP адрес клиента
     //! \param[in] operation Операция с данными
     void log_data(const std::string& ip, const std::string& operation);
-    
-    //! \brief Записать сообщение об ошибке
+
+    //! \brief Записать событие пакета векторов с постоянным форматом (уровень Info)
+    //! \details В текстовом журнале - запись DATA с текстом BinaryLogDecoder::describe_batch(),
+    //! в двоичном - только вид события, адрес и счётчик
+    //! \param[in] event BatchStarted, BatchProcessed или ConnectionServed
+    //! \param[in] ip IP адрес клиента
+    //! \param[in] count Количество векторов или пакетов
+    void log_batch(LogEvent event, const std::string& ip, uint32_t count = 0);
+
+    //! \brief Записать сообщение об ошибке (уровень Error)
     //! \param[in] error Текст ошибки
     void log_error(const std::string& error);
-    
-    //! \brief Записать отладочное сообщение
+
+    //! \brief Записать отладочное сообщение (уровень Debug)
+    //! \details Аргумент уже построен вызывающим - на горячих путях используйте LOG_DEBUG
     //! \param[in] msg Текст отладочного сообщения
     void log_debug(const std::string& msg);
+
+    //! \brief Дождаться записи всех строк, поставленных в очередь до вызова
+    //! \details В синхронном режиме ничего не делает
+    void flush();
+
+    //! \brief Проверить, пишет ли журнал фоновый поток
+    //! \return true в асинхронном режиме
+    bool is_async() const { return options.async; }
+
+    //! \brief Получить количество отброшенных строк
+    //! \return Количество строк, отброшенных при заполненной очереди
+    uint64_t get_dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    //! \brief Получить количество ротаций файла
+    //! \return Количество ротаций
+    uint64_t get_rotations() const { return rotations.load(std::memory_order_relaxed); }
+
+    //! \brief Получить обслуживание ротированных файлов
+    //! \return LogArchiver или nullptr без ротации
+    const LogArchiver* get_archiver() const { return archiver.get(); }
 };
@@ -0,0 +1,102 @@
+/*! \file SaltReservoir.cpp
+ *  \brief Реализация класса SaltReservoir
+ *  \details Содержит генератор случайных байт потока и фоновое пополнение запаса солей
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "SaltReservoir.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <cryptopp/osrng.h>
+
+SaltReservoir::SaltReservoir(size_t capacity)
+    : capacity(capacity), stopping(false), misses(0) {
+    if (capacity > 0) {
+        salts.reserve(capacity);
+        refiller = std::thread(&SaltReservoir::refill_loop, this);
+    }
+}
+
+SaltReservoir::~SaltReservoir() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    refill_needed.notify_one();
+    if (refiller.joinable()) {
+        refiller.join();
+    }
+}
+
+void SaltReservoir::random_bytes(uint8_t* out, size_t size) {
+    try {
+        // AutoSeededRandomPool берёт зерно из ОС в конструкторе - один раз на поток
+        thread_local CryptoPP::AutoSeededRandomPool rng;
+        rng.GenerateBlock(out, size);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Random generator failed: " + std::string(e.what()));
+    }
+}
+
+void SaltReservoir::generate(char* out, size_t count) {
+    static const char digits[] = "0123456789ABCDEF";
+    uint8_t bytes[REFILL_CHUNK * SALT_BYTES];
+    while (count > 0) {
+        size_t chunk = std::min(count, REFILL_CHUNK);
+        random_bytes(bytes, chunk * SALT_BYTES);
+        for (size_t i = 0; i < chunk * SALT_BYTES; i++) {
+            *out++ = digits[bytes[i] >> 4];
+            *out++ = digits[bytes[i] & 0x0F];
+        }
+        count -= chunk;
+    }
+}
+
+void SaltReservoir::take(char* out) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!salts.empty()) {
+            const Salt& salt = salts.back();
+            std::copy(salt.begin(), salt.end(), out);
+            salts.pop_back();
+            // Будим пополнение один раз - при пересечении порога
+            if (salts.size() == capacity / 4) {
+                refill_needed.notify_one();
+            }
+            return;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    refill_needed.notify_one();
+    generate(out, 1);
+}
+
+void SaltReservoir::refill_loop() {
+    static_assert(sizeof(Salt) == SALT_SIZE, "salts must be contiguous for generate()");
+    std::vector<Salt> fresh(REFILL_CHUNK);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        refill_needed.wait(lock, [this]() { return stopping || salts.size() <= capacity / 4; });
+        while (!stopping && salts.size() < capacity) {
+            size_t chunk = std::min(REFILL_CHUNK, capacity - salts.size());
+            // Генерация - без блокировки, выдача солей не ждёт генератор
+            lock.unlock();
+            try {
+                generate(fresh[0].data(), chunk);
+            } catch (const std::exception&) {
+                // Запас больше не пополняется; take() сообщит об ошибке при генерации на месте
+                return;
+            }
+            lock.lock();
+            salts.insert(salts.end(), fresh.begin(), fresh.begin() + std::min(chunk, capacity - salts.size()));
+        }
+        if (stopping) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef SALTRESERVOIR_H
+#define SALTRESERVOIR_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! \brief Запас заранее сгенерированных солей
+//! \details Фоновый поток пополняет запас пачками, когда он опускается ниже
+//! четверти ёмкости, поэтому выдача соли - копирование 16 байт под короткой
+//! блокировкой. Если запас исчерпан, соль генерируется в вызывающем потоке.
+//! Случайные байты берутся из генератора потока (random_bytes()), который
+//! инициализируется из ОС один раз, а не на каждое подключение.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class SaltReservoir {
+public:
+    static constexpr size_t SALT_BYTES = 8;                //!< Случайных байт в соли
+    static constexpr size_t SALT_SIZE = 2 * SALT_BYTES;    //!< Длина соли в шестнадцатеричном виде
+    static constexpr size_t DEFAULT_CAPACITY = 4096;       //!< Ёмкость запаса по умолчанию
+
+    using Salt = std::array<char, SALT_SIZE>; //!< Соль без завершающего нуля
+
+private:
+    static constexpr size_t REFILL_CHUNK = 256; //!< Солей за одно обращение к генератору
+
+    std::mutex mutex;                        //!< Защита запаса
+    std::condition_variable refill_needed;   //!< Запас ниже порога или остановка
+    std::vector<Salt> salts;                 //!< Готовые соли
+    size_t capacity;                         //!< Ёмкость запаса (0 - без запаса)
+    bool stopping;                           //!< Флаг остановки фонового потока
+    std::atomic<uint64_t> misses;            //!< Солей, сгенерированных при пустом запасе
+    std::thread refiller;                    //!< Поток пополнения
+
+    //! \brief Цикл фонового потока пополнения
+    void refill_loop();
+
+public:
+    //! \brief Конструктор запаса
+    //! \param[in] capacity Ёмкость запаса (0 - генерировать каждую соль при выдаче)
+    explicit SaltReservoir(size_t capacity = DEFAULT_CAPACITY);
+
+    //! \brief Деструктор, останавливает поток пополнения
+    ~SaltReservoir();
+
+    SaltReservoir(const SaltReservoir&) = delete;
+    SaltReservoir& operator=(const SaltReservoir&) = delete;
+
+    //! \brief Выдать соль
+    //! \param[out] out Буфер на SALT_SIZE символов (без завершающего нуля)
+    //! \throw std::runtime_error При ошибке генератора (только при пустом запасе)
+    void take(char* out);
+
+    //! \brief Получить количество солей, выданных мимо запаса
+    //! \return Количество промахов
+    uint64_t get_misses() const { return misses.load(std::memory_order_relaxed); }
+
+    //! \brief Заполнить буфер криптостойкими случайными байтами
+    //! \details Использует генератор текущего потока, созданный при первом вызове
+    //! \param[out] out Буфер
+    //! \param[in] size Количество байт
+    //! \throw std::runtime_error При ошибке генератора
+    static void random_bytes(uint8_t* out, size_t size);
+
+    //! \brief Сгенерировать соли подряд
+    //! \param[out] out Буфер на count * SALT_SIZE символов (шестнадцатеричные, верхний регистр)
+    //! \param[in] count Количество солей
+    //! \throw std::runtime_error При ошибке генератора
+    static void generate(char* out, size_t count);
+};
+
+#endif // SALTRESERVOIR_H
@@ -6,24 +6,40 @@
  */
 
 #include "Server.h"
+#include "BufferPool.h"
+#include "ComputePool.h"
 #include <iostream>
 #include <cstring>
 #include <csignal>
 #include <stdexcept>
+#include <functional>
 #include <vector>
 
+#include <thread>
+
+#include <fcntl.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 
-Server::Server(int port, const std::string& user_db_file, const std::string& log_file)
+Server::Server(int port, const std::string& user_db_file, const std::string& log_file,
+               const ServerOptions& options, std::shared_ptr<Logger> shared_logger)
     : port(port), user_db_file(user_db_file), log_file(log_file),
-      server_socket(-1), running(false) {
+      server_socket(-1), running(false), options(options),
+      admission(options.max_sessions, std::chrono::milliseconds(options.shed_target_ms),
+                std::chrono::milliseconds(options.shed_interval_ms)) {
     
     try {
-        logger = std::make_shared<Logger>(log_file); 
+        logger = shared_logger ? std::move(shared_logger)
+                               : std::make_shared<Logger>(log_file, options.log_options);
         error_handler = std::make_shared<ErrorHandler>(logger);
+        auth_manager.set_ticket_lifetime(options.ticket_lifetime_sec);
+        if (options.ip_limits.enabled()) {
+            rate_limiter = std::make_unique<IpRateLimiter>(options.ip_limits);
+            auth_manager.set_rate_limiter(rate_limiter.get());
+        }
+        gate = SessionGate(&admission, rate_limiter.get());
         logger->log("Server initialized successfully");
     } catch (const std::exception& e) {
         std::cerr << "FATAL: Failed to initialize server: " << e.what() << std::endl;
@@ -33,6 +49,9 @@ Server::Server(int port, const std::string& user_db_file, const std::string& log
 
 Server::~Server() {
     stop();
+    if (worker_pool) {
+        worker_pool->join();
+    }
 }
 
 std::string Server::get_client_ip(int client_sock) {
@@ -71,7 +90,7 @@ bool Server::send_string(int sock, const std::string& str) {
 
 bool Server::recv_string(int sock, std::string& str, size_t max_len) {
     try {
-        std::vector<char> buffer(max_len + 1);
+        PooledBuffer buffer(max_len + 1);
         
         ssize_t received = recv(sock, buffer.data(), max_len, 0);
         if (received <= 0) {
@@ -82,7 +101,7 @@ bool Server::recv_string(int sock, std::string& str, size_t max_len) {
             }
         }
         
-        buffer[received] = '\0';
+        buffer.data()[received] = '\0';
         str = std::string(buffer.data());
         return true;
     } catch (const std::exception& e) {
@@ -109,6 +128,7 @@ bool Server::handle_client(int client_sock) {
         
         client_ip = get_client_ip(client_sock);
         logger->log_connection(client_ip, true);
+        SessionStats::add(blocking_stats.connections_accepted);
         
         std::string login;
         if (!recv_string(client_sock, login)) {
@@ -119,30 +139,45 @@ bool Server::handle_client(int client_sock) {
             throw std::runtime_error("Empty login received");
         }
         
-        std::string salt = auth_manager.generate_salt();
-        
-        if (!send_string(client_sock, salt)) {
-            throw std::runtime_error("Failed to send salt");
-        }
-        
-        std::string client_hash;
-        if (!recv_string(client_sock, client_hash)) {
-            throw std::runtime_error("Failed to receive hash");
+        bool auth_success;
+        LoginKind login_kind = AuthManager::parse_login_message(login);
+        if (login_kind == LoginKind::Resume) {
+            // Билет возобновления: без соли, хеша и лишнего обмена
+            std::string ticket = login;
+            auth_success = auth_manager.resume(ticket, login, *logger, client_ip);
+        } else {
+            std::string salt = auth_manager.generate_salt();
+            
+            if (!send_string(client_sock, salt)) {
+                throw std::runtime_error("Failed to send salt");
+            }
+            
+            std::string client_hash;
+            if (!recv_string(client_sock, client_hash)) {
+                throw std::runtime_error("Failed to receive hash");
+            }
+            
+            auth_success = auth_manager.authenticate(
+                login, client_hash, salt, *logger, client_ip
+            );
         }
         
-        bool auth_success = auth_manager.authenticate(
-            login, client_hash, salt, *logger, client_ip
-        );
-        
         if (auth_success) {
-            if (!send_string(client_sock, "OK")) {
+            // Возобновивший клиент получает новый билет: принятый билет одноразовый
+            std::string reply = "OK";
+            if (login_kind != LoginKind::Password) {
+                reply += auth_manager.issue_ticket(login);
+            }
+            if (!send_string(client_sock, reply)) {
                 throw std::runtime_error("Failed to send OK");
             }
             
-            if (!DataCalculator::process_client_data(client_sock, *logger, client_ip)) {
+            if (!DataCalculator::process_client_data(client_sock, *logger, client_ip, &blocking_stats,
+                                                     options.keep_alive_sec)) {
                 logger->log_error("Data processing failed for " + client_ip);
             }
         } else {
+            SessionStats::add(blocking_stats.auth_failures);
             if (!send_string(client_sock, "ERR")) {
                 logger->log_error("Failed to send ERR to " + client_ip);
             }
@@ -162,6 +197,7 @@ bool Server::handle_client(int client_sock) {
     try {
         if (client_sock >= 0) {
             close(client_sock);
+            SessionStats::add(blocking_stats.connections_closed);
         }
         if (client_ip != "unknown") {
             logger->log_connection(client_ip, false);
@@ -173,38 +209,106 @@ bool Server::handle_client(int client_sock) {
     return true;
 }
 
-bool Server::start() {
+int Server::create_listening_socket(bool reuse_port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    
     try {
-        logger->log("Starting server on port " + std::to_string(port));
-        
-        if (!auth_manager.load_users(user_db_file)) {
-            throw std::runtime_error("Failed to load user database: " + user_db_file);
-        }
-        
-        server_socket = socket(AF_INET, SOCK_STREAM, 0);
-        if (server_socket < 0) {
-            throw std::runtime_error("Failed to create socket");
-        }
-        
         int opt = 1;
-        if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
             throw std::runtime_error("Failed to set socket options");
         }
         
+        if (reuse_port && setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+            throw std::runtime_error("Failed to set SO_REUSEPORT");
+        }
+        
         struct sockaddr_in server_addr;
         memset(&server_addr, 0, sizeof(server_addr));
         server_addr.sin_family = AF_INET;
         server_addr.sin_addr.s_addr = INADDR_ANY;
         server_addr.sin_port = htons(port);
         
-        if (bind(server_socket, reinterpret_cast<struct sockaddr*>(&server_addr), sizeof(server_addr)) < 0) {
+        if (bind(sock, reinterpret_cast<struct sockaddr*>(&server_addr), sizeof(server_addr)) < 0) {
             throw std::runtime_error("Failed to bind socket to port " + std::to_string(port));
         }
         
-        if (listen(server_socket, 10) < 0) {
+        if (listen(sock, options.listen_backlog) < 0) {
             throw std::runtime_error("Failed to listen on socket");
         }
         
+        if (options.mode != ServerMode::Blocking) {
+            int flags = fcntl(sock, F_GETFL, 0);
+            if (flags < 0 || fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0) {
+                throw std::runtime_error("Failed to make listening socket non-blocking");
+            }
+        }
+    } catch (...) {
+        close(sock);
+        throw;
+    }
+    return sock;
+}
+
+bool Server::start() {
+    try {
+        logger->log("Starting server on port " + std::to_string(port));
+        
+        if (!auth_manager.load_users(user_db_file)) {
+            throw std::runtime_error("Failed to load user database: " + user_db_file);
+        }
+        user_db_watcher = std::make_unique<UserDbWatcher>(auth_manager, *logger, user_db_file,
+                                                          options.watch_user_db);
+        
+        BufferPool::instance().set_huge_pages(options.huge_pages);
+        ComputePool::instance().set_threads(options.compute_threads);
+        
+        if (DataCalculator::set_io_backend(options.io_backend) != options.io_backend) {
+            logger->log("io_uring is not supported by the kernel, falling back to select");
+        } else if (options.io_backend == IoBackend::Uring) {
+            logger->log("Using io_uring I/O backend");
+        }
+        
+        if (options.mode == ServerMode::Sharded) {
+            unsigned shard_count = options.worker_threads > 0 ? options.worker_threads : 1;
+            unsigned cpu_count = std::thread::hardware_concurrency();
+            for (unsigned i = 0; i < shard_count; i++) {
+                int shard_socket = create_listening_socket(true);
+                if (i == 0) {
+                    server_socket = shard_socket;
+                } else {
+                    shard_sockets.push_back(shard_socket);
+                }
+                int cpu = cpu_count > 0 ? static_cast<int>(i % cpu_count) : -1;
+                event_loops.push_back(std::make_unique<EpollLoop>(auth_manager, *logger, shard_socket, cpu, gate,
+                                                                   options.keep_alive_sec));
+            }
+            logger->log("Started " + std::to_string(shard_count) + " SO_REUSEPORT shards");
+        } else {
+            server_socket = create_listening_socket(false);
+        }
+        
+        if (options.mode == ServerMode::Epoll) {
+            unsigned loop_count = options.worker_threads > 0 ? options.worker_threads : 1;
+            for (unsigned i = 0; i < loop_count; i++) {
+                event_loops.push_back(std::make_unique<EpollLoop>(auth_manager, *logger, server_socket, -1, gate,
+                                                                   options.keep_alive_sec));
+            }
+        } else if (options.mode == ServerMode::Coroutine) {
+            unsigned executor_count = options.worker_threads > 0 ? options.worker_threads : 1;
+            for (unsigned i = 0; i < executor_count; i++) {
+                coro_executors.push_back(std::make_unique<CoroExecutor>(auth_manager, *logger, server_socket, gate,
+                                                                         options.keep_alive_sec));
+            }
+        }
+        
+        if (options.max_sessions > 0 || options.shed_target_ms > 0) {
+            logger->log("Admission control: max_sessions=" + std::to_string(options.max_sessions) +
+                        " shed_target_ms=" + std::to_string(options.shed_target_ms));
+        }
+        
         running = true;
         logger->log("Server started successfully on port " + std::to_string(port));
         return true;
@@ -215,6 +319,18 @@ bool Server::start() {
     }
 }
 
+void Server::request_user_reload() {
+    if (user_db_watcher) {
+        user_db_watcher->request_reload();
+    }
+}
+
+void Server::adjust_log_level(int delta) {
+    if (logger) {
+        logger->adjust_level(delta);
+    }
+}
+
 void Server::stop() {
     if (!running) {
         return; 
@@ -223,9 +339,27 @@ void Server::stop() {
     running = false;
     try {
         if (server_socket >= 0) {
+            shutdown(server_socket, SHUT_RDWR);
             close(server_socket);
             server_socket = -1;
         }
+        for (int shard_socket : shard_sockets) {
+            shutdown(shard_socket, SHUT_RDWR);
+            close(shard_socket);
+        }
+        shard_sockets.clear();
+        if (worker_pool) {
+            worker_pool->stop();
+        }
+        for (auto& loop : event_loops) {
+            loop->stop();
+        }
+        for (auto& executor : coro_executors) {
+            executor->stop();
+        }
+        if (user_db_watcher) {
+            user_db_watcher->stop();
+        }
 
     } catch (const std::exception& e) {
         if (logger) {
@@ -235,6 +369,81 @@ void Server::stop() {
 }
 
 void Server::run() {
+    if (options.mode == ServerMode::Blocking) {
+        run_blocking();
+    } else {
+        run_event_loops();
+    }
+    logger->log("Session stats: " + get_stats().to_string());
+    logger->log("Buffer pool stats: " + BufferPool::instance().get_stats().to_string());
+}
+
+StatsSnapshot Server::get_stats() const {
+    StatsSnapshot total = blocking_stats.snapshot();
+    for (const auto& loop : event_loops) {
+        total += loop->get_stats().snapshot();
+    }
+    for (const auto& executor : coro_executors) {
+        total += executor->get_stats().snapshot();
+    }
+    return total;
+}
+
+std::vector<StatsSnapshot> Server::get_shard_stats() const {
+    std::vector<StatsSnapshot> shard_stats;
+    for (const auto& loop : event_loops) {
+        shard_stats.push_back(loop->get_stats().snapshot());
+    }
+    for (const auto& executor : coro_executors) {
+        shard_stats.push_back(executor->get_stats().snapshot());
+    }
+    return shard_stats;
+}
+
+void Server::run_event_loops() {
+    std::vector<std::function<void()>> loops;
+    for (auto& loop : event_loops) {
+        loops.push_back([&loop]() { loop->run(); });
+    }
+    for (auto& executor : coro_executors) {
+        loops.push_back([&executor]() { executor->run(); });
+    }
+    logger->log("Waiting for connections with " + std::to_string(loops.size()) +
+                (coro_executors.empty() ? " epoll loops..." : " coroutine executors..."));
+    
+    std::vector<std::thread> loop_threads;
+    for (auto& loop : loops) {
+        loop_threads.emplace_back([this, &loop]() {
+            try {
+                loop();
+            } catch (const std::exception& e) {
+                error_handler->handle_exception(e, "Server::run_event_loops");
+            }
+        });
+    }
+    
+    for (auto& thread : loop_threads) {
+        thread.join();
+    }
+}
+
+void Server::run_blocking() {
+    if (options.worker_threads > 0) {
+        // Адрес из accept() идёт через очередь: getpeername() после сброса соединения не вернёт его
+        worker_pool = std::make_unique<WorkerPool>(
+            options.worker_threads, options.accept_queue_capacity,
+            [this](int client_sock, uint32_t client_address) {
+                handle_client(client_sock);
+                gate.release(client_address);
+            },
+            [this](int client_sock, uint32_t client_address) {
+                gate.reject(client_sock, client_address, blocking_stats);
+            },
+            &admission);
+        worker_pool->start();
+        logger->log("Worker pool started with " + std::to_string(worker_pool->size()) + " threads");
+    }
+    
     logger->log("Waiting for connections...");
     
     while (running) {
@@ -253,7 +462,17 @@ void Server::run() {
                 continue;
             }
             
-            handle_client(client_sock);
+            uint32_t client_address = client_addr.sin_addr.s_addr;
+            if (!gate.admit(client_sock, client_address, blocking_stats)) {
+                continue;
+            }
+            if (!worker_pool) {
+                handle_client(client_sock);
+                gate.release(client_address);
+            } else if (!worker_pool->submit(client_sock, client_address)) {
+                logger->log_error("Worker queue is full, rejecting connection");
+                gate.reject(client_sock, client_address, blocking_stats);
+            }
             
         } catch (const std::exception& e) {
             error_handler->handle_exception(e, "Server::run loop");
@@ -262,4 +481,9 @@ void Server::run() {
             sleep(1);
         }
     }
+    
+    if (worker_pool) {
+        worker_pool->stop();
+        worker_pool->join();
+    }
 }
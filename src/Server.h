@@ -1,12 +1,23 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <atomic>
 #include <string>
 #include <memory>
+#include <vector>
 #include "Logger.h"          
 #include "AuthManager.h"     
 #include "DataCalculator.h"  
 #include "ErrorHandler.h"    
+#include "ServerOptions.h"
+#include "AdmissionController.h"
+#include "IpRateLimiter.h"
+#include "SessionGate.h"
+#include "WorkerPool.h"
+#include "EpollLoop.h"
+#include "CoroExecutor.h"
+#include "SessionStats.h"
+#include "UserDbWatcher.h"
 
 //! \brief Основной класс сервера
 //! \details Управляет подключениями клиентов, аутентификацией и обработкой данных
@@ -23,7 +34,29 @@ private:
     std::shared_ptr<class ErrorHandler> error_handler; //!< Обработчик ошибок
     class AuthManager auth_manager;            //!< Менеджер аутентификации
     int server_socket;                        //!< Сокет сервера
-    bool running;                            //!< Флаг работы сервера
+    std::atomic<bool> running;               //!< Флаг работы сервера
+    ServerOptions options;                   //!< Параметры параллельной обработки
+    AdmissionController admission;           //!< Предел сессий и отсечение по времени ожидания
+    std::unique_ptr<IpRateLimiter> rate_limiter; //!< Ограничитель по IP (nullptr - ограничения выключены)
+    SessionGate gate;                        //!< Допуск подключений во всех режимах (admission и rate_limiter)
+    std::unique_ptr<WorkerPool> worker_pool; //!< Пул рабочих потоков
+    std::vector<std::unique_ptr<EpollLoop>> event_loops; //!< Циклы событий режимов epoll и sharded
+    std::vector<std::unique_ptr<CoroExecutor>> coro_executors; //!< Исполнители режима coro
+    std::vector<int> shard_sockets;          //!< Дополнительные сокеты шардов (SO_REUSEPORT)
+    SessionStats blocking_stats;             //!< Счётчики блокирующего режима
+    std::unique_ptr<UserDbWatcher> user_db_watcher; //!< Перезагрузка базы пользователей
+    
+    //! \brief Создать прослушивающий сокет на порту сервера
+    //! \param[in] reuse_port Включить SO_REUSEPORT для шардирования
+    //! \return Дескриптор сокета
+    //! \throw std::runtime_error При ошибке создания, bind или listen
+    int create_listening_socket(bool reuse_port);
+    
+    //! \brief Обслуживать клиентов блокирующими сессиями
+    void run_blocking();
+    
+    //! \brief Обслуживать клиентов в циклах событий (epoll, шарды или исполнители сопрограмм)
+    void run_event_loops();
     
 public:
     //! \brief Получить IP адрес клиента
@@ -53,8 +86,14 @@ public:
     //! \param[in] port Порт для прослушивания
     //! \param[in] user_db_file Файл базы пользователей
     //! \param[in] log_file Файл журнала
+    //! \param[in] options Параметры параллельной обработки
+    //! \param[in] shared_logger Общий логгер процесса; если не задан, сервер
+    //! открывает log_file сам. Один файл журнала должен писать один Logger,
+    //! иначе ротация выполняется дважды
     //! \throw std::runtime_error При ошибке инициализации
-    Server(int port, const std::string& user_db_file, const std::string& log_file);
+    Server(int port, const std::string& user_db_file, const std::string& log_file,
+           const ServerOptions& options = ServerOptions(),
+           std::shared_ptr<Logger> shared_logger = nullptr);
     
     //! \brief Деструктор сервера
     ~Server();
@@ -64,10 +103,36 @@ public:
     bool start();
     
     //! \brief Остановить сервер
+    //! \details Не дожидается завершения сессий, допускается вызов из обработчика сигнала
     void stop();
     
+    //! \brief Запросить перезагрузку базы пользователей
+    //! \details Допускается вызов из обработчика сигнала (SIGHUP)
+    void request_user_reload();
+    
+    //! \brief Сдвинуть уровень журнала сервера
+    //! \details Допускается вызов из обработчика сигнала (SIGUSR1, SIGUSR2)
+    //! \param[in] delta -1 - подробнее, +1 - короче
+    void adjust_log_level(int delta);
+    
     //! \brief Основной цикл работы сервера
+    //! \details В блокирующем режиме принимает подключения и передаёт их в пул
+    //! рабочих потоков (при worker_threads == 0 обслуживает клиентов в текущем потоке).
+    //! Подключения сверх max_sessions и сессии, прождавшие в очереди пула дольше
+    //! shed_target_ms, получают "ERR" без обслуживания.
+    //! В режиме epoll запускает циклы событий, разделяющие прослушивающий сокет;
+    //! в режиме sharded каждый цикл принимает подключения со своего сокета SO_REUSEPORT;
+    //! в режиме coro сессии выполняются сопрограммами в исполнителях CoroExecutor
     void run();
+    
+    //! \brief Получить суммарные счётчики сессий
+    //! \details Суммирует счётчики всех шардов (циклов) и блокирующего режима в момент вызова
+    //! \return Снимок счётчиков
+    StatsSnapshot get_stats() const;
+    
+    //! \brief Получить счётчики каждого шарда
+    //! \return Снимки счётчиков по циклам событий
+    std::vector<StatsSnapshot> get_shard_stats() const;
 };
 
 #endif // SERVER_H
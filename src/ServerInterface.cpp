@@ -9,6 +9,7 @@
 #include "CommandLineParser.h"
 #include "Server.h"
 #include "ErrorHandler.h"
+#include "UserStore.h"
 #include <iostream>
 #include <csignal>
 #include <memory>
@@ -32,6 +33,22 @@ namespace {
             server_instance->stop();
         }
     }
+    
+    void reload_handler(int) {
+        if (server_instance) {
+            server_instance->request_user_reload();
+        }
+    }
+    
+    void log_level_handler(int signal) {
+        int delta = signal == SIGUSR1 ? -1 : 1;
+        // Сервер пишет в global_logger - уровень меняется один раз
+        if (server_instance) {
+            server_instance->adjust_log_level(delta);
+        } else if (global_logger) {
+            global_logger->adjust_level(delta);
+        }
+    }
 }
 
 int ServerInterface::run(int argc, char* argv[]) {
@@ -50,17 +67,36 @@ int ServerInterface::run(int argc, char* argv[]) {
             return 1; 
         }
         
+        if (!parser.get_compiled_users_file().empty()) {
+            try {
+                size_t count = UserStore::compile(parser.get_user_db_file(), parser.get_compiled_users_file());
+                std::cout << "Записано пользователей: " << count << " -> "
+                          << parser.get_compiled_users_file() << std::endl;
+                return 0;
+            } catch (const std::exception& e) {
+                std::cerr << "ERROR: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        
         std::cout << "Порт: " << parser.get_port() << std::endl;
         std::cout << "Файл пользователей: " << parser.get_user_db_file() << std::endl;
         std::cout << "Файл лога: " << parser.get_log_file() << std::endl;
+        std::cout << "Рабочих потоков: " << parser.get_server_options().worker_threads << std::endl;
+        const char* mode_names[] = {"blocking", "epoll", "sharded", "coro"};
+        std::cout << "Режим: " << mode_names[static_cast<int>(parser.get_server_options().mode)] << std::endl;
         std::cout << "========================================" << std::endl;
         
         std::signal(SIGINT, signal_handler);
         std::signal(SIGTERM, signal_handler);
         std::signal(SIGPIPE, SIG_IGN); 
+        std::signal(SIGHUP, reload_handler);
+        std::signal(SIGUSR1, log_level_handler);
+        std::signal(SIGUSR2, log_level_handler);
         
         try {
-            global_logger = std::make_shared<Logger>(parser.get_log_file());
+            global_logger = std::make_shared<Logger>(parser.get_log_file(),
+                                                     parser.get_server_options().log_options);
             global_error_handler = std::make_shared<ErrorHandler>(global_logger);
         } catch (const std::exception& e) {
             std::cerr << "FATAL: Cannot initialize logging: " << e.what() << std::endl;
@@ -71,7 +107,9 @@ int ServerInterface::run(int argc, char* argv[]) {
             server_instance = std::make_unique<Server>(
                 parser.get_port(),
                 parser.get_user_db_file(),
-                parser.get_log_file()
+                parser.get_log_file(),
+                parser.get_server_options(),
+                global_logger
             );
         } catch (const std::exception& e) {
             global_error_handler->handle_critical_error("Failed to create server: " + 
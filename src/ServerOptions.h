@@ -0,0 +1,121 @@
+#ifndef SERVEROPTIONS_H
+#define SERVEROPTIONS_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+
+#include "AuthManager.h"
+#include "IpRateLimiter.h"
+#include "BufferPool.h"
+#include "DataCalculator.h"
+#include "Logger.h"
+
+//! \brief Режим обслуживания клиентских сессий
+enum class ServerMode {
+    Blocking,  //!< Блокирующие сессии в пуле рабочих потоков
+    Epoll,     //!< Неблокирующие сессии в циклах событий epoll
+    Sharded,   //!< Шарды SO_REUSEPORT: свой сокет, цикл epoll и ядро на каждый шард
+    Coroutine  //!< Сессии-сопрограммы в исполнителях CoroExecutor
+};
+
+//! \brief Разобрать название режима обслуживания
+//! \param[in] name Название режима ("blocking", "epoll", "sharded" или "coro")
+//! \return Режим обслуживания
+//! \throw std::runtime_error При неизвестном названии
+inline ServerMode parse_server_mode(const std::string& name) {
+    if (name == "blocking") return ServerMode::Blocking;
+    if (name == "epoll") return ServerMode::Epoll;
+    if (name == "sharded") return ServerMode::Sharded;
+    if (name == "coro") return ServerMode::Coroutine;
+    throw std::runtime_error("Unknown server mode: " + name);
+}
+
+//! \brief Разобрать название механизма ввода-вывода
+//! \param[in] name Название механизма ("select" или "uring")
+//! \return Механизм ввода-вывода
+//! \throw std::runtime_error При неизвестном названии
+inline IoBackend parse_io_backend(const std::string& name) {
+    if (name == "select") return IoBackend::Select;
+    if (name == "uring") return IoBackend::Uring;
+    throw std::runtime_error("Unknown I/O backend: " + name);
+}
+
+//! \brief Разобрать режим больших страниц
+//! \param[in] name Название режима ("none", "thp" или "explicit")
+//! \return Режим больших страниц
+//! \throw std::runtime_error При неизвестном названии
+inline HugePages parse_huge_pages(const std::string& name) {
+    if (name == "none") return HugePages::None;
+    if (name == "thp") return HugePages::Transparent;
+    if (name == "explicit") return HugePages::Explicit;
+    throw std::runtime_error("Unknown huge pages mode: " + name);
+}
+
+//! \brief Разобрать поведение асинхронного логгера при заполненной очереди
+//! \param[in] name Название ("block", "drop" или "count")
+//! \return Поведение при заполненной очереди
+//! \throw std::runtime_error При неизвестном названии
+inline LogOverflow parse_log_overflow(const std::string& name) {
+    if (name == "block") return LogOverflow::Block;
+    if (name == "drop") return LogOverflow::Drop;
+    if (name == "count") return LogOverflow::Count;
+    throw std::runtime_error("Unknown log overflow policy: " + name);
+}
+
+//! \brief Разобрать уровень журнала
+//! \param[in] name Название ("debug", "info", "warning" или "error")
+//! \return Уровень журнала
+//! \throw std::runtime_error При неизвестном названии
+inline LogLevel parse_log_level(const std::string& name) {
+    if (name == "debug") return LogLevel::Debug;
+    if (name == "info") return LogLevel::Info;
+    if (name == "warning") return LogLevel::Warning;
+    if (name == "error") return LogLevel::Error;
+    throw std::runtime_error("Unknown log level: " + name);
+}
+
+//! \brief Разобрать формат файла журнала
+//! \param[in] name Название ("text" или "binary")
+//! \return Формат журнала
+//! \throw std::runtime_error При неизвестном названии
+inline LogFormat parse_log_format(const std::string& name) {
+    if (name == "text") return LogFormat::Text;
+    if (name == "binary") return LogFormat::Binary;
+    throw std::runtime_error("Unknown log format: " + name);
+}
+
+//! \brief Параметры работы сервера
+//! \details Настройки, не влияющие на протокол: параллелизм, размеры очередей и контроль допуска
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+struct ServerOptions {
+    ServerMode mode = ServerMode::Blocking; //!< Режим обслуживания сессий
+    //! \brief Количество рабочих потоков (0 - обслуживать клиентов в потоке accept).
+    //! В режимах epoll, sharded и coro - количество циклов событий (шардов), не меньше одного
+    unsigned worker_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    size_t accept_queue_capacity = 1024; //!< Ёмкость очереди принятых сокетов (степень двойки)
+    IoBackend io_backend = IoBackend::Select; //!< Механизм ввода-вывода блокирующих сессий
+    int listen_backlog = SOMAXCONN;      //!< Длина очереди listen() (ограничивается net.core.somaxconn)
+    unsigned max_sessions = 0;           //!< Предел одновременных сессий (0 - без предела)
+    unsigned shed_target_ms = 0;         //!< Целевое время ожидания в очереди пула, мс (0 - без отсечения)
+    unsigned shed_interval_ms = 100;     //!< Интервал превышения цели до начала отсечения, мс
+    HugePages huge_pages = HugePages::Transparent; //!< Большие страницы для буферов от 2 МБ
+    //! \brief Потоков параллельного суммирования длинных векторов (0 - в потоке сессии).
+    //! Поток сессии тоже участвует, поэтому по умолчанию на один меньше числа ядер
+    unsigned compute_threads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0;
+    //! \brief Наибольший простой соединения между пакетами векторов, с (0 - один пакет на подключение).
+    //! Аутентифицированный клиент отправляет сколько угодно пакетов, не повторяя рукопожатие.
+    //! Включается явно: в режиме blocking ожидающее соединение занимает рабочий поток
+    unsigned keep_alive_sec = 0;
+    unsigned ticket_lifetime_sec = AuthManager::DEFAULT_TICKET_LIFETIME_SEC; //!< Срок действия билета возобновления, с
+    bool watch_user_db = true;           //!< Перечитывать базу пользователей при изменении файла (inotify)
+    IpLimits ip_limits;                  //!< Ограничения подключений с одного IP
+    LoggerOptions log_options;           //!< Параметры журнала (синхронный или фоновый поток записи)
+};
+
+#endif // SERVEROPTIONS_H
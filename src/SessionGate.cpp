@@ -0,0 +1,42 @@
+/*! \file SessionGate.cpp
+ *  \brief Реализация класса SessionGate
+ *  \details Содержит допуск и освобождение мест сессий, общие для всех режимов обслуживания
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "SessionGate.h"
+
+bool SessionGate::admit(int sock, uint32_t address, SessionStats& stats) {
+    if (rate_limiter && rate_limiter->try_acquire(address) != IpVerdict::Allowed) {
+        AdmissionController::reject(sock);
+        SessionStats::add(stats.connections_throttled);
+        return false;
+    }
+    if (admission && !admission->try_admit()) {
+        AdmissionController::reject(sock);
+        SessionStats::add(stats.connections_rejected);
+        // Место по IP уже занято try_acquire() - возвращаем его
+        if (rate_limiter) {
+            rate_limiter->release(address);
+        }
+        return false;
+    }
+    return true;
+}
+
+void SessionGate::release(uint32_t address) {
+    if (admission) {
+        admission->release();
+    }
+    if (rate_limiter) {
+        rate_limiter->release(address);
+    }
+}
+
+void SessionGate::reject(int sock, uint32_t address, SessionStats& stats) {
+    AdmissionController::reject(sock);
+    SessionStats::add(stats.connections_rejected);
+    release(address);
+}
@@ -0,0 +1,51 @@
+#ifndef SESSIONGATE_H
+#define SESSIONGATE_H
+
+#include <cstdint>
+
+#include "AdmissionController.h"
+#include "IpRateLimiter.h"
+#include "SessionStats.h"
+
+//! \brief Допуск принятых подключений
+//! \details Объединяет ограничитель по IP и контроль допуска, чтобы все режимы
+//! обслуживания (блокирующий, epoll, sharded и coro) занимали и освобождали
+//! места одинаково: admit() при accept, release() при закрытии допущенной сессии,
+//! reject() для допущенного подключения, которое не удалось обслужить.
+//! Хранит только указатели на общие объекты сервера и копируется в каждый цикл.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class SessionGate {
+private:
+    AdmissionController* admission;  //!< Контроль допуска (nullptr - без ограничений)
+    IpRateLimiter* rate_limiter;     //!< Ограничитель по IP (nullptr - без ограничений)
+
+public:
+    //! \brief Конструктор
+    //! \param[in] admission Контроль допуска (nullptr - без ограничений)
+    //! \param[in] rate_limiter Ограничитель по IP (nullptr - без ограничений)
+    explicit SessionGate(AdmissionController* admission = nullptr, IpRateLimiter* rate_limiter = nullptr)
+        : admission(admission), rate_limiter(rate_limiter) {}
+
+    //! \brief Допустить принятое подключение
+    //! \details При отказе отправляет "ERR", закрывает сокет и учитывает отказ в stats
+    //! \param[in] sock Сокет клиента
+    //! \param[in] address Адрес клиента из accept() (сетевой порядок)
+    //! \param[in,out] stats Счётчики потока обслуживания
+    //! \return true если подключение допущено; по завершении сессии нужно вызвать release()
+    bool admit(int sock, uint32_t address, SessionStats& stats);
+
+    //! \brief Освободить места допущенной сессии
+    //! \param[in] address Адрес клиента (сетевой порядок)
+    void release(uint32_t address);
+
+    //! \brief Отклонить допущенное подключение (очередь заполнена или сессия отсечена)
+    //! \details Отправляет "ERR", закрывает сокет, учитывает отказ и освобождает места
+    //! \param[in] sock Сокет клиента
+    //! \param[in] address Адрес клиента (сетевой порядок)
+    //! \param[in,out] stats Счётчики потока обслуживания
+    void reject(int sock, uint32_t address, SessionStats& stats);
+};
+
+#endif // SESSIONGATE_H
@@ -0,0 +1,94 @@
+#ifndef SESSIONSTATS_H
+#define SESSIONSTATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//! \brief Снимок счётчиков сессий
+//! \details Обычные значения для агрегации и вывода в журнал
+struct StatsSnapshot {
+    uint64_t connections_accepted = 0; //!< Принято подключений
+    uint64_t connections_closed = 0;   //!< Закрыто подключений
+    uint64_t connections_rejected = 0; //!< Отклонено контролем допуска
+    uint64_t connections_throttled = 0; //!< Отклонено ограничителем по IP
+    uint64_t auth_failures = 0;        //!< Неудачных аутентификаций
+    uint64_t batches_processed = 0;    //!< Обработано пакетов векторов
+    uint64_t vectors_processed = 0;    //!< Обработано векторов
+    uint64_t bytes_received = 0;       //!< Принято байт данных
+    uint64_t bytes_sent = 0;           //!< Отправлено байт результатов
+
+    //! \brief Прибавить счётчики другого снимка
+    //! \param[in] other Снимок
+    //! \return Ссылка на текущий снимок
+    StatsSnapshot& operator+=(const StatsSnapshot& other) {
+        connections_accepted += other.connections_accepted;
+        connections_closed += other.connections_closed;
+        connections_rejected += other.connections_rejected;
+        connections_throttled += other.connections_throttled;
+        auth_failures += other.auth_failures;
+        batches_processed += other.batches_processed;
+        vectors_processed += other.vectors_processed;
+        bytes_received += other.bytes_received;
+        bytes_sent += other.bytes_sent;
+        return *this;
+    }
+
+    //! \brief Сформировать строку для журнала
+    //! \return Текстовое представление счётчиков
+    std::string to_string() const {
+        return "accepted=" + std::to_string(connections_accepted) +
+               " closed=" + std::to_string(connections_closed) +
+               " rejected=" + std::to_string(connections_rejected) +
+               " throttled=" + std::to_string(connections_throttled) +
+               " auth_failures=" + std::to_string(auth_failures) +
+               " batches=" + std::to_string(batches_processed) +
+               " vectors=" + std::to_string(vectors_processed) +
+               " bytes_in=" + std::to_string(bytes_received) +
+               " bytes_out=" + std::to_string(bytes_sent);
+    }
+};
+
+//! \brief Счётчики сессий одного потока обслуживания
+//! \details Каждый цикл событий (шард) владеет своим экземпляром и изменяет его
+//! только из своего потока; другие потоки лишь читают счётчики при агрегации.
+//! Выравнивание по строке кэша исключает ложное разделение между шардами.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+struct alignas(64) SessionStats {
+    std::atomic<uint64_t> connections_accepted{0}; //!< Принято подключений
+    std::atomic<uint64_t> connections_closed{0};   //!< Закрыто подключений
+    std::atomic<uint64_t> connections_rejected{0}; //!< Отклонено контролем допуска
+    std::atomic<uint64_t> connections_throttled{0}; //!< Отклонено ограничителем по IP
+    std::atomic<uint64_t> auth_failures{0};        //!< Неудачных аутентификаций
+    std::atomic<uint64_t> batches_processed{0};    //!< Обработано пакетов векторов
+    std::atomic<uint64_t> vectors_processed{0};    //!< Обработано векторов
+    std::atomic<uint64_t> bytes_received{0};       //!< Принято байт данных
+    std::atomic<uint64_t> bytes_sent{0};           //!< Отправлено байт результатов
+
+    //! \brief Увеличить счётчик
+    //! \param[in,out] counter Счётчик
+    //! \param[in] value Приращение
+    static void add(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    //! \brief Получить снимок счётчиков
+    //! \return Снимок
+    StatsSnapshot snapshot() const {
+        StatsSnapshot s;
+        s.connections_accepted = connections_accepted.load(std::memory_order_relaxed);
+        s.connections_closed = connections_closed.load(std::memory_order_relaxed);
+        s.connections_rejected = connections_rejected.load(std::memory_order_relaxed);
+        s.connections_throttled = connections_throttled.load(std::memory_order_relaxed);
+        s.auth_failures = auth_failures.load(std::memory_order_relaxed);
+        s.batches_processed = batches_processed.load(std::memory_order_relaxed);
+        s.vectors_processed = vectors_processed.load(std::memory_order_relaxed);
+        s.bytes_received = bytes_received.load(std::memory_order_relaxed);
+        s.bytes_sent = bytes_sent.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+#endif // SESSIONSTATS_H
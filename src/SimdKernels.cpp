@@ -0,0 +1,550 @@
+/*! \file SimdKernels.cpp
+ *  \brief Реализация класса SimdKernels
+ *  \details Содержит скалярное, SSE2, AVX2 и AVX-512 ядра суммы квадратов
+ *  для double и float (квадраты float суммируются в double) и слитные ядра,
+ *  вычисляющие все статистики FusedStats за один проход.
+ *  Векторные ядра компилируются с атрибутом target, поэтому сборка не требует
+ *  флагов -m и работает на любом x86-64; без x86 остаётся только скалярное ядро.
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "SimdKernels.h"
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+//! \brief Прочитать элемент без требований к выравниванию
+template<typename T>
+inline double load_double(const T* ptr) {
+    T value;
+    memcpy(&value, ptr, sizeof(value));
+    return static_cast<double>(value);
+}
+
+//! \brief Скалярный эталон: одна сумма, порядок сложения как в исходном цикле
+template<typename T>
+double sum_of_squares_scalar(const T* data, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double val = load_double(data + i);
+        sum += val * val;
+    }
+    return sum;
+}
+
+//! \brief Добавить элемент к статистикам
+inline void fused_step(FusedStats& stats, double val, double shift) {
+    stats.sum += val;
+    stats.sum_squares += val * val;
+    stats.min = std::fmin(stats.min, val);
+    stats.max = std::fmax(stats.max, val);
+    double abs_val = std::fabs(val);
+    stats.abs_sum += abs_val;
+    stats.abs_max = std::fmax(stats.abs_max, abs_val);
+    double shifted = val - shift;
+    stats.shifted_sum += shifted;
+    stats.shifted_squares += shifted * shifted;
+}
+
+//! \brief Добавить к статистикам дорожки векторных регистров
+//! \param[in] lanes Значения дорожек в порядке полей FusedStats
+//! \param[in] width Количество дорожек
+inline void merge_lanes(FusedStats& stats, const double (*lanes)[8], size_t width) {
+    for (size_t lane = 0; lane < width; lane++) {
+        stats.sum += lanes[0][lane];
+        stats.sum_squares += lanes[1][lane];
+        stats.min = std::fmin(stats.min, lanes[2][lane]);
+        stats.max = std::fmax(stats.max, lanes[3][lane]);
+        stats.abs_sum += lanes[4][lane];
+        stats.abs_max = std::fmax(stats.abs_max, lanes[5][lane]);
+        stats.shifted_sum += lanes[6][lane];
+        stats.shifted_squares += lanes[7][lane];
+    }
+}
+
+//! \brief Скалярное слитное ядро
+template<typename T>
+void fused_stats_scalar(const T* data, size_t count, double shift, FusedStats& stats) {
+    for (size_t i = 0; i < count; i++) {
+        fused_step(stats, load_double(data + i), shift);
+    }
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// Немаскированные формы _mm512_cvtps_pd, _mm512_min_pd, _mm512_max_pd,
+// _mm512_extractf64x4_pd и приведений к 256 битам в GCC 12 передают источником
+// слияния неопределённое значение (_mm512_undefined_pd() и подобные),
+// что при -O2 даёт ложное -Wuninitialized. Маскированные формы с полной маской
+// и нулевым источником - те же инструкции без неопределённого значения
+
+//! \brief Преобразовать 8 float в double
+__attribute__((target("avx512f")))
+inline __m512d widen_avx512(__m256 v) {
+    return _mm512_maskz_cvtps_pd(0xFF, v);
+}
+
+//! \brief Поэлементный минимум
+__attribute__((target("avx512f")))
+inline __m512d min_avx512(__m512d a, __m512d b) {
+    return _mm512_maskz_min_pd(0xFF, a, b);
+}
+
+//! \brief Поэлементный максимум
+__attribute__((target("avx512f")))
+inline __m512d max_avx512(__m512d a, __m512d b) {
+    return _mm512_maskz_max_pd(0xFF, a, b);
+}
+
+//! \brief Младшие 8 float вектора
+__attribute__((target("avx512f")))
+inline __m256 low_half_avx512(__m512 v) {
+    return _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(v), 0));
+}
+
+//! \brief Сумма 8 элементов в том же порядке, что и _mm512_reduce_add_pd
+__attribute__((target("avx512f")))
+inline double reduce_add_avx512(__m512d v) {
+    __m256d half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, v, 1), _mm512_maskz_extractf64x4_pd(0xF, v, 0));
+    __m128d quarter = _mm_add_pd(_mm256_extractf128_pd(half, 1), _mm256_castpd256_pd128(half));
+    return _mm_cvtsd_f64(quarter) + _mm_cvtsd_f64(_mm_unpackhi_pd(quarter, quarter));
+}
+
+__attribute__((target("sse2")))
+double sum_of_squares_sse2(const double* data, size_t count) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd();
+    __m128d acc3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128d v0 = _mm_loadu_pd(data + i);
+        __m128d v1 = _mm_loadu_pd(data + i + 2);
+        __m128d v2 = _mm_loadu_pd(data + i + 4);
+        __m128d v3 = _mm_loadu_pd(data + i + 6);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(v0, v0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(v1, v1));
+        acc2 = _mm_add_pd(acc2, _mm_mul_pd(v2, v2));
+        acc3 = _mm_add_pd(acc3, _mm_mul_pd(v3, v3));
+    }
+    __m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double sum = lanes[0] + lanes[1];
+    for (; i < count; i++) {
+        double val = load_double(data + i);
+        sum += val * val;
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+double sum_of_squares_avx2(const double* data, size_t count) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    __m256d acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256d v0 = _mm256_loadu_pd(data + i);
+        __m256d v1 = _mm256_loadu_pd(data + i + 4);
+        __m256d v2 = _mm256_loadu_pd(data + i + 8);
+        __m256d v3 = _mm256_loadu_pd(data + i + 12);
+        acc0 = _mm256_fmadd_pd(v0, v0, acc0);
+        acc1 = _mm256_fmadd_pd(v1, v1, acc1);
+        acc2 = _mm256_fmadd_pd(v2, v2, acc2);
+        acc3 = _mm256_fmadd_pd(v3, v3, acc3);
+    }
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double lanes[2];
+    _mm_storeu_pd(lanes, half);
+    double sum = lanes[0] + lanes[1];
+    for (; i < count; i++) {
+        double val = load_double(data + i);
+        sum += val * val;
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+double sum_of_squares_avx512(const double* data, size_t count) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd();
+    __m512d acc3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512d v0 = _mm512_loadu_pd(data + i);
+        __m512d v1 = _mm512_loadu_pd(data + i + 8);
+        __m512d v2 = _mm512_loadu_pd(data + i + 16);
+        __m512d v3 = _mm512_loadu_pd(data + i + 24);
+        acc0 = _mm512_fmadd_pd(v0, v0, acc0);
+        acc1 = _mm512_fmadd_pd(v1, v1, acc1);
+        acc2 = _mm512_fmadd_pd(v2, v2, acc2);
+        acc3 = _mm512_fmadd_pd(v3, v3, acc3);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m512d v = _mm512_loadu_pd(data + i);
+        acc0 = _mm512_fmadd_pd(v, v, acc0);
+    }
+    // Хвост загружается маской, лишние элементы читаются как нули
+    if (i < count) {
+        __mmask8 mask = static_cast<__mmask8>((1u << (count - i)) - 1);
+        __m512d v = _mm512_maskz_loadu_pd(mask, data + i);
+        acc1 = _mm512_fmadd_pd(v, v, acc1);
+    }
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    return reduce_add_avx512(acc);
+}
+
+__attribute__((target("sse2")))
+double sum_of_squares_float_sse2(const float* data, size_t count) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd();
+    __m128d acc3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 v0 = _mm_loadu_ps(data + i);
+        __m128 v1 = _mm_loadu_ps(data + i + 4);
+        __m128d d0 = _mm_cvtps_pd(v0);
+        __m128d d1 = _mm_cvtps_pd(_mm_movehl_ps(v0, v0));
+        __m128d d2 = _mm_cvtps_pd(v1);
+        __m128d d3 = _mm_cvtps_pd(_mm_movehl_ps(v1, v1));
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+        acc2 = _mm_add_pd(acc2, _mm_mul_pd(d2, d2));
+        acc3 = _mm_add_pd(acc3, _mm_mul_pd(d3, d3));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+    double sum = lanes[0] + lanes[1];
+    for (; i < count; i++) {
+        double val = load_double(data + i);
+        sum += val * val;
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+double sum_of_squares_float_avx2(const float* data, size_t count) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd();
+    __m256d acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 v0 = _mm256_loadu_ps(data + i);
+        __m256 v1 = _mm256_loadu_ps(data + i + 8);
+        __m256d d0 = _mm256_cvtps_pd(_mm256_castps256_ps128(v0));
+        __m256d d1 = _mm256_cvtps_pd(_mm256_extractf128_ps(v0, 1));
+        __m256d d2 = _mm256_cvtps_pd(_mm256_castps256_ps128(v1));
+        __m256d d3 = _mm256_cvtps_pd(_mm256_extractf128_ps(v1, 1));
+        acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+        acc2 = _mm256_fmadd_pd(d2, d2, acc2);
+        acc3 = _mm256_fmadd_pd(d3, d3, acc3);
+    }
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double lanes[2];
+    _mm_storeu_pd(lanes, half);
+    double sum = lanes[0] + lanes[1];
+    for (; i < count; i++) {
+        double val = load_double(data + i);
+        sum += val * val;
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+double sum_of_squares_float_avx512(const float* data, size_t count) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd();
+    __m512d acc3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512d d0 = widen_avx512(_mm256_loadu_ps(data + i));
+        __m512d d1 = widen_avx512(_mm256_loadu_ps(data + i + 8));
+        __m512d d2 = widen_avx512(_mm256_loadu_ps(data + i + 16));
+        __m512d d3 = widen_avx512(_mm256_loadu_ps(data + i + 24));
+        acc0 = _mm512_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm512_fmadd_pd(d1, d1, acc1);
+        acc2 = _mm512_fmadd_pd(d2, d2, acc2);
+        acc3 = _mm512_fmadd_pd(d3, d3, acc3);
+    }
+    // Хвост загружается маской по 8 элементов, лишние элементы читаются как нули
+    for (; i < count; i += 8) {
+        size_t left = count - i < 8 ? count - i : 8;
+        __mmask16 mask = static_cast<__mmask16>((1u << left) - 1);
+        __m512d d = widen_avx512(low_half_avx512(_mm512_maskz_loadu_ps(mask, data + i)));
+        acc0 = _mm512_fmadd_pd(d, d, acc0);
+    }
+    __m512d acc = _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3));
+    return reduce_add_avx512(acc);
+}
+
+template<typename T>
+__attribute__((target("sse2")))
+inline __m128d load2_sse2(const T* ptr) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(ptr))));
+    } else {
+        return _mm_loadu_pd(ptr);
+    }
+}
+
+template<typename T>
+__attribute__((target("sse2")))
+void fused_stats_sse2(const T* data, size_t count, double shift, FusedStats& stats) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d base = _mm_set1_pd(shift);
+    __m128d sum = _mm_setzero_pd();
+    __m128d squares = _mm_setzero_pd();
+    __m128d min = _mm_set1_pd(stats.min);
+    __m128d max = _mm_set1_pd(stats.max);
+    __m128d abs_sum = _mm_setzero_pd();
+    __m128d abs_max = _mm_setzero_pd();
+    __m128d shifted_sum = _mm_setzero_pd();
+    __m128d shifted_squares = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = load2_sse2(data + i);
+        sum = _mm_add_pd(sum, v);
+        squares = _mm_add_pd(squares, _mm_mul_pd(v, v));
+        min = _mm_min_pd(min, v);
+        max = _mm_max_pd(max, v);
+        __m128d a = _mm_andnot_pd(sign, v);
+        abs_sum = _mm_add_pd(abs_sum, a);
+        abs_max = _mm_max_pd(abs_max, a);
+        __m128d d = _mm_sub_pd(v, base);
+        shifted_sum = _mm_add_pd(shifted_sum, d);
+        shifted_squares = _mm_add_pd(shifted_squares, _mm_mul_pd(d, d));
+    }
+    double lanes[8][8];
+    _mm_storeu_pd(lanes[0], sum);
+    _mm_storeu_pd(lanes[1], squares);
+    _mm_storeu_pd(lanes[2], min);
+    _mm_storeu_pd(lanes[3], max);
+    _mm_storeu_pd(lanes[4], abs_sum);
+    _mm_storeu_pd(lanes[5], abs_max);
+    _mm_storeu_pd(lanes[6], shifted_sum);
+    _mm_storeu_pd(lanes[7], shifted_squares);
+    merge_lanes(stats, lanes, 2);
+    for (; i < count; i++) {
+        fused_step(stats, load_double(data + i), shift);
+    }
+}
+
+template<typename T>
+__attribute__((target("avx2,fma")))
+inline __m256d load4_avx2(const T* ptr) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(ptr));
+    } else {
+        return _mm256_loadu_pd(ptr);
+    }
+}
+
+template<typename T>
+__attribute__((target("avx2,fma")))
+void fused_stats_avx2(const T* data, size_t count, double shift, FusedStats& stats) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d base = _mm256_set1_pd(shift);
+    __m256d sum = _mm256_setzero_pd();
+    __m256d squares = _mm256_setzero_pd();
+    __m256d min = _mm256_set1_pd(stats.min);
+    __m256d max = _mm256_set1_pd(stats.max);
+    __m256d abs_sum = _mm256_setzero_pd();
+    __m256d abs_max = _mm256_setzero_pd();
+    __m256d shifted_sum = _mm256_setzero_pd();
+    __m256d shifted_squares = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = load4_avx2(data + i);
+        sum = _mm256_add_pd(sum, v);
+        squares = _mm256_fmadd_pd(v, v, squares);
+        min = _mm256_min_pd(min, v);
+        max = _mm256_max_pd(max, v);
+        __m256d a = _mm256_andnot_pd(sign, v);
+        abs_sum = _mm256_add_pd(abs_sum, a);
+        abs_max = _mm256_max_pd(abs_max, a);
+        __m256d d = _mm256_sub_pd(v, base);
+        shifted_sum = _mm256_add_pd(shifted_sum, d);
+        shifted_squares = _mm256_fmadd_pd(d, d, shifted_squares);
+    }
+    double lanes[8][8];
+    _mm256_storeu_pd(lanes[0], sum);
+    _mm256_storeu_pd(lanes[1], squares);
+    _mm256_storeu_pd(lanes[2], min);
+    _mm256_storeu_pd(lanes[3], max);
+    _mm256_storeu_pd(lanes[4], abs_sum);
+    _mm256_storeu_pd(lanes[5], abs_max);
+    _mm256_storeu_pd(lanes[6], shifted_sum);
+    _mm256_storeu_pd(lanes[7], shifted_squares);
+    merge_lanes(stats, lanes, 4);
+    for (; i < count; i++) {
+        fused_step(stats, load_double(data + i), shift);
+    }
+}
+
+template<typename T>
+__attribute__((target("avx512f")))
+inline __m512d load8_avx512(const T* ptr) {
+    if constexpr (std::is_same_v<T, float>) {
+        return widen_avx512(_mm256_loadu_ps(ptr));
+    } else {
+        return _mm512_loadu_pd(ptr);
+    }
+}
+
+template<typename T>
+__attribute__((target("avx512f")))
+void fused_stats_avx512(const T* data, size_t count, double shift, FusedStats& stats) {
+    const __m512d base = _mm512_set1_pd(shift);
+    __m512d sum = _mm512_setzero_pd();
+    __m512d squares = _mm512_setzero_pd();
+    __m512d min = _mm512_set1_pd(stats.min);
+    __m512d max = _mm512_set1_pd(stats.max);
+    __m512d abs_sum = _mm512_setzero_pd();
+    __m512d abs_max = _mm512_setzero_pd();
+    __m512d shifted_sum = _mm512_setzero_pd();
+    __m512d shifted_squares = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d v = load8_avx512(data + i);
+        sum = _mm512_add_pd(sum, v);
+        squares = _mm512_fmadd_pd(v, v, squares);
+        min = min_avx512(min, v);
+        max = max_avx512(max, v);
+        __m512d a = _mm512_abs_pd(v);
+        abs_sum = _mm512_add_pd(abs_sum, a);
+        abs_max = max_avx512(abs_max, a);
+        __m512d d = _mm512_sub_pd(v, base);
+        shifted_sum = _mm512_add_pd(shifted_sum, d);
+        shifted_squares = _mm512_fmadd_pd(d, d, shifted_squares);
+    }
+    double lanes[8][8];
+    _mm512_storeu_pd(lanes[0], sum);
+    _mm512_storeu_pd(lanes[1], squares);
+    _mm512_storeu_pd(lanes[2], min);
+    _mm512_storeu_pd(lanes[3], max);
+    _mm512_storeu_pd(lanes[4], abs_sum);
+    _mm512_storeu_pd(lanes[5], abs_max);
+    _mm512_storeu_pd(lanes[6], shifted_sum);
+    _mm512_storeu_pd(lanes[7], shifted_squares);
+    merge_lanes(stats, lanes, 8);
+    for (; i < count; i++) {
+        fused_step(stats, load_double(data + i), shift);
+    }
+}
+
+#endif
+
+}
+
+std::atomic<SimdKernels::SumOfSquaresFn> SimdKernels::active(SimdKernels::kernel(SimdKernels::detect()));
+std::atomic<SimdKernels::FloatSumOfSquaresFn> SimdKernels::active_float(SimdKernels::float_kernel(SimdKernels::detect()));
+std::atomic<SimdKernels::FusedStatsFn> SimdKernels::active_fused(SimdKernels::fused_kernel(SimdKernels::detect()));
+std::atomic<SimdKernels::FloatFusedStatsFn> SimdKernels::active_fused_float(
+    SimdKernels::float_fused_kernel(SimdKernels::detect()));
+std::atomic<SimdLevel> SimdKernels::active_level(SimdKernels::detect());
+
+SimdLevel SimdKernels::detect() {
+#ifdef SIMD_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::Avx2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::Sse2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdKernels::SumOfSquaresFn SimdKernels::kernel(SimdLevel level) {
+    if (level != SimdLevel::Scalar && static_cast<int>(level) > static_cast<int>(detect())) {
+        return nullptr;
+    }
+    switch (level) {
+#ifdef SIMD_KERNELS_X86
+        case SimdLevel::Sse2: return sum_of_squares_sse2;
+        case SimdLevel::Avx2: return sum_of_squares_avx2;
+        case SimdLevel::Avx512: return sum_of_squares_avx512;
+#endif
+        default: return sum_of_squares_scalar<double>;
+    }
+}
+
+SimdKernels::FloatSumOfSquaresFn SimdKernels::float_kernel(SimdLevel level) {
+    if (level != SimdLevel::Scalar && static_cast<int>(level) > static_cast<int>(detect())) {
+        return nullptr;
+    }
+    switch (level) {
+#ifdef SIMD_KERNELS_X86
+        case SimdLevel::Sse2: return sum_of_squares_float_sse2;
+        case SimdLevel::Avx2: return sum_of_squares_float_avx2;
+        case SimdLevel::Avx512: return sum_of_squares_float_avx512;
+#endif
+        default: return sum_of_squares_scalar<float>;
+    }
+}
+
+SimdKernels::FusedStatsFn SimdKernels::fused_kernel(SimdLevel level) {
+    if (level != SimdLevel::Scalar && static_cast<int>(level) > static_cast<int>(detect())) {
+        return nullptr;
+    }
+    switch (level) {
+#ifdef SIMD_KERNELS_X86
+        case SimdLevel::Sse2: return fused_stats_sse2<double>;
+        case SimdLevel::Avx2: return fused_stats_avx2<double>;
+        case SimdLevel::Avx512: return fused_stats_avx512<double>;
+#endif
+        default: return fused_stats_scalar<double>;
+    }
+}
+
+SimdKernels::FloatFusedStatsFn SimdKernels::float_fused_kernel(SimdLevel level) {
+    if (level != SimdLevel::Scalar && static_cast<int>(level) > static_cast<int>(detect())) {
+        return nullptr;
+    }
+    switch (level) {
+#ifdef SIMD_KERNELS_X86
+        case SimdLevel::Sse2: return fused_stats_sse2<float>;
+        case SimdLevel::Avx2: return fused_stats_avx2<float>;
+        case SimdLevel::Avx512: return fused_stats_avx512<float>;
+#endif
+        default: return fused_stats_scalar<float>;
+    }
+}
+
+bool SimdKernels::set_level(SimdLevel level) {
+    SumOfSquaresFn fn = kernel(level);
+    if (!fn) {
+        return false;
+    }
+    active.store(fn, std::memory_order_relaxed);
+    active_float.store(float_kernel(level), std::memory_order_relaxed);
+    active_fused.store(fused_kernel(level), std::memory_order_relaxed);
+    active_fused_float.store(float_fused_kernel(level), std::memory_order_relaxed);
+    active_level.store(level, std::memory_order_relaxed);
+    return true;
+}
+
+const char* SimdKernels::level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Sse2: return "sse2";
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Avx512: return "avx512";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+//! \brief Набор векторных инструкций для вычислительных ядер
+enum class SimdLevel {
+    Scalar,  //!< Скалярный эталон
+    Sse2,    //!< SSE2, 128-битные регистры
+    Avx2,    //!< AVX2 + FMA, 256-битные регистры
+    Avx512   //!< AVX-512F, 512-битные регистры
+};
+
+//! \brief Статистики элементов, вычисляемые слитным ядром за один проход
+//! \details Сдвинутые суммы считаются по x - shift: с shift, равным первому элементу
+//! вектора, дисперсия не теряет точность при большом среднем
+struct FusedStats {
+    double sum = 0.0;                                            //!< Сумма
+    double sum_squares = 0.0;                                    //!< Сумма квадратов
+    double min = std::numeric_limits<double>::infinity();        //!< Минимум
+    double max = -std::numeric_limits<double>::infinity();       //!< Максимум
+    double abs_sum = 0.0;                                        //!< Сумма модулей (норма L1)
+    double abs_max = 0.0;                                        //!< Наибольший модуль (норма L∞)
+    double shifted_sum = 0.0;                                    //!< Сумма x - shift
+    double shifted_squares = 0.0;                                //!< Сумма (x - shift)^2
+};
+
+//! \brief Ядра суммы квадратов с выбором по CPUID
+//! \details Каждое ядро ведёт несколько независимых сумм, чтобы скрыть задержку
+//! сложения, и не проверяет переполнение поэлементно: квадраты неотрицательны,
+//! поэтому переполнение или NaN на входе дают нефинитный результат, который
+//! проверяется один раз на блок (см. SquareSumAccumulator). Ядро выбирается
+//! при запуске по возможностям процессора. Ядра читают данные без требований
+//! к выравниванию.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class SimdKernels {
+public:
+    //! \brief Тип ядра: сумма квадратов count элементов
+    using SumOfSquaresFn = double (*)(const double* data, size_t count);
+
+    //! \brief Тип ядра для float: квадраты суммируются в double
+    using FloatSumOfSquaresFn = double (*)(const float* data, size_t count);
+
+    //! \brief Тип слитного ядра: добавить к stats статистики count элементов
+    using FusedStatsFn = void (*)(const double* data, size_t count, double shift, FusedStats& stats);
+
+    //! \brief Тип слитного ядра для float
+    using FloatFusedStatsFn = void (*)(const float* data, size_t count, double shift, FusedStats& stats);
+
+private:
+    static std::atomic<SumOfSquaresFn> active;  //!< Выбранное ядро
+    static std::atomic<FloatSumOfSquaresFn> active_float; //!< Выбранное ядро для float
+    static std::atomic<FusedStatsFn> active_fused; //!< Выбранное слитное ядро
+    static std::atomic<FloatFusedStatsFn> active_fused_float; //!< Выбранное слитное ядро для float
+    static std::atomic<SimdLevel> active_level; //!< Набор инструкций выбранного ядра
+
+public:
+    //! \brief Определить лучший набор инструкций процессора
+    //! \return Набор инструкций
+    static SimdLevel detect();
+
+    //! \brief Получить ядро набора инструкций
+    //! \param[in] level Набор инструкций
+    //! \return Ядро или nullptr, если процессор его не поддерживает
+    static SumOfSquaresFn kernel(SimdLevel level);
+
+    //! \brief Получить ядро набора инструкций для float
+    //! \param[in] level Набор инструкций
+    //! \return Ядро или nullptr, если процессор его не поддерживает
+    static FloatSumOfSquaresFn float_kernel(SimdLevel level);
+
+    //! \brief Получить слитное ядро набора инструкций
+    //! \param[in] level Набор инструкций
+    //! \return Ядро или nullptr, если процессор его не поддерживает
+    static FusedStatsFn fused_kernel(SimdLevel level);
+
+    //! \brief Получить слитное ядро набора инструкций для float
+    //! \param[in] level Набор инструкций
+    //! \return Ядро или nullptr, если процессор его не поддерживает
+    static FloatFusedStatsFn float_fused_kernel(SimdLevel level);
+
+    //! \brief Выбрать ядро
+    //! \param[in] level Набор инструкций
+    //! \return true если процессор поддерживает набор и ядро выбрано
+    static bool set_level(SimdLevel level);
+
+    //! \brief Получить набор инструкций выбранного ядра
+    //! \return Набор инструкций
+    static SimdLevel get_level() { return active_level.load(std::memory_order_relaxed); }
+
+    //! \brief Получить название набора инструкций
+    //! \param[in] level Набор инструкций
+    //! \return Название ("scalar", "sse2", "avx2", "avx512")
+    static const char* level_name(SimdLevel level);
+
+    //! \brief Вычислить сумму квадратов выбранным ядром
+    //! \param[in] data Элементы (выравнивание не требуется)
+    //! \param[in] count Количество элементов
+    //! \return Сумма квадратов; inf или NaN при переполнении или нефинитных элементах
+    static double sum_of_squares(const double* data, size_t count) {
+        return active.load(std::memory_order_relaxed)(data, count);
+    }
+
+    //! \brief Вычислить сумму квадратов float выбранным ядром
+    //! \param[in] data Элементы (выравнивание не требуется)
+    //! \param[in] count Количество элементов
+    //! \return Сумма квадратов в double; inf или NaN при нефинитных элементах
+    static double sum_of_squares(const float* data, size_t count) {
+        return active_float.load(std::memory_order_relaxed)(data, count);
+    }
+
+    //! \brief Добавить статистики элементов выбранным слитным ядром
+    //! \param[in] data Элементы (выравнивание не требуется)
+    //! \param[in] count Количество элементов
+    //! \param[in] shift Сдвиг для сдвинутых сумм
+    //! \param[in,out] stats Накопленные статистики
+    static void fused_stats(const double* data, size_t count, double shift, FusedStats& stats) {
+        active_fused.load(std::memory_order_relaxed)(data, count, shift, stats);
+    }
+
+    //! \brief Добавить статистики элементов float выбранным слитным ядром
+    //! \param[in] data Элементы (выравнивание не требуется)
+    //! \param[in] count Количество элементов
+    //! \param[in] shift Сдвиг для сдвинутых сумм
+    //! \param[in,out] stats Накопленные статистики
+    static void fused_stats(const float* data, size_t count, double shift, FusedStats& stats) {
+        active_fused_float.load(std::memory_order_relaxed)(data, count, shift, stats);
+    }
+};
+
+#endif // SIMDKERNELS_H
@@ -0,0 +1,122 @@
+/*! \file UserDbWatcher.cpp
+ *  \brief Реализация класса UserDbWatcher
+ *  \details Содержит наблюдение за файлом базы пользователей через inotify и eventfd
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "UserDbWatcher.h"
+#include "AuthManager.h"
+#include "Logger.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+UserDbWatcher::UserDbWatcher(AuthManager& auth_manager, Logger& logger, const std::string& user_db_file,
+                             bool watch_file)
+    : auth_manager(auth_manager), logger(logger), inotify_fd(-1), wake_fd(-1), running(true) {
+    size_t slash = user_db_file.rfind('/');
+    directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : user_db_file.substr(0, slash));
+    file_name = slash == std::string::npos ? user_db_file : user_db_file.substr(slash + 1);
+    
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        throw std::runtime_error("eventfd failed: " + std::string(strerror(errno)));
+    }
+    
+    if (watch_file) {
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        // Редакторы и деплой обычно заменяют файл переименованием, поэтому следим за каталогом
+        if (inotify_fd < 0 ||
+            inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            logger.log("Cannot watch user database with inotify (" + std::string(strerror(errno)) +
+                       "), reloading on SIGHUP only");
+            if (inotify_fd >= 0) {
+                close(inotify_fd);
+                inotify_fd = -1;
+            }
+        }
+    }
+    
+    thread = std::thread(&UserDbWatcher::run, this);
+}
+
+UserDbWatcher::~UserDbWatcher() {
+    stop();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+    }
+    close(wake_fd);
+}
+
+void UserDbWatcher::request_reload() {
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void)written;
+}
+
+void UserDbWatcher::stop() {
+    running = false;
+    request_reload();
+}
+
+bool UserDbWatcher::drain_inotify() {
+    alignas(struct inotify_event) char buffer[4096];
+    bool changed = false;
+    while (true) {
+        ssize_t len = read(inotify_fd, buffer, sizeof(buffer));
+        if (len <= 0) {
+            return changed;
+        }
+        for (ssize_t offset = 0; offset < len;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            if (event->len > 0 && file_name == event->name) {
+                changed = true;
+            }
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+void UserDbWatcher::run() {
+    struct pollfd fds[2];
+    fds[0].fd = wake_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = inotify_fd;
+    fds[1].events = POLLIN;
+    nfds_t count = inotify_fd >= 0 ? 2 : 1;
+    
+    while (running) {
+        fds[0].revents = fds[1].revents = 0;
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger.log_error("User database watcher poll failed: " + std::string(strerror(errno)));
+            return;
+        }
+        bool reload = false;
+        if (fds[0].revents & POLLIN) {
+            uint64_t requests;
+            ssize_t received = read(wake_fd, &requests, sizeof(requests));
+            (void)received;
+            reload = true;
+        }
+        if (count > 1 && (fds[1].revents & POLLIN)) {
+            reload = drain_inotify() || reload;
+        }
+        if (reload && running) {
+            auth_manager.reload_users(logger);
+        }
+    }
+}
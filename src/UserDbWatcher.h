@@ -0,0 +1,61 @@
+#ifndef USERDBWATCHER_H
+#define USERDBWATCHER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+class AuthManager;
+class Logger;
+
+//! \brief Фоновая перезагрузка базы пользователей
+//! \details Поток ждёт изменения файла базы (inotify на каталоге файла, чтобы
+//! замечать и запись на месте, и замену переименованием) или запроса
+//! request_reload() (SIGHUP) и вызывает AuthManager::reload_users().
+//! Проверки учётных данных в это время продолжаются по прежнему снимку базы.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class UserDbWatcher {
+private:
+    AuthManager& auth_manager;   //!< Менеджер аутентификации
+    Logger& logger;              //!< Логгер
+    std::string directory;       //!< Каталог файла базы
+    std::string file_name;       //!< Имя файла базы в каталоге
+    int inotify_fd;              //!< Дескриптор inotify (-1 - только по запросу)
+    int wake_fd;                 //!< eventfd запросов перезагрузки и остановки
+    std::atomic<bool> running;   //!< Флаг работы потока
+    std::thread thread;          //!< Поток наблюдения
+
+    //! \brief Цикл потока наблюдения
+    void run();
+
+    //! \brief Прочитать события inotify
+    //! \return true если среди них есть изменение файла базы
+    bool drain_inotify();
+
+public:
+    //! \brief Конструктор, запускает поток наблюдения
+    //! \param[in] auth_manager Менеджер аутентификации с загруженной базой
+    //! \param[in] logger Логгер
+    //! \param[in] user_db_file Файл базы пользователей
+    //! \param[in] watch_file Следить за файлом через inotify (иначе - только request_reload())
+    //! \throw std::runtime_error При ошибке создания eventfd
+    UserDbWatcher(AuthManager& auth_manager, Logger& logger, const std::string& user_db_file, bool watch_file);
+
+    //! \brief Деструктор, останавливает и дожидается потока
+    ~UserDbWatcher();
+
+    UserDbWatcher(const UserDbWatcher&) = delete;
+    UserDbWatcher& operator=(const UserDbWatcher&) = delete;
+
+    //! \brief Запросить перезагрузку базы
+    //! \details Допускается вызов из обработчика сигнала
+    void request_reload();
+
+    //! \brief Запросить остановку потока
+    //! \details Допускается вызов из обработчика сигнала
+    void stop();
+};
+
+#endif // USERDBWATCHER_H
@@ -0,0 +1,271 @@
+/*! \file UserStore.cpp
+ *  \brief Реализация класса UserStore
+ *  \details Содержит разбор текстовой базы, сборку упакованного образа и отображение двоичной базы
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "UserStore.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+//! \brief Убрать пробелы и табуляции по краям
+std::string_view trim(std::string_view text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(start, end - start + 1);
+}
+
+} // namespace
+
+UserStore::UserStore()
+    : mapping(nullptr), mapping_size(0), header(nullptr), slots(nullptr), strings(nullptr) {}
+
+UserStore::~UserStore() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+    }
+}
+
+uint64_t UserStore::hash_login(std::string_view login) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : login) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    // Младшие биты FNV-1a плохо перемешаны для логинов с общим префиксом,
+    // а слот выбирается именно по ним - добавляем финальное перемешивание
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+void UserStore::attach(const char* data, size_t size) {
+    if (size < sizeof(UserStoreHeader)) {
+        throw std::runtime_error("truncated header");
+    }
+    header = reinterpret_cast<const UserStoreHeader*>(data);
+    if (memcmp(header->magic, USER_STORE_MAGIC, sizeof(header->magic)) != 0) {
+        throw std::runtime_error("bad signature");
+    }
+    if (header->version != USER_STORE_VERSION) {
+        throw std::runtime_error("unsupported version " + std::to_string(header->version));
+    }
+    uint64_t slot_count = header->slot_count;
+    if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 || header->user_count > slot_count / 2) {
+        throw std::runtime_error("bad slot table");
+    }
+    uint64_t slots_end = sizeof(UserStoreHeader) + slot_count * sizeof(UserStoreSlot);
+    if (slots_end > size || header->strings_offset < slots_end ||
+        header->strings_offset > size || header->strings_size > size - header->strings_offset) {
+        throw std::runtime_error("section out of bounds");
+    }
+    slots = reinterpret_cast<const UserStoreSlot*>(data + sizeof(UserStoreHeader));
+    strings = data + header->strings_offset;
+}
+
+void UserStore::map_file(int fd, size_t size, const std::string& filename) {
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map user database " + filename + ": " + strerror(errno));
+    }
+    mapping = data;
+    mapping_size = size;
+    try {
+        attach(static_cast<const char*>(data), size);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Corrupted user database " + filename + ": " + e.what());
+    }
+}
+
+bool UserStore::find(std::string_view login, std::string_view& password) const {
+    if (!header || login.empty()) {
+        return false;
+    }
+    uint64_t hash = hash_login(login);
+    uint32_t mask = header->slot_count - 1;
+    for (uint32_t index = static_cast<uint32_t>(hash) & mask, probes = 0; probes <= mask;
+         index = (index + 1) & mask, probes++) {
+        const UserStoreSlot& slot = slots[index];
+        if (slot.login_length == 0) {
+            return false;
+        }
+        if (slot.hash != hash || slot.login_length != login.size()) {
+            continue;
+        }
+        // Смещения файла не доверяем: слот может указывать за пределы строк
+        uint64_t end = uint64_t(slot.offset) + slot.login_length + slot.password_length;
+        if (end > header->strings_size) {
+            return false;
+        }
+        if (memcmp(strings + slot.offset, login.data(), login.size()) == 0) {
+            password = std::string_view(strings + slot.offset + slot.login_length, slot.password_length);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::pair<std::string, std::string>> UserStore::parse_text(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open user database: " + filename);
+    }
+
+    std::vector<std::pair<std::string, std::string>> users;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string_view trimmed = trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+
+        size_t colon_pos = trimmed.find(':');
+        if (colon_pos == std::string_view::npos) continue;
+
+        std::string_view login = trim(trimmed.substr(0, colon_pos));
+        std::string_view password = trim(trimmed.substr(colon_pos + 1));
+        if (login.empty()) {
+            std::cerr << "WARNING: Skipping invalid line in user database: Empty login in database" << std::endl;
+            continue;
+        }
+        if (login.size() > MAX_FIELD_LENGTH || password.size() > MAX_FIELD_LENGTH) {
+            std::cerr << "WARNING: Skipping invalid line in user database: Field too long" << std::endl;
+            continue;
+        }
+        users.emplace_back(login, password);
+    }
+    return users;
+}
+
+std::shared_ptr<const UserStore> UserStore::build(const std::vector<std::pair<std::string, std::string>>& users) {
+    // Повторы логина занимают один слот, поэтому их строки не копируются
+    std::unordered_map<std::string_view, std::string_view> unique;
+    unique.reserve(users.size());
+    for (const auto& [login, password] : users) {
+        unique[login] = password;
+    }
+
+    uint64_t slot_count = 16;
+    while (slot_count < 2 * unique.size()) {
+        slot_count *= 2;
+    }
+    if (slot_count > UINT32_MAX) {
+        throw std::runtime_error("Too many users for the user store");
+    }
+    size_t strings_offset = sizeof(UserStoreHeader) + slot_count * sizeof(UserStoreSlot);
+    size_t strings_size = 0;
+    for (const auto& [login, password] : unique) {
+        strings_size += login.size() + password.size();
+    }
+    if (strings_size > UINT32_MAX) {
+        throw std::runtime_error("User store strings exceed 4 GB");
+    }
+
+    std::shared_ptr<UserStore> store(new UserStore());
+    store->image.assign(strings_offset + strings_size, '\0');
+    char* data = store->image.data();
+
+    UserStoreHeader header_data;
+    memset(&header_data, 0, sizeof(header_data));
+    memcpy(header_data.magic, USER_STORE_MAGIC, sizeof(header_data.magic));
+    header_data.version = USER_STORE_VERSION;
+    header_data.slot_count = static_cast<uint32_t>(slot_count);
+    header_data.user_count = unique.size();
+    header_data.strings_offset = strings_offset;
+    header_data.strings_size = strings_size;
+    memcpy(data, &header_data, sizeof(header_data));
+
+    auto* slot_table = reinterpret_cast<UserStoreSlot*>(data + sizeof(UserStoreHeader));
+    uint32_t mask = static_cast<uint32_t>(slot_count - 1);
+    size_t offset = 0;
+    for (const auto& [login, password] : unique) {
+        uint64_t hash = hash_login(login);
+        uint32_t index = static_cast<uint32_t>(hash) & mask;
+        while (slot_table[index].login_length != 0) {
+            index = (index + 1) & mask;
+        }
+        slot_table[index] = {hash, static_cast<uint32_t>(offset), static_cast<uint16_t>(login.size()),
+                             static_cast<uint16_t>(password.size())};
+        memcpy(data + strings_offset + offset, login.data(), login.size());
+        memcpy(data + strings_offset + offset + login.size(), password.data(), password.size());
+        offset += login.size() + password.size();
+    }
+
+    store->attach(data, store->image.size());
+    return store;
+}
+
+std::shared_ptr<const UserStore> UserStore::open(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open user database: " + filename);
+    }
+
+    std::shared_ptr<const UserStore> store;
+    try {
+        struct stat st;
+        char magic[sizeof(USER_STORE_MAGIC)] = {0};
+        if (fstat(fd, &st) == 0 && pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+            memcmp(magic, USER_STORE_MAGIC, sizeof(magic)) == 0) {
+            std::shared_ptr<UserStore> mapped(new UserStore());
+            mapped->map_file(fd, static_cast<size_t>(st.st_size), filename);
+            store = mapped;
+        } else {
+            store = build(parse_text(filename));
+        }
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+
+    if (store->size() == 0) {
+        throw std::runtime_error("No valid users found in database");
+    }
+    return store;
+}
+
+size_t UserStore::compile(const std::string& text_file, const std::string& binary_file) {
+    auto store = build(parse_text(text_file));
+    if (store->size() == 0) {
+        throw std::runtime_error("No valid users found in database");
+    }
+    store->write(binary_file);
+    return store->size();
+}
+
+void UserStore::write(const std::string& filename) const {
+    // Запись во временный файл и переименование: работающий сервер не увидит файл наполовину
+    std::string temp_name = filename + ".tmp";
+    {
+        std::ofstream file(temp_name, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Cannot create user store: " + temp_name);
+        }
+        size_t size = mapping ? mapping_size : image.size();
+        file.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(size));
+        if (!file) {
+            throw std::runtime_error("Cannot write user store: " + temp_name);
+        }
+    }
+    if (rename(temp_name.c_str(), filename.c_str()) != 0) {
+        unlink(temp_name.c_str());
+        throw std::runtime_error("Cannot rename user store to " + filename + ": " + strerror(errno));
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! \brief Заголовок двоичной базы пользователей
+//! \details Файл: заголовок (64 байта), таблица слотов UserStoreSlot,
+//! затем упакованные строки - логин и сразу за ним пароль каждого пользователя.
+//! Все числа - в порядке байт хоста, собравшего файл
+struct UserStoreHeader {
+    char magic[8];           //!< USER_STORE_MAGIC
+    uint32_t version;        //!< USER_STORE_VERSION
+    uint32_t slot_count;     //!< Количество слотов (степень двойки)
+    uint64_t user_count;     //!< Количество пользователей
+    uint64_t strings_offset; //!< Смещение строк от начала файла
+    uint64_t strings_size;   //!< Размер строк, байт
+    uint8_t reserved[24];    //!< Резерв (нули), выравнивает слоты по 64 байта
+};
+
+//! \brief Слот открытой адресации двоичной базы
+//! \details Пустой слот имеет login_length == 0
+struct UserStoreSlot {
+    uint64_t hash;             //!< Хеш логина
+    uint32_t offset;           //!< Смещение логина в строках
+    uint16_t login_length;     //!< Длина логина
+    uint16_t password_length;  //!< Длина пароля (следует сразу за логином)
+};
+
+static_assert(sizeof(UserStoreHeader) == 64, "UserStoreHeader must match the file layout");
+static_assert(sizeof(UserStoreSlot) == 16, "UserStoreSlot must match the file layout");
+
+//! \brief Неизменяемая база пользователей в упакованном виде
+//! \details Хеш-таблица с открытой адресацией (заполнение не больше половины)
+//! над упакованными строками. Поиск читает слот и строку логина с паролем -
+//! обычно две строки кэша. Двоичный файл отображается в память без разбора,
+//! текстовый файл "логин:пароль" собирается в тот же образ в памяти.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class UserStore {
+public:
+    static constexpr char USER_STORE_MAGIC[8] = {'V', 'S', 'U', 'S', 'E', 'R', 'S', '\0'}; //!< Сигнатура файла
+    static constexpr uint32_t USER_STORE_VERSION = 1;  //!< Версия формата
+    static constexpr size_t MAX_FIELD_LENGTH = 0xFFFF; //!< Наибольшая длина логина или пароля
+
+private:
+    std::vector<char> image;      //!< Образ, собранный в памяти (пустой при отображении файла)
+    void* mapping;                //!< Отображение двоичного файла (nullptr - образ в памяти)
+    size_t mapping_size;          //!< Размер отображения
+    const UserStoreHeader* header; //!< Заголовок образа
+    const UserStoreSlot* slots;   //!< Слоты
+    const char* strings;          //!< Упакованные строки
+
+    UserStore();
+
+    //! \brief Установить указатели на части образа и проверить заголовок
+    //! \param[in] data Начало образа
+    //! \param[in] size Размер образа
+    //! \throw std::runtime_error Если образ повреждён
+    void attach(const char* data, size_t size);
+
+    //! \brief Отобразить двоичный файл в память
+    //! \param[in] fd Открытый файл
+    //! \param[in] size Размер файла
+    //! \param[in] filename Имя файла для сообщений
+    //! \throw std::runtime_error При ошибке mmap или повреждённом файле
+    void map_file(int fd, size_t size, const std::string& filename);
+
+    //! \brief Разобрать текстовый файл "логин:пароль"
+    //! \param[in] filename Имя файла
+    //! \return Пары логин-пароль в порядке файла
+    //! \throw std::runtime_error При ошибке чтения файла
+    static std::vector<std::pair<std::string, std::string>> parse_text(const std::string& filename);
+
+public:
+    //! \brief Деструктор, снимает отображение файла
+    ~UserStore();
+
+    UserStore(const UserStore&) = delete;
+    UserStore& operator=(const UserStore&) = delete;
+
+    //! \brief Хеш логина (FNV-1a, 64 бита, с финальным перемешиванием)
+    //! \param[in] login Логин
+    //! \return Хеш
+    static uint64_t hash_login(std::string_view login);
+
+    //! \brief Открыть базу пользователей
+    //! \details Файл с сигнатурой USER_STORE_MAGIC отображается в память,
+    //! иначе разбирается как текст
+    //! \param[in] filename Имя файла
+    //! \return База
+    //! \throw std::runtime_error При ошибке чтения, повреждённом файле или отсутствии пользователей
+    static std::shared_ptr<const UserStore> open(const std::string& filename);
+
+    //! \brief Собрать базу из пар логин-пароль
+    //! \details При повторе логина действует последняя пара
+    //! \param[in] users Пары логин-пароль
+    //! \return База в памяти
+    static std::shared_ptr<const UserStore> build(const std::vector<std::pair<std::string, std::string>>& users);
+
+    //! \brief Преобразовать текстовую базу в двоичную
+    //! \param[in] text_file Текстовый файл "логин:пароль"
+    //! \param[in] binary_file Файл для записи
+    //! \return Количество пользователей
+    //! \throw std::runtime_error При ошибке чтения или записи
+    static size_t compile(const std::string& text_file, const std::string& binary_file);
+
+    //! \brief Записать образ базы в файл
+    //! \param[in] filename Имя файла
+    //! \throw std::runtime_error При ошибке записи
+    void write(const std::string& filename) const;
+
+    //! \brief Найти пароль пользователя
+    //! \param[in] login Логин
+    //! \param[out] password Пароль (указывает в образ базы)
+    //! \return true если пользователь найден
+    bool find(std::string_view login, std::string_view& password) const;
+
+    //! \brief Проверить наличие пользователя
+    //! \param[in] login Логин
+    //! \return true если пользователь найден
+    bool contains(std::string_view login) const {
+        std::string_view password;
+        return find(login, password);
+    }
+
+    //! \brief Получить количество пользователей
+    //! \return Количество пользователей
+    size_t size() const { return header ? header->user_count : 0; }
+
+    //! \brief Проверить, отображён ли файл в память
+    //! \return true для двоичной базы
+    bool is_mapped() const { return mapping != nullptr; }
+};
+
+#endif // USERSTORE_H
@@ -0,0 +1,189 @@
+/*! \file VectorStats.cpp
+ *  \brief Реализация класса StatsAccumulator
+ *  \details Содержит накопление статистик вектора и запись результатов по маске операций
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "VectorStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+//! \brief Записать значение в буфер результатов
+//! \param[in] swap_bytes Записать в обратном порядке байт
+template<typename V>
+void put(char*& out, V value, bool swap_bytes) {
+    memcpy(out, &value, sizeof(value));
+    if (swap_bytes) {
+        std::reverse(out, out + sizeof(value));
+    }
+    out += sizeof(value);
+}
+
+//! \brief Ограничить целое значение диапазоном T
+template<typename T, typename V>
+T saturate(V value) {
+    if (value > static_cast<V>(std::numeric_limits<T>::max())) {
+        return std::numeric_limits<T>::max();
+    }
+    if constexpr (std::is_signed_v<V>) {
+        if (value < static_cast<V>(std::numeric_limits<T>::min())) {
+            return std::numeric_limits<T>::min();
+        }
+    }
+    return static_cast<T>(value);
+}
+
+//! \brief Привести значение с плавающей точкой к T
+//! \throw std::overflow_error При inf/nan (для double - при переполнении)
+template<typename T>
+T narrow(double value) {
+    if constexpr (std::is_same_v<T, double>) {
+        return DataCalculator::handle_overflow(value);
+    } else {
+        if (!std::isfinite(value)) {
+            throw std::overflow_error("Invalid floating point value detected");
+        }
+        const double max_value = std::numeric_limits<T>::max();
+        return static_cast<T>(std::clamp(value, -max_value, max_value));
+    }
+}
+
+//! \brief Проверить среднее или дисперсию
+//! \throw std::overflow_error При inf/nan
+double checked(double value) {
+    if (!std::isfinite(value)) {
+        throw std::overflow_error("Invalid floating point value detected");
+    }
+    return value;
+}
+
+}
+
+template<typename T>
+void StatsAccumulator<T>::add(const T* data, size_t size) {
+    if (mask == STAT_SUM_OF_SQUARES) {
+        squares.add(data, size);
+        return;
+    }
+    if (size == 0) {
+        return;
+    }
+    if (count == 0) {
+        T first;
+        memcpy(&first, data, sizeof(first));
+        shift = static_cast<double>(first);
+    }
+    count += size;
+
+    if constexpr (std::is_integral_v<T>) {
+        const Accumulator limit = static_cast<Accumulator>(std::numeric_limits<T>::max());
+        for (size_t i = 0; i < size; i++) {
+            T val;
+            memcpy(&val, data + i, sizeof(val));
+            stats.sum += val;
+            // Как в SquareSumAccumulator: после насыщения квадраты не прибавляются
+            if (stats.sum_squares <= limit) {
+                Accumulator wide = static_cast<Accumulator>(val);
+                stats.sum_squares += wide * wide;
+            }
+            stats.min = std::min(stats.min, val);
+            stats.max = std::max(stats.max, val);
+            unsigned __int128 magnitude = val < 0 ? static_cast<unsigned __int128>(-static_cast<__int128>(val))
+                                                  : static_cast<unsigned __int128>(val);
+            stats.abs_sum += magnitude;
+            stats.abs_max = std::max(stats.abs_max, magnitude);
+            double shifted = static_cast<double>(val) - shift;
+            stats.shifted_sum += shifted;
+            stats.shifted_squares += shifted * shifted;
+        }
+    } else {
+        SimdKernels::fused_stats(data, size, shift, stats);
+        if ((mask & STAT_SUM_OF_SQUARES) && !std::isfinite(stats.sum_squares)) {
+            throw std::overflow_error("Potential overflow in sum accumulation");
+        }
+    }
+}
+
+template<typename T>
+void StatsAccumulator<T>::add_unaligned(const char* bytes, size_t size) {
+    // Ядра и целочисленный цикл читают без требований к выравниванию
+    add(reinterpret_cast<const T*>(bytes), size);
+}
+
+template<typename T>
+size_t StatsAccumulator<T>::write_results(char* out, bool swap_bytes) const {
+    char* begin = out;
+    if (mask == STAT_SUM_OF_SQUARES) {
+        put(out, squares.result(), swap_bytes);
+        return out - begin;
+    }
+
+    if constexpr (!std::is_integral_v<T>) {
+        // NaN на входе даёт NaN в сумме, бесконечность - в наибольшем модуле
+        if (std::isnan(stats.sum) || std::isinf(stats.abs_max)) {
+            throw std::overflow_error("Invalid floating point value detected");
+        }
+    }
+
+    const double n = static_cast<double>(count);
+    for (unsigned bit = 0; bit < 8; bit++) {
+        switch (mask & (1u << bit)) {
+            case STAT_SUM_OF_SQUARES:
+                if constexpr (std::is_integral_v<T>) put(out, saturate<T>(stats.sum_squares), swap_bytes);
+                else put(out, narrow<T>(stats.sum_squares), swap_bytes);
+                break;
+            case STAT_SUM:
+                if constexpr (std::is_integral_v<T>) put(out, saturate<T>(stats.sum), swap_bytes);
+                else put(out, narrow<T>(stats.sum), swap_bytes);
+                break;
+            case STAT_MIN:
+                put(out, count > 0 ? static_cast<T>(stats.min) : T(0), swap_bytes);
+                break;
+            case STAT_MAX:
+                put(out, count > 0 ? static_cast<T>(stats.max) : T(0), swap_bytes);
+                break;
+            case STAT_MEAN:
+                put(out, count > 0 ? checked(static_cast<double>(stats.sum) / n) : 0.0, swap_bytes);
+                break;
+            case STAT_VARIANCE:
+                put(out, count > 0 ? checked(std::max(0.0, (stats.shifted_squares -
+                                                           stats.shifted_sum * stats.shifted_sum / n) / n))
+                                   : 0.0, swap_bytes);
+                break;
+            case STAT_L1_NORM:
+                if constexpr (std::is_integral_v<T>) put(out, saturate<T>(stats.abs_sum), swap_bytes);
+                else put(out, narrow<T>(stats.abs_sum), swap_bytes);
+                break;
+            case STAT_LINF_NORM:
+                if constexpr (std::is_integral_v<T>) put(out, saturate<T>(stats.abs_max), swap_bytes);
+                else put(out, static_cast<T>(stats.abs_max), swap_bytes);
+                break;
+            default:
+                break;
+        }
+    }
+    return out - begin;
+}
+
+template<typename T>
+size_t StatsAccumulator<T>::result_size(uint8_t mask) {
+    size_t size = 0;
+    for (unsigned bit = 0; bit < 8; bit++) {
+        if (mask & (1u << bit)) {
+            uint8_t op = static_cast<uint8_t>(1u << bit);
+            size += (op == STAT_MEAN || op == STAT_VARIANCE) ? sizeof(double) : sizeof(T);
+        }
+    }
+    return size;
+}
+
+template class StatsAccumulator<int32_t>;
+template class StatsAccumulator<int64_t>;
+template class StatsAccumulator<float>;
+template class StatsAccumulator<double>;
@@ -0,0 +1,100 @@
+#ifndef VECTORSTATS_H
+#define VECTORSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+#include "DataCalculator.h"
+#include "SimdKernels.h"
+
+//! \brief Накопитель статистик вектора по маске операций
+//! \details Все запрошенные статистики вычисляются за один проход по каждой порции:
+//! float и double - слитным ядром SimdKernels::fused_stats, целые - циклом с точными
+//! суммами в широких типах. Маска из одной суммы квадратов обрабатывается
+//! SquareSumAccumulator, поэтому результат и параллельное суммирование прежние;
+//! слитные статистики остальных масок считаются в вызывающем потоке.
+//! Дисперсия считается по суммам, сдвинутым на первый элемент вектора.
+//! Результаты, не помещающиеся в тип элементов, ограничиваются его диапазоном;
+//! для double переполнение и inf/nan на входе приводят к std::overflow_error.
+//! \tparam T Тип элементов
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+template<typename T = double>
+class StatsAccumulator {
+public:
+    static constexpr size_t MAX_RESULT_SIZE = 8 * sizeof(double); //!< Наибольший размер результатов вектора
+
+private:
+    using Accumulator = typename ElementTraits<T>::Accumulator;
+
+    //! \brief Статистики целых элементов
+    struct IntegerStats {
+        __int128 sum = 0;                                 //!< Сумма
+        Accumulator sum_squares = 0;                      //!< Сумма квадратов (до насыщения)
+        T min = std::numeric_limits<T>::max();            //!< Минимум
+        T max = std::numeric_limits<T>::min();            //!< Максимум
+        unsigned __int128 abs_sum = 0;                    //!< Сумма модулей
+        unsigned __int128 abs_max = 0;                    //!< Наибольший модуль
+        double shifted_sum = 0.0;                         //!< Сумма x - shift
+        double shifted_squares = 0.0;                     //!< Сумма (x - shift)^2
+    };
+
+    using Stats = std::conditional_t<std::is_integral_v<T>, IntegerStats, FusedStats>;
+
+    uint8_t mask;                    //!< Запрошенные статистики (StatOp)
+    SquareSumAccumulator<T> squares; //!< Сумма квадратов, если запрошена только она
+    Stats stats;                     //!< Статистики остальных масок
+    uint64_t count;                  //!< Принято элементов
+    double shift;                    //!< Сдвиг для дисперсии (первый элемент)
+
+public:
+    //! \brief Конструктор накопителя
+    //! \param[in] mask Запрошенные статистики (StatOp)
+    //! \param[in] expected_count Длина вектора, если известна (см. SquareSumAccumulator)
+    explicit StatsAccumulator(uint8_t mask = STAT_SUM_OF_SQUARES, uint64_t expected_count = 0)
+        : mask(mask), squares(mask == STAT_SUM_OF_SQUARES ? expected_count : 0), count(0), shift(0.0) {}
+
+    //! \brief Добавить элементы
+    //! \param[in] data Элементы
+    //! \param[in] count Количество элементов
+    //! \throw std::overflow_error При переполнении суммы квадратов double/float
+    void add(const T* data, size_t count);
+
+    //! \brief Добавить элементы из невыровненного буфера
+    //! \param[in] bytes Байты элементов
+    //! \param[in] count Количество элементов
+    //! \throw std::overflow_error При переполнении суммы квадратов double/float
+    void add_unaligned(const char* bytes, size_t count);
+
+    //! \brief Записать результаты вектора
+    //! \param[out] out Буфер не меньше MAX_RESULT_SIZE байт
+    //! \param[in] swap_bytes Записать каждый результат в обратном порядке байт
+    //! \return Количество записанных байт (см. result_size)
+    //! \throw std::overflow_error При недопустимом значении (inf/nan) или переполнении double
+    size_t write_results(char* out, bool swap_bytes = false) const;
+
+    //! \brief Получить размер результатов вектора
+    //! \param[in] mask Запрошенные статистики (StatOp)
+    //! \return Размер в байтах
+    static size_t result_size(uint8_t mask);
+};
+
+//! \brief Накопитель для типа элементов, согласованного во время работы
+using AnyStatsAccumulator = std::variant<StatsAccumulator<int32_t>, StatsAccumulator<int64_t>,
+                                         StatsAccumulator<float>, StatsAccumulator<double>>;
+
+//! \brief Создать накопитель для согласованных параметров
+//! \param[in] request Параметры обработки
+//! \param[in] expected_count Длина вектора, если известна
+//! \return Пустой накопитель
+inline AnyStatsAccumulator make_stats_accumulator(const DataRequest& request, uint64_t expected_count = 0) {
+    return DataCalculator::dispatch_element_type(request.element_type, [&](auto tag) -> AnyStatsAccumulator {
+        return StatsAccumulator<typename decltype(tag)::type>(request.stats_mask, expected_count);
+    });
+}
+
+#endif // VECTORSTATS_H
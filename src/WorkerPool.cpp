@@ -0,0 +1,98 @@
+/*! \file WorkerPool.cpp
+ *  \brief Реализация класса WorkerPool
+ *  \details Содержит реализацию пула рабочих потоков для клиентских сессий
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include "WorkerPool.h"
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <unistd.h>
+
+WorkerPool::WorkerPool(unsigned threads, size_t queue_capacity, Handler handler,
+                       Handler reject, AdmissionController* admission)
+    : queue(queue_capacity), stopping(false), handler(std::move(handler)),
+      reject(std::move(reject)), admission(admission),
+      thread_count(threads == 0 ? 1 : threads) {
+    if (sem_init(&pending, 0, 0) != 0) {
+        throw std::runtime_error("Failed to initialize worker pool semaphore: " +
+                                 std::system_category().message(errno));
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+    join();
+    sem_destroy(&pending);
+}
+
+void WorkerPool::start() {
+    stopping.store(false, std::memory_order_relaxed);
+    workers.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; i++) {
+        workers.emplace_back(&WorkerPool::worker_loop, this);
+    }
+}
+
+bool WorkerPool::submit(int client_sock, uint32_t client_address) {
+    if (stopping.load(std::memory_order_relaxed) ||
+        !queue.push({client_sock, client_address, std::chrono::steady_clock::now()})) {
+        return false;
+    }
+    sem_post(&pending);
+    return true;
+}
+
+void WorkerPool::stop() {
+    if (stopping.exchange(true)) {
+        return;
+    }
+    for (unsigned i = 0; i < thread_count; i++) {
+        sem_post(&pending);
+    }
+}
+
+void WorkerPool::join() {
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+    
+    QueuedClient client;
+    while (queue.pop(client)) {
+        close(client.sock);
+    }
+}
+
+void WorkerPool::worker_loop() {
+    for (;;) {
+        if (sem_wait(&pending) != 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        
+        if (stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+        
+        QueuedClient client;
+        if (queue.pop(client)) {
+            try {
+                auto now = std::chrono::steady_clock::now();
+                if (admission && reject && admission->should_shed(now - client.enqueued, now)) {
+                    reject(client.sock, client.address);
+                } else {
+                    handler(client.sock, client.address);
+                }
+            } catch (...) {
+                // Обработчик сам закрывает сокет, поток продолжает работу
+            }
+        }
+    }
+}
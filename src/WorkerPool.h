@@ -0,0 +1,91 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <semaphore.h>
+
+#include "AdmissionController.h"
+#include "LockFreeQueue.h"
+
+//! \brief Пул рабочих потоков для обслуживания клиентских сессий
+//! \details Поток accept передаёт принятые сокеты через неблокирующую очередь,
+//! рабочие потоки извлекают их и выполняют обработчик сессии параллельно.
+//! Семафор используется только для засыпания простаивающих потоков.
+//! Сокеты хранятся в очереди вместе с адресом клиента, полученным от accept(),
+//! и моментом постановки, чтобы контроль допуска мог отклонить сессию, слишком
+//! долго прождавшую в очереди.
+//! \author Осетров М.С.
+//! \date 2025
+//! \copyright ПГУ
+class WorkerPool {
+public:
+    //! \brief Тип обработчика клиентского сокета: сокет и адрес клиента (сетевой порядок)
+    using Handler = std::function<void(int, uint32_t)>;
+
+private:
+    //! \brief Сокет в очереди
+    struct QueuedClient {
+        int sock;                                        //!< Сокет клиента
+        uint32_t address;                                //!< Адрес клиента (сетевой порядок)
+        std::chrono::steady_clock::time_point enqueued;  //!< Момент постановки в очередь
+    };
+
+    LockFreeQueue<QueuedClient> queue;    //!< Очередь принятых сокетов
+    std::vector<std::thread> workers;     //!< Рабочие потоки
+    sem_t pending;                        //!< Счётчик сокетов в очереди
+    std::atomic<bool> stopping;           //!< Флаг остановки пула
+    Handler handler;                      //!< Обработчик сессии
+    Handler reject;                       //!< Обработчик отклонённого сокета
+    AdmissionController* admission;       //!< Контроль допуска (nullptr - без отсечения)
+    unsigned thread_count;                //!< Количество рабочих потоков
+
+    //! \brief Цикл рабочего потока
+    void worker_loop();
+
+public:
+    //! \brief Конструктор пула
+    //! \param[in] threads Количество рабочих потоков
+    //! \param[in] queue_capacity Ёмкость очереди сокетов (степень двойки)
+    //! \param[in] handler Обработчик сессии, вызывается в рабочем потоке
+    //! \param[in] reject Обработчик сокета, отсечённого по времени ожидания
+    //! \param[in] admission Контроль допуска (nullptr - без отсечения)
+    //! \throw std::runtime_error При ошибке инициализации семафора
+    WorkerPool(unsigned threads, size_t queue_capacity, Handler handler,
+               Handler reject = nullptr, AdmissionController* admission = nullptr);
+
+    //! \brief Деструктор пула, останавливает и дожидается потоков
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //! \brief Запустить рабочие потоки
+    void start();
+
+    //! \brief Передать сокет клиента в пул
+    //! \param[in] client_sock Сокет клиента
+    //! \param[in] client_address Адрес клиента из accept() (сетевой порядок), передаётся обработчику
+    //! \return true если сокет поставлен в очередь, false если очередь заполнена
+    bool submit(int client_sock, uint32_t client_address = 0);
+
+    //! \brief Запросить остановку пула
+    //! \details Не блокирует, допускается вызов из обработчика сигнала
+    void stop();
+
+    //! \brief Дождаться завершения рабочих потоков
+    //! \details Сокеты, оставшиеся в очереди, закрываются без обработки
+    void join();
+
+    //! \brief Получить количество рабочих потоков
+    //! \return Количество потоков
+    unsigned size() const { return thread_count; }
+};
+
+#endif // WORKERPOOL_H
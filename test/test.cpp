@@ -9,8 +9,14 @@
 #include <cstring>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <arpa/inet.h>
 #include <unistd.h>
 #include <iostream>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <sstream>
 
 #include "../src/Logger.h"
 #include "../src/ErrorHandler.h"
@@ -18,6 +24,24 @@
 #include "../src/DataCalculator.h"
 #include "../src/CommandLineParser.h"
 #include "../src/Server.h"
+#include "../src/LockFreeQueue.h"
+#include "../src/WorkerPool.h"
+#include "../src/ClientSession.h"
+#include "../src/IoUring.h"
+#include "../src/CoroTask.h"
+#include "../src/BufferPool.h"
+#include "../src/SimdKernels.h"
+#include "../src/ComputePool.h"
+#include "../src/VectorStats.h"
+#include "../src/SaltReservoir.h"
+#include "../src/UserDbWatcher.h"
+#include "../src/UserStore.h"
+#include "../src/IpRateLimiter.h"
+#include "../src/SessionGate.h"
+#include "../src/BinaryLog.h"
+#include <fcntl.h>
+#include <cryptopp/filters.h>
+#include <cryptopp/gzip.h>
 
 namespace fs = std::filesystem;
 
@@ -36,12 +60,86 @@ public:
     std::string get_path() const { return filename; }
 };
 
+class TempDir {
+private:
+    std::string path;
+public:
+    TempDir() {
+        path = "temp_dir_" + std::to_string(std::time(nullptr)) + "_" + std::to_string(rand());
+        fs::create_directory(path);
+    }
+    ~TempDir() { fs::remove_all(path); }
+    std::string get_path() const { return path; }
+    
+    // Ротированные файлы журнала name в каталоге
+    std::vector<std::string> segments(const std::string& name) const {
+        std::vector<std::string> result;
+        for (const auto& entry : fs::directory_iterator(path)) {
+            std::string filename = entry.path().filename().string();
+            if (filename.rfind(name + ".", 0) == 0) result.push_back(entry.path().string());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
 int create_test_socket() {
     int sock = socket(AF_INET, SOCK_STREAM, 0);
     if (sock < 0) throw std::runtime_error("Failed to create test socket");
     return sock;
 }
 
+// Полный сеанс клиента: логин, соль, хеш, отправка векторов и приём результатов
+std::vector<double> run_test_client(int port, const std::string& login, const std::string& password,
+                                    const std::vector<std::vector<double>>& vectors) {
+    int sock = create_test_socket();
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(sock);
+        throw std::runtime_error("Failed to connect to test server");
+    }
+    
+    std::vector<double> results;
+    send(sock, login.c_str(), login.length(), 0);
+    char salt[17] = {0};
+    if (recv(sock, salt, 16, MSG_WAITALL) != 16) {
+        close(sock);
+        throw std::runtime_error("Failed to receive salt");
+    }
+    std::string hash = AuthManager::compute_md5_hash(salt, password);
+    send(sock, hash.c_str(), hash.length(), 0);
+    char status[3] = {0};
+    if (recv(sock, status, 2, 0) <= 0 || std::string(status) != "OK") {
+        close(sock);
+        throw std::runtime_error("Authentication failed");
+    }
+    
+    uint32_t num_vectors = vectors.size();
+    send(sock, &num_vectors, sizeof(num_vectors), 0);
+    for (const auto& vec : vectors) {
+        uint32_t vector_size = vec.size();
+        send(sock, &vector_size, sizeof(vector_size), 0);
+        send(sock, vec.data(), vec.size() * sizeof(double), 0);
+        double result = 0;
+        if (recv(sock, &result, sizeof(result), MSG_WAITALL) != sizeof(result)) {
+            close(sock);
+            throw std::runtime_error("Failed to receive result");
+        }
+        results.push_back(result);
+    }
+    close(sock);
+    return results;
+}
+
 // ===================== ТЕСТЫ ДЛЯ COMMANDLINEPARSER (Таблица 1) =====================
 
 SUITE(CommandLineParserTests) {
@@ -156,6 +254,147 @@ SUITE(CommandLineParserTests) {
         parser.parse(argc, const_cast<char**>(argv));
         CHECK(!parser.validate());
         #endif
+    }    
+    TEST(Test5_3_LogRotationRequiresAsync) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        std::string users_path = users.get_path(), log_path = log.get_path();
+        const char* argv[] = {"program", "-u", users_path.c_str(), "-l", log_path.c_str(),
+                              "--log-rotate-sec", "3600", "--log-async", "false"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CommandLineParser sync_parser;
+        CHECK(sync_parser.parse(argc, const_cast<char**>(argv)));
+        CHECK(!sync_parser.validate());
+        
+        argv[argc - 1] = "true";
+        CommandLineParser async_parser;
+        CHECK(async_parser.parse(argc, const_cast<char**>(argv)));
+        CHECK(async_parser.validate());
+    }
+    
+    TEST(Test6_1_AdmissionOptions) {
+        CommandLineParser parser;
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log",
+                              "--backlog", "512", "--max-sessions", "100", "--shed-target", "20"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(512, parser.get_server_options().listen_backlog);
+        CHECK_EQUAL(100u, parser.get_server_options().max_sessions);
+        CHECK_EQUAL(20u, parser.get_server_options().shed_target_ms);
+    }
+    
+    TEST(Test6_2_InvalidBacklog) {
+        CommandLineParser parser;
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--backlog", "0"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(!parser.parse(argc, const_cast<char**>(argv)));
+    }
+    
+    TEST(Test6_3_ComputeThreadsOption) {
+        CommandLineParser parser;
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--compute-threads", "0"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(0u, parser.get_server_options().compute_threads);
+    }
+    
+    TEST(Test6_4_KeepAliveOption) {
+        CommandLineParser parser;
+        // По умолчанию один пакет на подключение
+        CHECK_EQUAL(0u, parser.get_server_options().keep_alive_sec);
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--keep-alive", "60"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(60u, parser.get_server_options().keep_alive_sec);
+    }
+    
+    TEST(Test6_5_WatchUsersOption) {
+        CommandLineParser parser;
+        CHECK(parser.get_server_options().watch_user_db);
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--watch-users", "false"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK(!parser.get_server_options().watch_user_db);
+    }
+    
+    TEST(Test6_6_CompileUsersOption) {
+        CommandLineParser parser;
+        CHECK(parser.get_compiled_users_file().empty());
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--compile-users", "users.bin"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("users.bin", parser.get_compiled_users_file());
+    }
+    
+    TEST(Test6_7_IpLimitOptions) {
+        CommandLineParser parser;
+        CHECK(!parser.get_server_options().ip_limits.enabled());
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--ip-rate", "5", "--ip-burst", "10",
+                              "--ip-max-sessions", "3", "--auth-fail-limit", "4", "--auth-block", "30"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        const IpLimits& limits = parser.get_server_options().ip_limits;
+        CHECK(limits.enabled());
+        CHECK_EQUAL(5u, limits.rate);
+        CHECK_EQUAL(10u, limits.burst);
+        CHECK_EQUAL(3u, limits.max_sessions);
+        CHECK_EQUAL(4u, limits.fail_limit);
+        CHECK_EQUAL(30u, limits.block_sec);
+    }
+    
+    TEST(Test6_8_LogOptions) {
+        CommandLineParser parser;
+        CHECK(!parser.get_server_options().log_options.async);
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--log-async", "true",
+                              "--log-queue", "1024", "--log-flush-ms", "20", "--log-overflow", "drop"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        const LoggerOptions& options = parser.get_server_options().log_options;
+        CHECK(options.async);
+        CHECK_EQUAL(1024u, options.queue_capacity);
+        CHECK_EQUAL(20u, options.flush_interval_ms);
+        CHECK(options.overflow == LogOverflow::Drop);
+        
+        CommandLineParser bad_parser;
+        const char* bad_argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--log-queue", "1000"};
+        CHECK(!bad_parser.parse(sizeof(bad_argv)/sizeof(bad_argv[0]), const_cast<char**>(bad_argv)));
+    }
+    
+    TEST(Test6_10_LogFormatOption) {
+        CommandLineParser parser;
+        CHECK(parser.get_server_options().log_options.format == LogFormat::Text);
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--log-format", "binary"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK(parser.get_server_options().log_options.format == LogFormat::Binary);
+    }
+    
+    TEST(Test6_9_LogLevelOption) {
+        CommandLineParser parser;
+        CHECK(parser.get_server_options().log_options.level == LogLevel::Info);
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--log-level", "debug"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        CHECK(parser.get_server_options().log_options.level == LogLevel::Debug);
+        
+        CommandLineParser bad_parser;
+        const char* bad_argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--log-level", "verbose"};
+        CHECK(!bad_parser.parse(sizeof(bad_argv)/sizeof(bad_argv[0]), const_cast<char**>(bad_argv)));
+    }
+    
+    TEST(Test6_11_LogRotationOptions) {
+        CommandLineParser parser;
+        CHECK(!parser.get_server_options().log_options.rotation_enabled());
+        const char* argv[] = {"program", "-u", "users.txt", "-l", "server.log", "--log-rotate-mb", "64",
+                              "--log-rotate-sec", "3600", "--log-keep", "5", "--log-compress", "false"};
+        int argc = sizeof(argv)/sizeof(argv[0]);
+        CHECK(parser.parse(argc, const_cast<char**>(argv)));
+        const LoggerOptions& options = parser.get_server_options().log_options;
+        CHECK(options.rotation_enabled());
+        CHECK_EQUAL(64ull * 1024 * 1024, options.rotate_bytes);
+        CHECK_EQUAL(3600u, options.rotate_interval_sec);
+        CHECK_EQUAL(5u, options.keep_segments);
+        CHECK(!options.compress_segments);
     }
 }
 
@@ -250,6 +489,196 @@ SUITE(LoggerTests) {
         logger.log_auth("ip", "", true);
         CHECK(true);                                
     }
+    
+    TEST(Test7_1_AsyncLoggerWritesAllLines) {
+        TempFile temp;
+        LoggerOptions options;
+        options.async = true;
+        options.queue_capacity = 64;
+        options.flush_interval_ms = 1000;
+        const int threads = 4;
+        const int lines = 500;
+        {
+            Logger logger(temp.get_path(), options);
+            CHECK(logger.is_async());
+            std::vector<std::thread> producers;
+            for (int t = 0; t < threads; t++) {
+                producers.emplace_back([&logger, t]() {
+                    for (int i = 0; i < lines; i++) {
+                        logger.log("async " + std::to_string(t) + " " + std::to_string(i));
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            // flush() не ждёт интервала записи
+            logger.flush();
+            std::ifstream file(temp.get_path());
+            std::string line;
+            int count = 0;
+            while (std::getline(file, line)) {
+                if (line.find("] async ") != std::string::npos) count++;
+            }
+            CHECK_EQUAL(threads * lines, count);
+            CHECK_EQUAL(0u, logger.get_dropped());
+        }
+        std::ifstream file(temp.get_path());
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CHECK(content.find("=== Server stopped ===") != std::string::npos);
+    }
+    
+    TEST(Test7_2_AsyncLoggerCountsDroppedLines) {
+        TempFile temp;
+        LoggerOptions options;
+        options.async = true;
+        options.queue_capacity = 4;
+        options.flush_interval_ms = 10000;
+        options.overflow = LogOverflow::Count;
+        uint64_t dropped;
+        {
+            Logger logger(temp.get_path(), options);
+            for (int i = 0; i < 20; i++) {
+                logger.log("burst " + std::to_string(i));
+            }
+            dropped = logger.get_dropped();
+            CHECK(dropped > 0);
+        }
+        std::ifstream file(temp.get_path());
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CHECK(content.find("log records dropped") != std::string::npos);
+    }
+    
+    TEST(Test8_1_LevelFiltersMessages) {
+        TempFile temp;
+        {
+            Logger logger(temp.get_path());
+            CHECK(logger.get_level() == LogLevel::Info);
+            logger.log_debug("hidden debug");
+            logger.log_data("ip", "visible data");
+            logger.set_level(LogLevel::Warning);
+            logger.log_data("ip", "hidden data");
+            logger.log_auth("ip", "user", true, "hidden success");
+            logger.log_auth("ip", "user", false, "visible failure");
+            logger.set_level(LogLevel::Debug);
+            logger.log_debug("visible debug");
+        }
+        std::ifstream file(temp.get_path());
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CHECK(content.find("hidden") == std::string::npos);
+        CHECK(content.find("visible data") != std::string::npos);
+        CHECK(content.find("visible failure") != std::string::npos);
+        CHECK(content.find("visible debug") != std::string::npos);
+    }
+    
+    TEST(Test8_2_MacroSkipsArgumentsWhenDisabled) {
+        TempFile temp;
+        Logger logger(temp.get_path());
+        int evaluated = 0;
+        auto message = [&evaluated]() {
+            evaluated++;
+            return std::string("debug line");
+        };
+        LOG_DEBUG(logger, message());
+        CHECK_EQUAL(0, evaluated);
+        logger.set_level(LogLevel::Debug);
+        LOG_DEBUG(logger, message());
+        CHECK_EQUAL(Logger::is_compiled(LogLevel::Debug) ? 1 : 0, evaluated);
+    }
+    
+    TEST(Test8_3_AdjustLevelClamps) {
+        TempFile temp;
+        Logger logger(temp.get_path());
+        CHECK(logger.adjust_level(-1) == LogLevel::Debug);
+        CHECK(logger.adjust_level(-1) == LogLevel::Debug);
+        logger.set_level(LogLevel::Warning);
+        CHECK(logger.adjust_level(1) == LogLevel::Error);
+        CHECK(logger.adjust_level(1) == LogLevel::Error);
+    }
+    
+    TEST(Test9_1_RotatesBySizeAndKeepsSegments) {
+        TempDir dir;
+        std::string path = dir.get_path() + "/server.log";
+        LoggerOptions options;
+        options.rotate_bytes = 2048;
+        options.keep_segments = 3;
+        options.compress_segments = false;
+        {
+            Logger logger(path, options);
+            for (int i = 0; i < 400; i++) {
+                logger.log("rotation line " + std::to_string(i));
+            }
+            CHECK(logger.get_rotations() >= 5);
+        }
+        // Деструктор дожидается удаления старых файлов
+        std::vector<std::string> segments = dir.segments("server.log");
+        CHECK_EQUAL(3u, segments.size());
+        for (const auto& segment : segments) {
+            CHECK(fs::file_size(segment) <= 2048);
+            CHECK(segment.find(".gz") == std::string::npos);
+        }
+        CHECK(fs::file_size(path) <= 2048);
+        CHECK(read_file(path).find("rotation line 399\n") != std::string::npos);
+        CHECK(read_file(segments.back()).find("rotation line 399\n") == std::string::npos);
+    }
+    
+    TEST(Test9_2_CompressedBinarySegmentsDecode) {
+        TempDir dir;
+        std::string path = dir.get_path() + "/server.bin";
+        LoggerOptions options;
+        options.async = true;
+        options.format = LogFormat::Binary;
+        options.rotate_bytes = 512;
+        options.keep_segments = 0;
+        {
+            Logger logger(path, options);
+            for (int i = 0; i < 100; i++) {
+                logger.log_batch(LogEvent::BatchProcessed, "10.0.0.7", i);
+                // Поток записи ротирует файл между пачками - отдаём пачки чаще
+                if (i % 10 == 9) logger.flush();
+            }
+        }
+        std::vector<std::string> segments = dir.segments("server.bin");
+        CHECK(segments.size() >= 2);
+        std::string text;
+        for (const auto& segment : segments) {
+            CHECK(segment.size() > 3 && segment.compare(segment.size() - 3, 3, ".gz") == 0);
+            std::string plain;
+            CryptoPP::StringSource(read_file(segment), true, new CryptoPP::Gunzip(new CryptoPP::StringSink(plain)));
+            std::istringstream in(plain);
+            std::ostringstream out;
+            // Каждый файл начинается с записи сеанса и читается отдельно
+            BinaryLogDecoder::decode(in, out, LogOutputFormat::Text);
+            text += out.str();
+        }
+        std::ifstream current(path, std::ios::binary);
+        std::ostringstream out;
+        BinaryLogDecoder::decode(current, out, LogOutputFormat::Text);
+        text += out.str();
+        for (int i = 0; i < 100; i++) {
+            CHECK(text.find("Successfully processed " + std::to_string(i) + " vectors\n") != std::string::npos);
+        }
+    }
+    
+    TEST(Test9_3_RotatesByTime) {
+        TempDir dir;
+        std::string path = dir.get_path() + "/server.log";
+        LoggerOptions options;
+        options.rotate_interval_sec = 1;
+        options.compress_segments = false;
+        {
+            Logger logger(path, options);
+            logger.log("before rotation");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+            logger.log("after rotation");
+            CHECK_EQUAL(1u, logger.get_rotations());
+        }
+        std::vector<std::string> segments = dir.segments("server.log");
+        CHECK_EQUAL(1u, segments.size());
+        CHECK(read_file(segments[0]).find("before rotation") != std::string::npos);
+        CHECK(read_file(path).find("before rotation") == std::string::npos);
+        CHECK(read_file(path).find("after rotation") != std::string::npos);
+    }
 }
 
 // ===================== ТЕСТЫ ДЛЯ ERRORHANDLER (Таблица 3) =====================
@@ -439,6 +868,172 @@ SUITE(AuthManagerTests) {
         Logger logger(log.get_path());
         CHECK(!auth.authenticate("unknown", hash, salt, logger, "127.0.0.1"));
     }
+    
+    TEST(Test7_1_ParseLoginMessage) {
+        std::string message = "user";
+        CHECK(AuthManager::parse_login_message(message) == LoginKind::Password);
+        CHECK_EQUAL("user", message);
+        message = "TICKET:user";
+        CHECK(AuthManager::parse_login_message(message) == LoginKind::PasswordWithTicket);
+        CHECK_EQUAL("user", message);
+        message = "RESUME:0011";
+        CHECK(AuthManager::parse_login_message(message) == LoginKind::Resume);
+        CHECK_EQUAL("0011", message);
+    }
+    
+    TEST(Test7_2_TicketResumeOnce) {
+        AuthManager auth;
+        TempFile temp("testuser:mypassword\n");
+        auth.load_users(temp.get_path());
+        TempFile log;
+        Logger logger(log.get_path());
+        std::string ticket = auth.issue_ticket("testuser");
+        CHECK_EQUAL(AuthManager::ticket_length("testuser"), ticket.size());
+        CHECK(ticket != auth.issue_ticket("testuser"));
+        
+        std::string login;
+        CHECK(auth.resume(ticket, login, logger, "127.0.0.1"));
+        CHECK_EQUAL("testuser", login);
+        // Повтор принятого билета отклоняется
+        CHECK(!auth.resume(ticket, login, logger, "127.0.0.1"));
+    }
+    
+    TEST(Test7_3_TicketTamperedOrForeign) {
+        AuthManager auth;
+        TempFile temp("testuser:mypassword\nadmin:secret\n");
+        auth.load_users(temp.get_path());
+        TempFile log;
+        Logger logger(log.get_path());
+        std::string login;
+        
+        // Подмена логина в билете ломает MAC
+        std::string ticket = auth.issue_ticket("testuser");
+        std::string forged = ticket.substr(0, 2 * AuthManager::TICKET_BINARY_SIZE) + "admin";
+        CHECK(!auth.resume(forged, login, logger, "127.0.0.1"));
+        std::string flipped = ticket;
+        flipped[5] = flipped[5] == '0' ? '1' : '0';
+        CHECK(!auth.resume(flipped, login, logger, "127.0.0.1"));
+        CHECK(!auth.resume("not a ticket", login, logger, "127.0.0.1"));
+        
+        // Билет другого сервера (другой ключ) не принимается
+        AuthManager other;
+        other.load_users(temp.get_path());
+        CHECK(!other.resume(ticket, login, logger, "127.0.0.1"));
+        CHECK(auth.resume(ticket, login, logger, "127.0.0.1"));
+    }
+    
+    TEST(Test7_4_TicketExpires) {
+        AuthManager auth;
+        TempFile temp("testuser:mypassword\n");
+        auth.load_users(temp.get_path());
+        auth.set_ticket_lifetime(1);
+        TempFile log;
+        Logger logger(log.get_path());
+        std::string ticket = auth.issue_ticket("testuser");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+        std::string login;
+        CHECK(!auth.resume(ticket, login, logger, "127.0.0.1"));
+    }
+    
+    TEST(Test8_1_CheckCredentials) {
+        AuthManager auth;
+        TempFile temp("testuser:mypassword\n");
+        auth.load_users(temp.get_path());
+        std::string salt = auth.generate_salt();
+        std::string hash = AuthManager::compute_md5_hash(salt, "mypassword");
+        CHECK_EQUAL(32u, hash.size());
+        CHECK(auth.check_credentials("testuser", hash, salt) == AuthResult::Accepted);
+        
+        std::string lower = hash;
+        for (char& c : lower) c = std::tolower(static_cast<unsigned char>(c));
+        CHECK(auth.check_credentials("testuser", lower, salt) == AuthResult::Accepted);
+        
+        CHECK(auth.check_credentials("nobody", hash, salt) == AuthResult::UnknownUser);
+        CHECK(auth.check_credentials("testuser", hash.substr(1), salt) == AuthResult::HashMismatch);
+        std::string wrong = hash;
+        wrong[31] = wrong[31] == 'A' ? 'B' : 'A';
+        CHECK(auth.check_credentials("testuser", wrong, salt) == AuthResult::HashMismatch);
+        CHECK(auth.check_credentials("testuser", std::string(32, 'Z'), salt) == AuthResult::HashMismatch);
+    }
+    
+    TEST(Test9_1_ReloadSwapsSnapshot) {
+        AuthManager auth;
+        TempFile users("old:pass\n");
+        auth.load_users(users.get_path());
+        TempFile log;
+        Logger logger(log.get_path());
+        auto before = auth.get_users();
+        
+        std::ofstream(users.get_path()) << "new:pass\nother:secret\n";
+        CHECK(auth.reload_users(logger));
+        CHECK(!auth.user_exists("old"));
+        CHECK(auth.user_exists("new"));
+        CHECK_EQUAL(2u, auth.user_count());
+        // Старый снимок остаётся целым у того, кто его держит
+        CHECK(before->contains("old"));
+        
+        // Битый файл не заменяет рабочую базу
+        std::ofstream(users.get_path()) << "# empty\n";
+        CHECK(!auth.reload_users(logger));
+        CHECK(auth.user_exists("new"));
+    }
+    
+    TEST(Test9_2_AuthDuringReloads) {
+        AuthManager auth;
+        TempFile users("user:pass\n");
+        auth.load_users(users.get_path());
+        TempFile log;
+        Logger logger(log.get_path());
+        std::string salt = auth.generate_salt();
+        std::string hash = AuthManager::compute_md5_hash(salt, "pass");
+        
+        std::atomic<bool> done{false};
+        std::atomic<int> failures{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.emplace_back([&]() {
+                while (!done) {
+                    if (auth.check_credentials("user", hash, salt) != AuthResult::Accepted) failures++;
+                }
+            });
+        }
+        for (int i = 0; i < 50; i++) {
+            std::ofstream(users.get_path()) << "user:pass\nextra" << i << ":x\n";
+            CHECK(auth.reload_users(logger));
+        }
+        done = true;
+        for (auto& reader : readers) reader.join();
+        CHECK_EQUAL(0, failures.load());
+        CHECK(auth.user_exists("extra49"));
+    }
+    
+    TEST(Test9_3_WatcherReloadsOnChangeAndRequest) {
+        AuthManager auth;
+        TempFile users("user:pass\n");
+        auth.load_users(users.get_path());
+        TempFile log;
+        Logger logger(log.get_path());
+        auto wait_for_user = [&auth](const std::string& login) {
+            for (int i = 0; i < 200 && !auth.user_exists(login); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return auth.user_exists(login);
+        };
+        {
+            UserDbWatcher watcher(auth, logger, users.get_path(), true);
+            // Замена файла переименованием, как при деплое
+            std::string staged = users.get_path() + ".new";
+            std::ofstream(staged) << "user:pass\nadded:pass\n";
+            CHECK_EQUAL(0, rename(staged.c_str(), users.get_path().c_str()));
+            CHECK(wait_for_user("added"));
+        }
+        {
+            UserDbWatcher watcher(auth, logger, users.get_path(), false);
+            std::ofstream(users.get_path()) << "requested:pass\n";
+            watcher.request_reload();
+            CHECK(wait_for_user("requested"));
+        }
+    }
 }
 
 // ===================== ТЕСТЫ ДЛЯ DATACALCULATOR (Таблица 5) =====================
@@ -577,78 +1172,1724 @@ SUITE(DataCalculatorTests) {
         close(sockfd[0]); close(sockfd[1]);
     }
     
-    TEST(Test4_3_ProcessClientDataByteOrder) {
-    int sockfd[2];
-    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
-    
-    std::thread sender([sockfd]() {
-        // Отправляем только 1 вектор вместо 2
-        uint32_t num_vectors = htonl(1);  // ← ИЗМЕНИТЬ с 2 на 1!
-        send(sockfd[0], &num_vectors, sizeof(num_vectors), 0);
-        uint32_t vector_size = htonl(2);
-        send(sockfd[0], &vector_size, sizeof(vector_size), 0);
-        double data[2] = {1.5, 2.5};
-        send(sockfd[0], data, sizeof(data), 0);
-        double result = 0;
-        recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
-        CHECK_CLOSE(8.5, result, 0.0001);
-        shutdown(sockfd[0], SHUT_WR);
-    });
-    
-    TempFile log;
-    Logger logger(log.get_path());
-    bool result = DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1");
-    sender.join();
-    CHECK(result);
-    close(sockfd[0]); close(sockfd[1]);
-    }
-}
-
-// ===================== ТЕСТЫ ДЛЯ SERVER (Таблица 6) =====================
-
-SUITE(ServerTests) {
-    TEST(Test1_1_GetClientIPValidSocket) {
-        TempFile users("test:pass\n");
-        TempFile log;
-        Server server(33333, users.get_path(), log.get_path());
-        
-        int test_sock = socket(AF_INET, SOCK_STREAM, 0);
-        CHECK(test_sock >= 0);
+    TEST(Test4_4_ProcessClientDataBatch) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
         
-        std::string ip = server.get_client_ip(test_sock);
-        CHECK_EQUAL("unknown", ip);
+        // 500 маленьких векторов одним пакетом и вектор больше буфера приёма
+        std::thread sender([sockfd]() {
+            std::string batch;
+            uint32_t num_vectors = 501;
+            batch.append(reinterpret_cast<const char*>(&num_vectors), sizeof(num_vectors));
+            for (uint32_t i = 0; i < 500; i++) {
+                uint32_t vector_size = 2;
+                double data[2] = {1.0, double(i)};
+                batch.append(reinterpret_cast<const char*>(&vector_size), sizeof(vector_size));
+                batch.append(reinterpret_cast<const char*>(data), sizeof(data));
+            }
+            uint32_t large_size = 20000;
+            std::vector<double> large(large_size, 0.5);
+            batch.append(reinterpret_cast<const char*>(&large_size), sizeof(large_size));
+            batch.append(reinterpret_cast<const char*>(large.data()), large.size() * sizeof(double));
+            send(sockfd[0], batch.data(), batch.size(), 0);
+            
+            std::vector<double> results(501);
+            recv(sockfd[0], results.data(), results.size() * sizeof(double), MSG_WAITALL);
+            CHECK_CLOSE(1.0, results[0], 0.0001);
+            CHECK_CLOSE(1.0 + 499.0 * 499.0, results[499], 0.0001);
+            CHECK_CLOSE(5000.0, results[500], 0.0001);
+        });
         
-        close(test_sock);
+        TempFile log;
+        Logger logger(log.get_path());
+        SessionStats stats;
+        DataCalculator::io_syscalls = 0;
+        bool result = DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1", &stats);
+        sender.join();
+        CHECK(result);
+        CHECK_EQUAL(501u, stats.snapshot().vectors_processed);
+        CHECK(DataCalculator::io_syscalls < 100);
+        close(sockfd[0]); close(sockfd[1]);
     }
     
-    TEST(Test1_2_GetClientIPInvalidSocket) {
-        TempFile users("test:pass\n");
-        TempFile log;
-        Server server(33333, users.get_path(), log.get_path());
-        
-        std::string ip = server.get_client_ip(-1);
-        CHECK_EQUAL("unknown", ip);
+    TEST(Test6_1_AccumulatorMatchesWholeVector) {
+        std::vector<double> data = {1.5, -2.0, 3.25, 0.0, 7.0};
+        SquareSumAccumulator accumulator;
+        accumulator.add(data.data(), 2);
+        accumulator.add_unaligned(reinterpret_cast<const char*>(data.data() + 2), 3);
+        CHECK_CLOSE(DataCalculator::calculate_sum_of_squares(data), accumulator.result(), 1e-12);
     }
     
-    TEST(Test2_1_SendStringSuccess) {
-        TempFile users("test:pass\n");
-        TempFile log;
-        Server server(33333, users.get_path(), log.get_path());
-        
+    TEST(Test6_2_ProcessClientDataExtendedSize) {
         int sockfd[2];
         CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        const uint64_t elements = 2000000;
         
-        bool result = server.send_string(sockfd[0], "Hello");
-        CHECK(result);
+        // Вектор длиннее MAX_REASONABLE_VECTOR_SIZE передаётся с 64-битным размером
+        std::thread sender([sockfd, elements]() {
+            uint32_t num_vectors = 1;
+            uint32_t marker = DataCalculator::VECTOR_SIZE_EXTENDED;
+            send(sockfd[0], &num_vectors, sizeof(num_vectors), 0);
+            send(sockfd[0], &marker, sizeof(marker), 0);
+            send(sockfd[0], &elements, sizeof(elements), 0);
+            std::vector<double> chunk(4096, 0.5);
+            for (uint64_t sent = 0; sent < elements; sent += chunk.size()) {
+                send(sockfd[0], chunk.data(), chunk.size() * sizeof(double), 0);
+            }
+            double result = 0;
+            recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+            CHECK_CLOSE(elements * 0.25, result, 0.0001);
+        });
         
-        close(sockfd[0]);
-        close(sockfd[1]);
+        TempFile log;
+        Logger logger(log.get_path());
+        SessionStats stats;
+        bool result = DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1", &stats);
+        sender.join();
+        CHECK(result);
+        CHECK_EQUAL(4 + 8 + elements * 8, stats.snapshot().bytes_received);
+        close(sockfd[0]); close(sockfd[1]);
     }
     
-    TEST(Test2_2_RecvStringSuccess) {
-        TempFile users("test:pass\n");
-        TempFile log;
-        Server server(33333, users.get_path(), log.get_path());
+    TEST(Test7_1_SimdKernelsMatchScalar) {
+        // Длины покрывают пустой вектор, хвосты всех ядер и невыровненное начало
+        std::vector<double> data(1037);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = std::sin(static_cast<double>(i)) * 1000.0;
+        }
+        SimdKernels::SumOfSquaresFn scalar = SimdKernels::kernel(SimdLevel::Scalar);
+        for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+            SimdKernels::SumOfSquaresFn fn = SimdKernels::kernel(level);
+            if (!fn) continue;
+            for (size_t count : {0, 1, 3, 7, 15, 31, 33, 100, 1036}) {
+                double expected = scalar(data.data() + 1, count);
+                CHECK_CLOSE(expected, fn(data.data() + 1, count), 1e-12 * (expected + 1.0));
+            }
+        }
+    }
+    
+    TEST(Test7_2_SimdOverflowDetected) {
+        std::vector<double> data(100, 1e200);
+        SquareSumAccumulator accumulator;
+        CHECK_THROW(accumulator.add(data.data(), data.size()), std::overflow_error);
+        CHECK_THROW(DataCalculator::calculate_sum_of_squares(data), std::overflow_error);
+    }
+    
+    TEST(Test7_3_SimdNonFiniteInput) {
+        std::vector<double> data(50, 1.0);
+        data[41] = std::numeric_limits<double>::quiet_NaN();
+        CHECK_THROW(DataCalculator::calculate_sum_of_squares(data), std::overflow_error);
+        data[41] = -std::numeric_limits<double>::infinity();
+        CHECK_THROW(DataCalculator::calculate_sum_of_squares(data), std::overflow_error);
+    }
+    
+    TEST(Test7_4_SimdSetLevel) {
+        SimdLevel detected = SimdKernels::detect();
+        CHECK(SimdKernels::set_level(SimdLevel::Scalar));
+        CHECK(SimdLevel::Scalar == SimdKernels::get_level());
+        std::vector<double> data = {1.0, 2.0, 3.0};
+        CHECK_CLOSE(14.0, DataCalculator::calculate_sum_of_squares(data), 1e-12);
+        CHECK(SimdKernels::set_level(detected));
+        CHECK(detected == SimdKernels::get_level());
+    }
+    
+    TEST(Test8_1_ParallelReductionDeterministic) {
+        std::vector<double> data(DataCalculator::PARALLEL_REDUCTION_THRESHOLD * 4 + 123);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = std::sin(static_cast<double>(i)) * 1e3;
+        }
+        unsigned threads = ComputePool::instance().thread_count();
+        ComputePool::instance().set_threads(0);
+        double single = DataCalculator::calculate_sum_of_squares(data);
+        for (unsigned count : {1u, 3u, 7u}) {
+            ComputePool::instance().set_threads(count);
+            // Результат совпадает побитово при любом числе потоков
+            CHECK_EQUAL(single, DataCalculator::calculate_sum_of_squares(data));
+        }
+        ComputePool::instance().set_threads(threads);
+        double expected = SimdKernels::kernel(SimdLevel::Scalar)(data.data(), data.size());
+        CHECK_CLOSE(expected, single, expected * 1e-12);
+    }
+    
+    TEST(Test8_2_ParallelReductionOverflow) {
+        std::vector<double> data(DataCalculator::PARALLEL_REDUCTION_THRESHOLD * 2, 1.0);
+        data[data.size() - 5] = 1e300;
+        CHECK_THROW(DataCalculator::calculate_sum_of_squares(data), std::overflow_error);
+    }
+    
+    TEST(Test9_1_TypedAccumulators) {
+        std::vector<int32_t> ints = {3, -4, 0};
+        CHECK_EQUAL(25, DataCalculator::calculate_sum_of_squares(ints.data(), ints.size()));
+        std::vector<int32_t> big_ints = {50000, 50000};
+        CHECK_EQUAL(std::numeric_limits<int32_t>::max(),
+                    DataCalculator::calculate_sum_of_squares(big_ints.data(), big_ints.size()));
+        
+        std::vector<int64_t> longs = {1000000000LL, -2000000000LL};
+        CHECK_EQUAL(5000000000000000000LL, DataCalculator::calculate_sum_of_squares(longs.data(), longs.size()));
+        std::vector<int64_t> extreme = {std::numeric_limits<int64_t>::min(), 1};
+        CHECK_EQUAL(std::numeric_limits<int64_t>::max(),
+                    DataCalculator::calculate_sum_of_squares(extreme.data(), extreme.size()));
+        
+        std::vector<float> floats = {1.5f, -2.5f};
+        CHECK_CLOSE(8.5f, DataCalculator::calculate_sum_of_squares(floats.data(), floats.size()), 1e-6f);
+        std::vector<float> big_floats = {1e30f, 1e30f};
+        CHECK_EQUAL(std::numeric_limits<float>::max(),
+                    DataCalculator::calculate_sum_of_squares(big_floats.data(), big_floats.size()));
+        floats[1] = std::numeric_limits<float>::infinity();
+        CHECK_THROW(DataCalculator::calculate_sum_of_squares(floats.data(), floats.size()), std::overflow_error);
+    }
+    
+    TEST(Test9_2_FloatKernelsMatchScalar) {
+        std::vector<float> data(1037);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<float>(std::cos(static_cast<double>(i)) * 100.0);
+        }
+        SimdKernels::FloatSumOfSquaresFn scalar = SimdKernels::float_kernel(SimdLevel::Scalar);
+        for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+            SimdKernels::FloatSumOfSquaresFn fn = SimdKernels::float_kernel(level);
+            if (!fn) continue;
+            for (size_t count : {0, 1, 5, 15, 17, 33, 1036}) {
+                double expected = scalar(data.data() + 1, count);
+                CHECK_CLOSE(expected, fn(data.data() + 1, count), 1e-12 * (expected + 1.0));
+            }
+        }
+    }
+    
+    TEST(Test9_3_ProcessClientDataNegotiatedFloat) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        
+        // Заголовок "TYP" + 'f', затем обычный пакет с элементами float
+        std::thread sender([sockfd]() {
+            char type_header[4] = {'T', 'Y', 'P', 'f'};
+            send(sockfd[0], type_header, sizeof(type_header), 0);
+            char status[3] = {0};
+            recv(sockfd[0], status, 2, MSG_WAITALL);
+            CHECK_EQUAL("OK", std::string(status));
+            uint32_t num_vectors = 2;
+            send(sockfd[0], &num_vectors, sizeof(num_vectors), 0);
+            uint32_t size = 3;
+            float data[3] = {1.0f, 2.0f, 2.0f};
+            send(sockfd[0], &size, sizeof(size), 0);
+            send(sockfd[0], data, sizeof(data), 0);
+            size = 1;
+            send(sockfd[0], &size, sizeof(size), 0);
+            send(sockfd[0], data + 1, sizeof(float), 0);
+            float results[2] = {0, 0};
+            recv(sockfd[0], results, sizeof(results), MSG_WAITALL);
+            CHECK_CLOSE(9.0f, results[0], 1e-6f);
+            CHECK_CLOSE(4.0f, results[1], 1e-6f);
+        });
+        
+        TempFile log;
+        Logger logger(log.get_path());
+        SessionStats stats;
+        CHECK(DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1", &stats));
+        sender.join();
+        CHECK_EQUAL(2u + 2 * sizeof(float), stats.snapshot().bytes_sent);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test9_4_ProcessClientDataUnknownType) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        char type_header[4] = {'T', 'Y', 'P', 'q'};
+        send(sockfd[0], type_header, sizeof(type_header), 0);
+        TempFile log;
+        Logger logger(log.get_path());
+        // Отказ без ожидания таймаута
+        auto start = std::chrono::steady_clock::now();
+        CHECK(!DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1"));
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+        char status[4] = {0};
+        recv(sockfd[0], status, 3, MSG_WAITALL);
+        CHECK_EQUAL("ERR", std::string(status));
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test10_1_FusedKernelsMatchScalar) {
+        std::vector<double> data(1037);
+        std::vector<float> floats(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = std::sin(static_cast<double>(i)) * 1000.0 + 5.0;
+            floats[i] = static_cast<float>(data[i]);
+        }
+        FusedStats expected;
+        SimdKernels::fused_kernel(SimdLevel::Scalar)(data.data() + 1, 1000, data[1], expected);
+        FusedStats expected_float;
+        SimdKernels::float_fused_kernel(SimdLevel::Scalar)(floats.data() + 1, 1000, floats[1], expected_float);
+        for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+            if (!SimdKernels::fused_kernel(level)) continue;
+            FusedStats got;
+            SimdKernels::fused_kernel(level)(data.data() + 1, 1000, data[1], got);
+            FusedStats got_float;
+            SimdKernels::float_fused_kernel(level)(floats.data() + 1, 1000, floats[1], got_float);
+            for (auto [want, have] : {std::pair{expected, got}, std::pair{expected_float, got_float}}) {
+                CHECK_CLOSE(want.sum, have.sum, 1e-9 * want.abs_sum);
+                CHECK_CLOSE(want.sum_squares, have.sum_squares, 1e-12 * want.sum_squares);
+                CHECK_EQUAL(want.min, have.min);
+                CHECK_EQUAL(want.max, have.max);
+                CHECK_CLOSE(want.abs_sum, have.abs_sum, 1e-12 * want.abs_sum);
+                CHECK_EQUAL(want.abs_max, have.abs_max);
+                CHECK_CLOSE(want.shifted_squares, have.shifted_squares, 1e-12 * want.shifted_squares);
+            }
+        }
+    }
+    
+    TEST(Test10_2_StatsAccumulatorAllStatistics) {
+        // Большое среднее: дисперсия по сдвинутым суммам не теряет точность
+        std::vector<double> data = {1e9 + 1, 1e9 + 2, 1e9 + 3, -(1e9 + 10)};
+        StatsAccumulator<double> accumulator(0xFF);
+        accumulator.add(data.data(), 3);
+        accumulator.add(data.data() + 3, 1);
+        char buffer[StatsAccumulator<double>::MAX_RESULT_SIZE];
+        CHECK_EQUAL(8 * sizeof(double), accumulator.write_results(buffer));
+        double results[8];
+        memcpy(results, buffer, sizeof(results));
+        double sum = 2e9 - 4;
+        double squares = 0;
+        for (double x : data) squares += x * x;
+        CHECK_CLOSE(squares, results[0], squares * 1e-15);
+        CHECK_EQUAL(sum, results[1]);
+        CHECK_EQUAL(-(1e9 + 10), results[2]);
+        CHECK_EQUAL(1e9 + 3, results[3]);
+        CHECK_CLOSE(sum / 4, results[4], 1e-6);
+        double mean = sum / 4;
+        double variance = 0;
+        for (double x : data) variance += (x - mean) * (x - mean);
+        CHECK_CLOSE(variance / 4, results[5], variance * 1e-12);
+        CHECK_EQUAL(4e9 + 16, results[6]);
+        CHECK_EQUAL(1e9 + 10, results[7]);
+        
+        StatsAccumulator<double> small_variance(STAT_VARIANCE);
+        small_variance.add(data.data(), 3);
+        double var = 0;
+        memcpy(&var, buffer, small_variance.write_results(buffer));
+        CHECK_CLOSE(2.0 / 3.0, var, 1e-9);
+    }
+    
+    TEST(Test10_3_StatsAccumulatorIntegers) {
+        std::vector<int32_t> data = {std::numeric_limits<int32_t>::min(), 7, 50000};
+        StatsAccumulator<int32_t> accumulator(STAT_SUM_OF_SQUARES | STAT_SUM | STAT_MIN | STAT_MAX |
+                                              STAT_MEAN | STAT_LINF_NORM);
+        accumulator.add(data.data(), data.size());
+        CHECK_EQUAL(5 * sizeof(int32_t) + sizeof(double),
+                    StatsAccumulator<int32_t>::result_size(STAT_SUM_OF_SQUARES | STAT_SUM | STAT_MIN |
+                                                           STAT_MAX | STAT_MEAN | STAT_LINF_NORM));
+        char buffer[StatsAccumulator<int32_t>::MAX_RESULT_SIZE];
+        CHECK_EQUAL(5 * sizeof(int32_t) + sizeof(double), accumulator.write_results(buffer));
+        int32_t ints[4];
+        memcpy(ints, buffer, sizeof(ints));
+        CHECK_EQUAL(std::numeric_limits<int32_t>::max(), ints[0]);
+        CHECK_EQUAL(std::numeric_limits<int32_t>::min() + 50007, ints[1]);
+        CHECK_EQUAL(std::numeric_limits<int32_t>::min(), ints[2]);
+        CHECK_EQUAL(50000, ints[3]);
+        double mean = 0;
+        memcpy(&mean, buffer + 4 * sizeof(int32_t), sizeof(mean));
+        CHECK_CLOSE((-2147483648.0 + 50007.0) / 3, mean, 1e-6);
+        int32_t linf = 0;
+        memcpy(&linf, buffer + 4 * sizeof(int32_t) + sizeof(double), sizeof(linf));
+        CHECK_EQUAL(std::numeric_limits<int32_t>::max(), linf);
+    }
+    
+    TEST(Test10_4_ProcessClientDataOperationMask) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        
+        // Тип int32 и маска "сумма, минимум, максимум, среднее" - четыре результата за вектор
+        std::thread sender([sockfd]() {
+            char headers[8] = {'T', 'Y', 'P', 'i', 'O', 'P', 'S',
+                               static_cast<char>(STAT_SUM | STAT_MIN | STAT_MAX | STAT_MEAN)};
+            send(sockfd[0], headers, sizeof(headers), 0);
+            char status[5] = {0};
+            recv(sockfd[0], status, 4, MSG_WAITALL);
+            CHECK_EQUAL("OKOK", std::string(status));
+            uint32_t packet[6] = {1, 4, 0, 0, 0, 0};
+            int32_t data[4] = {5, -3, 10, 0};
+            memcpy(packet + 2, data, sizeof(data));
+            send(sockfd[0], packet, sizeof(packet), 0);
+            char results[3 * sizeof(int32_t) + sizeof(double)];
+            recv(sockfd[0], results, sizeof(results), MSG_WAITALL);
+            int32_t ints[3];
+            double mean;
+            memcpy(ints, results, sizeof(ints));
+            memcpy(&mean, results + sizeof(ints), sizeof(mean));
+            CHECK_EQUAL(12, ints[0]);
+            CHECK_EQUAL(-3, ints[1]);
+            CHECK_EQUAL(10, ints[2]);
+            CHECK_CLOSE(3.0, mean, 1e-12);
+        });
+        
+        TempFile log;
+        Logger logger(log.get_path());
+        CHECK(DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1"));
+        sender.join();
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test10_5_ProcessClientDataEmptyMask) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        char header[4] = {'O', 'P', 'S', 0};
+        send(sockfd[0], header, sizeof(header), 0);
+        TempFile log;
+        Logger logger(log.get_path());
+        CHECK(!DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1"));
+        char status[4] = {0};
+        recv(sockfd[0], status, 3, MSG_WAITALL);
+        CHECK_EQUAL("ERR", std::string(status));
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test11_1_FrameHeaderValidation) {
+        TempFile log;
+        Logger logger(log.get_path());
+        auto make_frame = []() {
+            FrameHeader frame{};
+            frame.magic = DataCalculator::FRAME_MAGIC;
+            frame.version = DataCalculator::FRAME_VERSION;
+            frame.element_type = 'd';
+            frame.stats_mask = STAT_SUM_OF_SQUARES;
+            frame.num_vectors = 2;
+            frame.payload_length = 2 * sizeof(uint64_t) + 3 * sizeof(double);
+            return frame;
+        };
+        
+        FrameHeader frame = make_frame();
+        DataRequest request;
+        CHECK(DataCalculator::parse_frame_header(frame, request, logger));
+        CHECK(request.framed);
+        CHECK(!request.swap_bytes);
+        CHECK(request.element_type == ElementType::Double);
+        
+        // Большое количество векторов в big-endian - без угадывания порядка байт
+        frame = make_frame();
+        frame.flags = FRAME_BIG_ENDIAN;
+        frame.num_vectors = __builtin_bswap32(2);
+        frame.payload_length = __builtin_bswap64(frame.payload_length);
+        CHECK(DataCalculator::parse_frame_header(frame, request, logger));
+        CHECK(request.swap_bytes);
+        CHECK_EQUAL(2u, frame.num_vectors);
+        
+        frame = make_frame();
+        frame.version = 3;
+        CHECK(!DataCalculator::parse_frame_header(frame, request, logger));
+        frame = make_frame();
+        frame.flags = 0x80;
+        CHECK(!DataCalculator::parse_frame_header(frame, request, logger));
+        frame = make_frame();
+        frame.element_type = 'q';
+        CHECK(!DataCalculator::parse_frame_header(frame, request, logger));
+        frame = make_frame();
+        frame.num_vectors = 0;
+        CHECK(!DataCalculator::parse_frame_header(frame, request, logger));
+        frame = make_frame();
+        frame.payload_length = sizeof(uint64_t);
+        CHECK(!DataCalculator::parse_frame_header(frame, request, logger));
+        
+        // Размеры векторов проверяются по длине нагрузки
+        frame = make_frame();
+        CHECK(DataCalculator::parse_frame_header(frame, request, logger));
+        uint64_t remaining = frame.payload_length;
+        CHECK_EQUAL(2u, DataCalculator::take_frame_vector_size(2, request, false, remaining));
+        CHECK_THROW(DataCalculator::take_frame_vector_size(2, request, true, remaining), std::runtime_error);
+        remaining = frame.payload_length;
+        CHECK_THROW(DataCalculator::take_frame_vector_size(1, request, true, remaining), std::runtime_error);
+    }
+    
+    TEST(Test11_2_ProcessClientDataFrameBigEndian) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        
+        // Один вектор int32 в big-endian: в старом формате количество 1 приняло бы вид 16777216
+        std::thread sender([sockfd]() {
+            FrameHeader frame{};
+            frame.magic = DataCalculator::FRAME_MAGIC;
+            frame.version = DataCalculator::FRAME_VERSION;
+            frame.flags = FRAME_BIG_ENDIAN;
+            frame.element_type = 'i';
+            frame.stats_mask = STAT_SUM | STAT_MIN;
+            frame.num_vectors = __builtin_bswap32(1);
+            frame.payload_length = __builtin_bswap64(sizeof(uint64_t) + 3 * sizeof(int32_t));
+            uint64_t size = __builtin_bswap64(3);
+            int32_t data[3] = {static_cast<int32_t>(__builtin_bswap32(7)),
+                               static_cast<int32_t>(__builtin_bswap32(static_cast<uint32_t>(-2))),
+                               static_cast<int32_t>(__builtin_bswap32(4))};
+            send(sockfd[0], &frame, sizeof(frame), 0);
+            send(sockfd[0], &size, sizeof(size), 0);
+            send(sockfd[0], data, sizeof(data), 0);
+            int32_t results[2] = {0, 0};
+            recv(sockfd[0], results, sizeof(results), MSG_WAITALL);
+            CHECK_EQUAL(9, static_cast<int32_t>(__builtin_bswap32(results[0])));
+            CHECK_EQUAL(-2, static_cast<int32_t>(__builtin_bswap32(results[1])));
+        });
+        
+        TempFile log;
+        Logger logger(log.get_path());
+        CHECK(DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1"));
+        sender.join();
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test11_3_ProcessClientDataFrameLengthMismatch) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        FrameHeader frame{};
+        frame.magic = DataCalculator::FRAME_MAGIC;
+        frame.version = DataCalculator::FRAME_VERSION;
+        frame.element_type = 'd';
+        frame.stats_mask = STAT_SUM_OF_SQUARES;
+        frame.num_vectors = 1;
+        frame.payload_length = sizeof(uint64_t) + 4 * sizeof(double);
+        uint64_t size = 2;
+        send(sockfd[0], &frame, sizeof(frame), 0);
+        send(sockfd[0], &size, sizeof(size), 0);
+        TempFile log;
+        Logger logger(log.get_path());
+        // Несовпадение обнаруживается по размеру последнего вектора, без ожидания таймаута
+        auto start = std::chrono::steady_clock::now();
+        CHECK(!DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1"));
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test11_4_FrameAfterNegotiationRejected) {
+        DataRequest request;
+        uint32_t type_header;
+        memcpy(&type_header, "TYPf", sizeof(type_header));
+        CHECK(BatchHeader::Frame == DataCalculator::classify_batch_header(DataCalculator::FRAME_MAGIC, request));
+        CHECK(BatchHeader::Negotiation == DataCalculator::classify_batch_header(type_header, request));
+        CHECK(BatchHeader::VectorCount == DataCalculator::classify_batch_header(2, request));
+        
+        TempFile log;
+        Logger logger(log.get_path());
+        CHECK(DataCalculator::apply_negotiation_header(type_header, request, logger));
+        CHECK(BatchHeader::Misplaced == DataCalculator::classify_batch_header(DataCalculator::FRAME_MAGIC, request));
+        CHECK(BatchHeader::VectorCount == DataCalculator::classify_batch_header(2, request));
+    }
+    
+    TEST(Test12_1_ProcessClientDataKeepAlive) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        
+        // Два пакета по одному соединению; второй согласует свой тип, затем клиент закрывает сокет
+        std::thread sender([sockfd]() {
+            uint32_t first[4] = {1, 1, 0, 0};
+            double value = 3.0;
+            memcpy(first + 2, &value, sizeof(value));
+            send(sockfd[0], first, sizeof(first), 0);
+            double result = 0;
+            recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+            CHECK_CLOSE(9.0, result, 1e-12);
+            
+            char type_header[4] = {'T', 'Y', 'P', 'i'};
+            send(sockfd[0], type_header, sizeof(type_header), 0);
+            char status[3] = {0};
+            recv(sockfd[0], status, 2, MSG_WAITALL);
+            CHECK_EQUAL("OK", std::string(status));
+            int32_t second[4] = {1, 2, 2, -5};
+            send(sockfd[0], second, sizeof(second), 0);
+            int32_t int_result = 0;
+            recv(sockfd[0], &int_result, sizeof(int_result), MSG_WAITALL);
+            CHECK_EQUAL(29, int_result);
+            shutdown(sockfd[0], SHUT_WR);
+        });
+        
+        TempFile log;
+        Logger logger(log.get_path());
+        SessionStats stats;
+        auto start = std::chrono::steady_clock::now();
+        CHECK(DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1", &stats, 5));
+        sender.join();
+        // Закрытие соединения завершает сессию сразу, не дожидаясь простоя
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+        CHECK_EQUAL(2u, stats.snapshot().batches_processed);
+        CHECK_EQUAL(2u, stats.snapshot().vectors_processed);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test12_2_ProcessClientDataIdleTimeout) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        uint32_t packet[4] = {1, 1, 0, 0};
+        double value = 2.0;
+        memcpy(packet + 2, &value, sizeof(value));
+        send(sockfd[0], packet, sizeof(packet), 0);
+        TempFile log;
+        Logger logger(log.get_path());
+        SessionStats stats;
+        // Клиент молчит после пакета: простой - штатное завершение
+        CHECK(DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1", &stats, 1));
+        CHECK_EQUAL(1u, stats.snapshot().batches_processed);
+        double result = 0;
+        recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+        CHECK_CLOSE(4.0, result, 1e-12);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test8_4_StreamedLargeVectorMatchesWholeArray) {
+        std::vector<double> data(DataCalculator::PARALLEL_REDUCTION_THRESHOLD * 2 + 4321);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = std::cos(static_cast<double>(i)) * 1e2;
+        }
+        double whole = DataCalculator::calculate_sum_of_squares(data);
+        // Порции неровные, как при приёме из сети
+        SquareSumAccumulator<double> accumulator(data.size());
+        size_t offset = 0;
+        for (size_t step = 1; offset < data.size(); step = step * 7 % 9000 + 1) {
+            size_t count = std::min(step, data.size() - offset);
+            accumulator.add(data.data() + offset, count);
+            offset += count;
+        }
+        CHECK_EQUAL(whole, accumulator.result());
+    }
+    
+    TEST(Test8_3_ComputePoolCoversAllIndices) {
+        std::vector<std::atomic<int>> visits(1000);
+        ComputePool::instance().parallel_for(visits.size(), [&visits](size_t index) {
+            visits[index]++;
+        });
+        bool once = true;
+        for (auto& count : visits) {
+            once = once && count.load() == 1;
+        }
+        CHECK(once);
+    }
+    
+    TEST(Test5_1_UringReadSendExact) {
+        if (!IoUring::is_supported()) return;
+        IoUring* ring = IoUring::for_current_thread();
+        CHECK(ring != nullptr);
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        double out = 2.5;
+        CHECK(ring->send_exact(sockfd[0], &out, sizeof(out), 1));
+        double in = 0;
+        CHECK(ring->read_exact(sockfd[1], &in, sizeof(in), 1));
+        CHECK_CLOSE(2.5, in, 0.0001);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test5_2_UringReadTimeout) {
+        if (!IoUring::is_supported()) return;
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        uint32_t data = 0;
+        CHECK_THROW(IoUring::for_current_thread()->read_exact(sockfd[1], &data, sizeof(data), 1),
+                    std::runtime_error);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test5_3_ProcessClientDataUring) {
+        if (DataCalculator::set_io_backend(IoBackend::Uring) != IoBackend::Uring) return;
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        
+        std::thread sender([sockfd]() {
+            uint32_t header[2] = {3, 2};
+            double first[2] = {1.0, 2.0};
+            uint32_t empty_size = 0;
+            uint32_t third_size = 1;
+            double third = 4.0;
+            send(sockfd[0], header, sizeof(header), 0);
+            send(sockfd[0], first, sizeof(first), 0);
+            send(sockfd[0], &empty_size, sizeof(empty_size), 0);
+            send(sockfd[0], &third_size, sizeof(third_size), 0);
+            send(sockfd[0], &third, sizeof(third), 0);
+            double results[3] = {0, 0, 0};
+            recv(sockfd[0], results, sizeof(results), MSG_WAITALL);
+            CHECK_CLOSE(5.0, results[0], 0.0001);
+            CHECK_CLOSE(0.0, results[1], 0.0001);
+            CHECK_CLOSE(16.0, results[2], 0.0001);
+        });
+        
+        TempFile log;
+        Logger logger(log.get_path());
+        bool result = DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1");
+        sender.join();
+        DataCalculator::set_io_backend(IoBackend::Select);
+        CHECK(result);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test4_3_ProcessClientDataByteOrder) {
+    int sockfd[2];
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+    
+    std::thread sender([sockfd]() {
+        // Отправляем только 1 вектор вместо 2
+        uint32_t num_vectors = htonl(1);  // ← ИЗМЕНИТЬ с 2 на 1!
+        send(sockfd[0], &num_vectors, sizeof(num_vectors), 0);
+        uint32_t vector_size = htonl(2);
+        send(sockfd[0], &vector_size, sizeof(vector_size), 0);
+        double data[2] = {1.5, 2.5};
+        send(sockfd[0], data, sizeof(data), 0);
+        double result = 0;
+        recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+        CHECK_CLOSE(8.5, result, 0.0001);
+        shutdown(sockfd[0], SHUT_WR);
+    });
+    
+    TempFile log;
+    Logger logger(log.get_path());
+    bool result = DataCalculator::process_client_data(sockfd[1], logger, "127.0.0.1");
+    sender.join();
+    CHECK(result);
+    close(sockfd[0]); close(sockfd[1]);
+    }
+}
+
+// ===================== ТЕСТЫ ДЛЯ WORKERPOOL (Таблица 6) =====================
+
+SUITE(WorkerPoolTests) {
+    TEST(Test1_1_QueuePushPop) {
+        LockFreeQueue<int> queue(4);
+        CHECK(queue.push(1));
+        CHECK(queue.push(2));
+        int value = 0;
+        CHECK(queue.pop(value));
+        CHECK_EQUAL(1, value);
+        CHECK(queue.pop(value));
+        CHECK_EQUAL(2, value);
+        CHECK(!queue.pop(value));
+    }
+    
+    TEST(Test1_2_QueueFull) {
+        LockFreeQueue<int> queue(2);
+        CHECK(queue.push(1));
+        CHECK(queue.push(2));
+        CHECK(!queue.push(3));
+    }
+    
+    TEST(Test1_3_QueueInvalidCapacity) {
+        CHECK_THROW(LockFreeQueue<int> queue(3), std::invalid_argument);
+    }
+    
+    TEST(Test2_1_PoolProcessesAllSockets) {
+        std::atomic<int> processed(0);
+        std::atomic<int> sum(0);
+        std::atomic<int> address_mismatches(0);
+        WorkerPool pool(4, 64, [&](int value, uint32_t address) {
+            sum += value;
+            if (address != static_cast<uint32_t>(1000 + value)) address_mismatches++;
+            processed++;
+        });
+        pool.start();
+        for (int i = 1; i <= 50; i++) {
+            CHECK(pool.submit(i, 1000 + i));
+        }
+        for (int i = 0; i < 200 && processed < 50; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        pool.stop();
+        pool.join();
+        CHECK_EQUAL(50, processed.load());
+        CHECK_EQUAL(1275, sum.load());
+        CHECK_EQUAL(0, address_mismatches.load());
+    }
+    
+    TEST(Test2_2_PoolRejectsAfterStop) {
+        WorkerPool pool(2, 8, [](int, uint32_t) {});
+        pool.start();
+        pool.stop();
+        CHECK(!pool.submit(1));
+        pool.join();
+    }
+    
+    TEST(Test3_1_AdmissionSessionLimit) {
+        AdmissionController admission(2, std::chrono::milliseconds(0), std::chrono::milliseconds(100));
+        CHECK(admission.try_admit());
+        CHECK(admission.try_admit());
+        CHECK(!admission.try_admit());
+        admission.release();
+        CHECK(admission.try_admit());
+        CHECK_EQUAL(2u, admission.active_sessions());
+    }
+    
+    TEST(Test3_2_AdmissionShedsStandingQueue) {
+        using std::chrono::milliseconds;
+        AdmissionController admission(0, milliseconds(10), milliseconds(100));
+        auto start = std::chrono::steady_clock::now();
+        CHECK(!admission.should_shed(milliseconds(5), start));
+        CHECK(!admission.should_shed(milliseconds(20), start));
+        CHECK(!admission.should_shed(milliseconds(20), start + milliseconds(50)));
+        CHECK(admission.should_shed(milliseconds(20), start + milliseconds(150)));
+        CHECK(!admission.should_shed(milliseconds(5), start + milliseconds(160)));
+        CHECK(!admission.should_shed(milliseconds(20), start + milliseconds(170)));
+        CHECK_EQUAL(1u, admission.shed_count());
+    }
+    
+    TEST(Test3_3_PoolShedsStaleSockets) {
+        AdmissionController admission(0, std::chrono::milliseconds(10), std::chrono::milliseconds(0));
+        std::atomic<int> processed(0);
+        std::atomic<int> rejected(0);
+        WorkerPool pool(1, 16, [&](int, uint32_t) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            processed++;
+        }, [&](int, uint32_t) { rejected++; }, &admission);
+        pool.start();
+        for (int i = 1; i <= 6; i++) {
+            CHECK(pool.submit(i));
+        }
+        for (int i = 0; i < 200 && processed + rejected < 6; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        pool.stop();
+        pool.join();
+        CHECK_EQUAL(6, processed.load() + rejected.load());
+        CHECK(rejected.load() > 0);
+    }
+}
+
+// ===================== ТЕСТЫ ДЛЯ CLIENTSESSION (Таблица 7) =====================
+
+SUITE(ClientSessionTests) {
+    TEST(Test1_1_SessionWaitsForLogin) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        
+        CHECK(session.handle_io());
+        CHECK(session.get_state() == SessionState::AwaitingLogin);
+        
+        send(sockfd[0], "user", 4, 0);
+        CHECK(session.handle_io());
+        CHECK(session.get_state() == SessionState::AwaitingHash);
+        char salt[17] = {0};
+        CHECK_EQUAL(16, recv(sockfd[0], salt, 16, MSG_WAITALL));
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test1_2_SessionFullExchange) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile users("user:secret\n");
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        auth.load_users(users.get_path());
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        
+        send(sockfd[0], "user", 4, 0);
+        session.handle_io();
+        char salt[17] = {0};
+        recv(sockfd[0], salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "secret");
+        send(sockfd[0], hash.c_str(), hash.length(), 0);
+        session.handle_io();
+        char status[3] = {0};
+        recv(sockfd[0], status, 2, MSG_WAITALL);
+        CHECK_EQUAL("OK", std::string(status));
+        
+        uint32_t header[2] = {1, 2};
+        double data[2] = {3.0, 4.0};
+        send(sockfd[0], header, sizeof(header), 0);
+        send(sockfd[0], data, sizeof(data), 0);
+        CHECK(!session.handle_io());
+        CHECK(session.get_state() == SessionState::Finished);
+        double result = 0;
+        recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+        CHECK_CLOSE(25.0, result, 0.0001);
+        CHECK_EQUAL(1u, stats.snapshot().vectors_processed);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test1_4_SessionStreamsExtendedVector) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile users("user:secret\n");
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        auth.load_users(users.get_path());
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        
+        send(sockfd[0], "user", 4, 0);
+        session.handle_io();
+        char salt[17] = {0};
+        recv(sockfd[0], salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "secret");
+        send(sockfd[0], hash.c_str(), hash.length(), 0);
+        session.handle_io();
+        char status[3] = {0};
+        recv(sockfd[0], status, 2, MSG_WAITALL);
+        
+        // Вектор больше порции приёма: элементы сворачиваются по частям
+        uint32_t header[2] = {1, DataCalculator::VECTOR_SIZE_EXTENDED};
+        uint64_t elements = 10000;
+        std::vector<double> data(elements, 2.0);
+        send(sockfd[0], header, sizeof(header), 0);
+        send(sockfd[0], &elements, sizeof(elements), 0);
+        send(sockfd[0], data.data(), data.size() * sizeof(double), 0);
+        for (int i = 0; i < 10 && session.handle_io(); i++) {
+        }
+        CHECK(session.get_state() == SessionState::Finished);
+        double result = 0;
+        recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+        CHECK_CLOSE(40000.0, result, 0.0001);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test1_5_SessionNegotiatesInt32) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile users("user:secret\n");
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        auth.load_users(users.get_path());
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        
+        send(sockfd[0], "user", 4, 0);
+        session.handle_io();
+        char salt[17] = {0};
+        recv(sockfd[0], salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "secret");
+        send(sockfd[0], hash.c_str(), hash.length(), 0);
+        session.handle_io();
+        char status[3] = {0};
+        recv(sockfd[0], status, 2, MSG_WAITALL);
+        
+        char type_header[4] = {'T', 'Y', 'P', 'i'};
+        send(sockfd[0], type_header, sizeof(type_header), 0);
+        session.handle_io();
+        char type_status[3] = {0};
+        recv(sockfd[0], type_status, 2, MSG_WAITALL);
+        CHECK_EQUAL("OK", std::string(type_status));
+        
+        uint32_t header[2] = {2, 2};
+        int32_t data[2] = {3, -4};
+        send(sockfd[0], header, sizeof(header), 0);
+        send(sockfd[0], data, sizeof(data), 0);
+        uint32_t empty_size = 0;
+        send(sockfd[0], &empty_size, sizeof(empty_size), 0);
+        for (int i = 0; i < 10 && session.handle_io(); i++) {
+        }
+        CHECK(session.get_state() == SessionState::Finished);
+        int32_t results[2] = {-1, -1};
+        recv(sockfd[0], results, sizeof(results), MSG_WAITALL);
+        CHECK_EQUAL(25, results[0]);
+        CHECK_EQUAL(0, results[1]);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test1_6_SessionFrameV2) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile users("user:secret\n");
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        auth.load_users(users.get_path());
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        
+        send(sockfd[0], "user", 4, 0);
+        session.handle_io();
+        char salt[17] = {0};
+        recv(sockfd[0], salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "secret");
+        send(sockfd[0], hash.c_str(), hash.length(), 0);
+        session.handle_io();
+        char status[3] = {0};
+        recv(sockfd[0], status, 2, MSG_WAITALL);
+        
+        // Кадр без подтверждения: заголовок и нагрузка идут подряд
+        FrameHeader frame{};
+        frame.magic = DataCalculator::FRAME_MAGIC;
+        frame.version = DataCalculator::FRAME_VERSION;
+        frame.element_type = 'd';
+        frame.stats_mask = STAT_SUM_OF_SQUARES | STAT_MAX;
+        frame.num_vectors = 2;
+        frame.payload_length = 2 * sizeof(uint64_t) + 3 * sizeof(double);
+        uint64_t first_size = 2;
+        double first[2] = {3.0, 4.0};
+        uint64_t second_size = 1;
+        double second = -1.5;
+        send(sockfd[0], &frame, sizeof(frame), 0);
+        send(sockfd[0], &first_size, sizeof(first_size), 0);
+        send(sockfd[0], first, sizeof(first), 0);
+        send(sockfd[0], &second_size, sizeof(second_size), 0);
+        send(sockfd[0], &second, sizeof(second), 0);
+        for (int i = 0; i < 10 && session.handle_io(); i++) {
+        }
+        CHECK(session.get_state() == SessionState::Finished);
+        double results[4] = {0, 0, 0, 0};
+        recv(sockfd[0], results, sizeof(results), MSG_WAITALL);
+        CHECK_CLOSE(25.0, results[0], 1e-12);
+        CHECK_CLOSE(4.0, results[1], 1e-12);
+        CHECK_CLOSE(2.25, results[2], 1e-12);
+        CHECK_CLOSE(-1.5, results[3], 1e-12);
+        CHECK_EQUAL(2u, stats.snapshot().vectors_processed);
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test1_7_SessionKeepAlive) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile users("user:secret\n");
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        auth.load_users(users.get_path());
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats, 5);
+        
+        send(sockfd[0], "user", 4, 0);
+        session.handle_io();
+        char salt[17] = {0};
+        recv(sockfd[0], salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "secret");
+        send(sockfd[0], hash.c_str(), hash.length(), 0);
+        session.handle_io();
+        char status[3] = {0};
+        recv(sockfd[0], status, 2, MSG_WAITALL);
+        
+        uint32_t packet[4] = {1, 1, 0, 0};
+        for (double value : {2.0, 5.0}) {
+            memcpy(packet + 2, &value, sizeof(value));
+            send(sockfd[0], packet, sizeof(packet), 0);
+            for (int i = 0; i < 10 && session.handle_io(); i++) {
+            }
+            // После пакета сессия ждёт следующий со сроком простоя
+            CHECK(session.get_state() == SessionState::ReadingVectorCount);
+            CHECK(!session.expired(std::chrono::steady_clock::now() + std::chrono::seconds(2)));
+            double result = 0;
+            recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+            CHECK_CLOSE(value * value, result, 1e-12);
+        }
+        
+        close(sockfd[0]);
+        CHECK(!session.handle_io());
+        CHECK_EQUAL(2u, stats.snapshot().batches_processed);
+        close(sockfd[1]);
+    }
+    
+    TEST(Test1_8_SessionResumesWithTicket) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile users("user:secret\n");
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        auth.load_users(users.get_path());
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        
+        // Билет в первом сообщении: без соли и хеша сразу "OK" и новый билет
+        std::string resume = "RESUME:" + auth.issue_ticket("user");
+        send(sockfd[0], resume.c_str(), resume.length(), 0);
+        session.handle_io();
+        std::string reply(2 + AuthManager::ticket_length("user"), '\0');
+        CHECK_EQUAL(static_cast<ssize_t>(reply.size()), recv(sockfd[0], reply.data(), reply.size(), MSG_WAITALL));
+        CHECK_EQUAL("OK", reply.substr(0, 2));
+        
+        uint32_t packet[4] = {1, 1, 0, 0};
+        double value = 3.0;
+        memcpy(packet + 2, &value, sizeof(value));
+        send(sockfd[0], packet, sizeof(packet), 0);
+        for (int i = 0; i < 10 && session.handle_io(); i++) {
+        }
+        CHECK(session.get_state() == SessionState::Finished);
+        double result = 0;
+        recv(sockfd[0], &result, sizeof(result), MSG_WAITALL);
+        CHECK_CLOSE(9.0, result, 1e-12);
+        
+        // Новый билет действителен
+        std::string login;
+        CHECK(auth.resume(reply.substr(2), login, logger, "127.0.0.1"));
+        close(sockfd[0]); close(sockfd[1]);
+    }
+    
+    TEST(Test1_3_SessionClientClosed) {
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        fcntl(sockfd[1], F_SETFL, O_NONBLOCK);
+        TempFile log;
+        Logger logger(log.get_path());
+        AuthManager auth;
+        SessionStats stats;
+        ClientSession session(sockfd[1], "127.0.0.1", auth, logger, stats);
+        close(sockfd[0]);
+        CHECK(!session.handle_io());
+        close(sockfd[1]);
+    }
+}
+
+// ===================== ТЕСТЫ ДЛЯ COROSESSION (Таблица 8) =====================
+
+Task<int> coro_answer() { co_return 42; }
+
+Task<int> coro_answer_plus_one() {
+    int answer = co_await coro_answer();
+    co_return answer + 1;
+}
+
+Task<void> coro_fail() {
+    throw std::runtime_error("coroutine failure");
+    co_return;
+}
+
+DetachedTask coro_collect(Task<int> task, int& out) {
+    out = co_await task;
+}
+
+DetachedTask coro_catch(Task<void> task, std::string& error) {
+    try {
+        co_await task;
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+}
+
+SUITE(CoroSessionTests) {
+    TEST(Test1_1_NestedTaskResult) {
+        int result = 0;
+        coro_collect(coro_answer_plus_one(), result);
+        CHECK_EQUAL(43, result);
+    }
+    
+    TEST(Test1_2_TaskExceptionPropagates) {
+        std::string error;
+        coro_catch(coro_fail(), error);
+        CHECK_EQUAL("coroutine failure", error);
+    }
+    
+    TEST(Test2_1_ConcurrentClientsCoroutines) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Coroutine;
+        options.worker_threads = 2;
+        Server server(33347, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        std::atomic<int> succeeded(0);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < 16; i++) {
+            clients.emplace_back([&succeeded, i]() {
+                try {
+                    auto results = run_test_client(33347, "test", "pass", {{double(i)}, {}, {1.0, 1.0}});
+                    if (results.size() == 3 && std::abs(results[0] - i * i) < 1e-9 &&
+                        results[1] == 0.0 && std::abs(results[2] - 2.0) < 1e-9) {
+                        succeeded++;
+                    }
+                } catch (const std::exception&) {
+                }
+            });
+        }
+        for (auto& client : clients) client.join();
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(16, succeeded.load());
+        CHECK_EQUAL(48u, server.get_stats().vectors_processed);
+    }
+    
+    TEST(Test2_2_IdleSessionsAndWrongPassword) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Coroutine;
+        options.worker_threads = 1;
+        Server server(33348, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        // Молчащие клиенты приостанавливают свои сессии и не мешают остальным
+        std::vector<int> idle_socks;
+        for (int i = 0; i < 64; i++) {
+            int sock = create_test_socket();
+            struct sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(33348);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+                idle_socks.push_back(sock);
+            } else {
+                close(sock);
+            }
+        }
+        
+        CHECK_THROW(run_test_client(33348, "test", "wrong", {{1.0}}), std::runtime_error);
+        auto results = run_test_client(33348, "test", "pass", {{2.0, 2.0}});
+        CHECK_EQUAL(1u, results.size());
+        
+        server.stop();
+        server_thread.join();
+        for (int sock : idle_socks) close(sock);
+        
+        StatsSnapshot stats = server.get_stats();
+        CHECK_EQUAL(1u, stats.auth_failures);
+        CHECK_EQUAL(stats.connections_accepted, stats.connections_closed);
+        CHECK_EQUAL(idle_socks.size() + 2, stats.connections_accepted);
+    }
+    
+    TEST(Test2_3_MaxSessionsRejectsWithErr) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Coroutine;
+        options.worker_threads = 1;
+        options.max_sessions = 1;
+        Server server(33349, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        int idle_sock = create_test_socket();
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(33349);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(connect(idle_sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        
+        CHECK_THROW(run_test_client(33349, "test", "pass", {{1.0}}), std::runtime_error);
+        close(idle_sock);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto results = run_test_client(33349, "test", "pass", {{1.0}});
+        CHECK_EQUAL(1u, results.size());
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(1u, server.get_stats().connections_rejected);
+    }
+    
+    TEST(Test2_4_KeepAliveBatchesPerConnection) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Coroutine;
+        options.worker_threads = 1;
+        options.keep_alive_sec = 5;
+        Server server(33350, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        int sock = create_test_socket();
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(33350);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+        send(sock, "test", 4, 0);
+        char salt[17] = {0};
+        recv(sock, salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "pass");
+        send(sock, hash.c_str(), hash.length(), 0);
+        char status[3] = {0};
+        recv(sock, status, 2, MSG_WAITALL);
+        CHECK_EQUAL("OK", std::string(status));
+        
+        // Рукопожатие один раз, затем три пакета по тому же соединению
+        for (int batch = 1; batch <= 3; batch++) {
+            uint32_t packet[4] = {1, 1, 0, 0};
+            double value = batch;
+            memcpy(packet + 2, &value, sizeof(value));
+            send(sock, packet, sizeof(packet), 0);
+            double result = 0;
+            CHECK_EQUAL(static_cast<ssize_t>(sizeof(result)), recv(sock, &result, sizeof(result), MSG_WAITALL));
+            CHECK_CLOSE(value * value, result, 1e-12);
+        }
+        close(sock);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        
+        server.stop();
+        server_thread.join();
+        StatsSnapshot stats = server.get_stats();
+        CHECK_EQUAL(1u, stats.connections_accepted);
+        CHECK_EQUAL(1u, stats.connections_closed);
+        CHECK_EQUAL(3u, stats.batches_processed);
+    }
+    
+    TEST(Test2_5_ResumptionTicketSkipsHandshake) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Coroutine;
+        options.worker_threads = 1;
+        options.keep_alive_sec = 0;
+        Server server(33351, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        auto connect_client = []() {
+            int sock = create_test_socket();
+            struct sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(33351);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            CHECK(connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+            return sock;
+        };
+        auto send_batch = [](int sock, double value) {
+            uint32_t packet[4] = {1, 1, 0, 0};
+            memcpy(packet + 2, &value, sizeof(value));
+            send(sock, packet, sizeof(packet), 0);
+            double result = 0;
+            recv(sock, &result, sizeof(result), MSG_WAITALL);
+            return result;
+        };
+        const size_t reply_size = 2 + AuthManager::ticket_length("test");
+        
+        // Полное рукопожатие с запросом билета
+        int sock = connect_client();
+        send(sock, "TICKET:test", 11, 0);
+        char salt[17] = {0};
+        recv(sock, salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "pass");
+        send(sock, hash.c_str(), hash.length(), 0);
+        std::string reply(reply_size, '\0');
+        CHECK_EQUAL(static_cast<ssize_t>(reply_size), recv(sock, reply.data(), reply_size, MSG_WAITALL));
+        CHECK_EQUAL("OK", reply.substr(0, 2));
+        CHECK_CLOSE(4.0, send_batch(sock, 2.0), 1e-12);
+        close(sock);
+        
+        // Переподключение по билету: сразу "OK" и следующий билет
+        std::string first_ticket = reply.substr(2);
+        sock = connect_client();
+        std::string resume = "RESUME:" + first_ticket;
+        send(sock, resume.c_str(), resume.length(), 0);
+        CHECK_EQUAL(static_cast<ssize_t>(reply_size), recv(sock, reply.data(), reply_size, MSG_WAITALL));
+        CHECK_EQUAL("OK", reply.substr(0, 2));
+        CHECK(reply.substr(2) != first_ticket);
+        CHECK_CLOSE(9.0, send_batch(sock, 3.0), 1e-12);
+        close(sock);
+        
+        // Повтор использованного билета - отказ
+        sock = connect_client();
+        send(sock, resume.c_str(), resume.length(), 0);
+        char status[4] = {0};
+        recv(sock, status, 3, MSG_WAITALL);
+        CHECK_EQUAL("ERR", std::string(status));
+        close(sock);
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(1u, server.get_stats().auth_failures);
+        CHECK_EQUAL(2u, server.get_stats().vectors_processed);
+    }
+}
+
+// ===================== ТЕСТЫ ДЛЯ BUFFERPOOL (Таблица 9) =====================
+
+SUITE(BufferPoolTests) {
+    TEST(Test1_1_SizeClasses) {
+        CHECK_EQUAL(0u, BufferPool::size_class(1));
+        CHECK_EQUAL(0u, BufferPool::size_class(64));
+        CHECK_EQUAL(1u, BufferPool::size_class(65));
+        CHECK_EQUAL(128u, BufferPool::class_size(1));
+        CHECK_EQUAL(BufferPool::CLASS_COUNT - 1, BufferPool::size_class(16 * 1024 * 1024));
+        CHECK_EQUAL(BufferPool::CLASS_COUNT, BufferPool::size_class(16 * 1024 * 1024 + 1));
+    }
+    
+    TEST(Test1_2_BufferReusedAndAligned) {
+        PooledBuffer first(1000);
+        CHECK_EQUAL(1024u, first.size());
+        CHECK_EQUAL(0u, reinterpret_cast<uintptr_t>(first.data()) % 64);
+        char* memory = first.data();
+        first.reset();
+        
+        uint64_t hits = BufferPool::instance().get_stats().hits;
+        PooledBuffer second(900);
+        CHECK(memory == second.data());
+        CHECK_EQUAL(hits + 1, BufferPool::instance().get_stats().hits);
+    }
+    
+    TEST(Test1_3_LargeBufferReserve) {
+        PooledBuffer buffer(100);
+        buffer.reserve(4 * 1024 * 1024);
+        CHECK_EQUAL(4u * 1024 * 1024, buffer.size());
+        memset(buffer.data(), 1, buffer.size());
+        char* memory = buffer.data();
+        buffer.reserve(3 * 1024 * 1024);
+        CHECK(memory == buffer.data());
+    }
+    
+    TEST(Test1_4_ThreadCacheReturnedOnExit) {
+        const size_t bytes = 12345;
+        std::thread worker([bytes]() {
+            std::vector<PooledBuffer> buffers;
+            for (int i = 0; i < 6; i++) buffers.emplace_back(bytes);
+        });
+        worker.join();
+        
+        uint64_t misses = BufferPool::instance().get_stats().misses;
+        std::vector<PooledBuffer> buffers;
+        for (int i = 0; i < 6; i++) buffers.emplace_back(bytes);
+        CHECK_EQUAL(misses, BufferPool::instance().get_stats().misses);
+    }
+}
+
+SUITE(SaltReservoirTests) {
+    TEST(Test1_1_SaltsAreHexAndUnique) {
+        SaltReservoir reservoir(8);
+        std::set<std::string> seen;
+        for (int i = 0; i < 1000; i++) {
+            char salt[SaltReservoir::SALT_SIZE];
+            reservoir.take(salt);
+            std::string text(salt, sizeof(salt));
+            CHECK_EQUAL(std::string::npos, text.find_first_not_of("0123456789ABCDEF"));
+            seen.insert(text);
+        }
+        CHECK_EQUAL(1000u, seen.size());
+    }
+    
+    TEST(Test1_2_WithoutReservoirEverySaltIsMiss) {
+        SaltReservoir reservoir(0);
+        char salt[SaltReservoir::SALT_SIZE];
+        reservoir.take(salt);
+        reservoir.take(salt);
+        CHECK_EQUAL(2u, reservoir.get_misses());
+    }
+    
+    TEST(Test1_3_ConcurrentTakers) {
+        SaltReservoir reservoir(64);
+        std::vector<std::vector<std::string>> taken(4);
+        std::vector<std::thread> threads;
+        for (auto& list : taken) {
+            threads.emplace_back([&reservoir, &list]() {
+                for (int i = 0; i < 500; i++) {
+                    char salt[SaltReservoir::SALT_SIZE];
+                    reservoir.take(salt);
+                    list.emplace_back(salt, sizeof(salt));
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        std::set<std::string> seen;
+        for (const auto& list : taken) seen.insert(list.begin(), list.end());
+        CHECK_EQUAL(2000u, seen.size());
+    }
+}
+
+SUITE(UserStoreTests) {
+    TEST(Test1_1_BuildAndFind) {
+        std::vector<std::pair<std::string, std::string>> users;
+        for (int i = 0; i < 1000; i++) {
+            users.emplace_back("user" + std::to_string(i), "pass" + std::to_string(i));
+        }
+        users.emplace_back("user7", "changed");
+        auto store = UserStore::build(users);
+        CHECK_EQUAL(1000u, store->size());
+        CHECK(!store->is_mapped());
+        std::string_view password;
+        CHECK(store->find("user999", password));
+        CHECK_EQUAL("pass999", std::string(password));
+        // Повтор логина: действует последняя строка
+        CHECK(store->find("user7", password));
+        CHECK_EQUAL("changed", std::string(password));
+        CHECK(!store->contains("user1000"));
+        CHECK(!store->contains(""));
+    }
+    
+    TEST(Test1_2_CompiledFileIsMapped) {
+        TempFile text("# comment\n alice : secret \nbob:hunter2\n");
+        TempFile binary("", ".bin");
+        CHECK_EQUAL(2u, UserStore::compile(text.get_path(), binary.get_path()));
+        auto store = UserStore::open(binary.get_path());
+        CHECK(store->is_mapped());
+        std::string_view password;
+        CHECK(store->find("alice", password));
+        CHECK_EQUAL("secret", std::string(password));
+        
+        AuthManager auth;
+        auth.load_users(binary.get_path());
+        std::string salt = auth.generate_salt();
+        CHECK(auth.check_credentials("bob", AuthManager::compute_md5_hash(salt, "hunter2"), salt) == AuthResult::Accepted);
+        CHECK(auth.check_credentials("carol", AuthManager::compute_md5_hash(salt, "x"), salt) == AuthResult::UnknownUser);
+    }
+    
+    TEST(Test1_3_CorruptedFileRejected) {
+        TempFile text("alice:secret\n");
+        TempFile binary("", ".bin");
+        UserStore::compile(text.get_path(), binary.get_path());
+        std::string image;
+        {
+            std::ifstream file(binary.get_path(), std::ios::binary);
+            image.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        auto write_image = [&binary](const std::string& data) {
+            std::ofstream(binary.get_path(), std::ios::binary | std::ios::trunc) << data;
+        };
+        
+        write_image(image.substr(0, image.size() - 4));
+        CHECK_THROW(UserStore::open(binary.get_path()), std::runtime_error);
+        
+        std::string wrong_version = image;
+        wrong_version[8] = 9;
+        write_image(wrong_version);
+        CHECK_THROW(UserStore::open(binary.get_path()), std::runtime_error);
+    }
+}
+
+// ===================== ТЕСТЫ ДЛЯ SERVER (Таблица 10) =====================
+
+SUITE(BinaryLogTests) {
+    //! \brief Прочитать файл двоичного журнала декодером
+    std::string decode_file(const std::string& path, LogOutputFormat format) {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream out;
+        BinaryLogDecoder::decode(file, out, format);
+        return out.str();
+    }
+    
+    TEST(Test1_1_DecodedTextMatchesTextLog) {
+        TempFile temp;
+        LoggerOptions options;
+        options.format = LogFormat::Binary;
+        {
+            Logger logger(temp.get_path(), options);
+            logger.log_connection("127.0.0.1", true);
+            logger.log_auth("127.0.0.1", "user", false, "Hash mismatch");
+            logger.log_auth("not-an-ip", "user", true);
+            logger.log_data("127.0.0.1", "Processing client data");
+            logger.log_error("boom");
+            logger.log_batch(LogEvent::BatchProcessed, "127.0.0.1", 12);
+        }
+        std::string text = decode_file(temp.get_path(), LogOutputFormat::Text);
+        CHECK(text.find("] === Server started ===\n") != std::string::npos);
+        CHECK(text.find("] CLIENT [127.0.0.1] connected\n") != std::string::npos);
+        CHECK(text.find("] AUTH [127.0.0.1] user 'user' : FAILED (Hash mismatch)\n") != std::string::npos);
+        CHECK(text.find("] AUTH [not-an-ip] user 'user' : SUCCESS\n") != std::string::npos);
+        CHECK(text.find("] DATA [127.0.0.1] Processing client data\n") != std::string::npos);
+        CHECK(text.find("] ERROR: boom\n") != std::string::npos);
+        CHECK(text.find("] DATA [127.0.0.1] Successfully processed 12 vectors\n") != std::string::npos);
+        CHECK(text.find("] === Server stopped ===\n") != std::string::npos);
+    }
+    
+    TEST(Test1_4_BinaryLogIsSeveralTimesSmaller) {
+        TempFile text_log;
+        TempFile binary_log;
+        LoggerOptions options;
+        for (const TempFile* temp : {&text_log, &binary_log}) {
+            options.format = temp == &binary_log ? LogFormat::Binary : LogFormat::Text;
+            Logger logger(temp->get_path(), options);
+            for (int i = 0; i < 100; i++) {
+                logger.log_connection("192.168.10.25", true);
+                logger.log_batch(LogEvent::BatchStarted, "192.168.10.25");
+                logger.log_batch(LogEvent::BatchProcessed, "192.168.10.25", 16);
+                logger.log_batch(LogEvent::ConnectionServed, "192.168.10.25", 1);
+                logger.log_connection("192.168.10.25", false);
+            }
+        }
+        CHECK(fs::file_size(binary_log.get_path()) * 3 < fs::file_size(text_log.get_path()));
+    }
+    
+    TEST(Test1_2_AsyncJsonAcrossSessions) {
+        TempFile temp;
+        LoggerOptions options;
+        options.format = LogFormat::Binary;
+        options.async = true;
+        for (int session = 0; session < 2; session++) {
+            Logger logger(temp.get_path(), options);
+            logger.log_auth("10.0.0.1", "a\"b", true, "Ticket resumed");
+        }
+        std::string json = decode_file(temp.get_path(), LogOutputFormat::Json);
+        size_t count = 0;
+        for (size_t pos = json.find("\"event\":\"auth\""); pos != std::string::npos;
+             pos = json.find("\"event\":\"auth\"", pos + 1)) {
+            count++;
+        }
+        CHECK_EQUAL(2u, count);
+        CHECK(json.find("\"login\":\"a\\\"b\",\"success\":true") != std::string::npos);
+    }
+    
+    TEST(Test1_3_CorruptedLogRejected) {
+        TempFile temp;
+        LoggerOptions options;
+        options.format = LogFormat::Binary;
+        {
+            Logger logger(temp.get_path(), options);
+        }
+        fs::resize_file(temp.get_path(), fs::file_size(temp.get_path()) - 3);
+        CHECK_THROW(decode_file(temp.get_path(), LogOutputFormat::Text), std::runtime_error);
+        
+        TempFile text_log("[2025-01-01 00:00:00] text log line\n");
+        CHECK_THROW(decode_file(text_log.get_path(), LogOutputFormat::Text), std::runtime_error);
+    }
+    
+    TEST(Test1_5_ShortRecordsStayInline) {
+        LogEntry connection = BinaryLogRecord(LogEvent::Connection).add_ip("192.168.10.25").add_flag(true).finish();
+        CHECK(!connection.is_spilled());
+        CHECK_EQUAL(BinaryLogRecord::HEADER_SIZE + 5 + 1, connection.size());
+        // Повторный адрес берётся из кэша потока
+        LogEntry batch = BinaryLogRecord(LogEvent::BatchProcessed).add_ip("192.168.10.25").add_count(16).finish();
+        CHECK(!batch.is_spilled());
+        
+        std::string message(200, 'x');
+        LogEntry long_entry = BinaryLogRecord(LogEvent::Message).add(message).finish();
+        CHECK(long_entry.is_spilled());
+        CHECK_EQUAL(BinaryLogRecord::HEADER_SIZE + 2 + message.size(), long_entry.size());
+        
+        LogEntry moved(std::move(batch));
+        LogEntry session = BinaryLogRecord::session();
+        std::string bytes(session.data(), session.size());
+        for (const LogEntry* entry : {&connection, &moved, &long_entry}) {
+            bytes.append(entry->data(), entry->size());
+        }
+        std::istringstream in(bytes);
+        std::ostringstream out;
+        CHECK_EQUAL(3u, BinaryLogDecoder::decode(in, out, LogOutputFormat::Text));
+        CHECK(out.str().find("] CLIENT [192.168.10.25] connected\n") != std::string::npos);
+        CHECK(out.str().find("] DATA [192.168.10.25] Successfully processed 16 vectors\n") != std::string::npos);
+        CHECK(out.str().find("] " + message + "\n") != std::string::npos);
+    }
+}
+
+SUITE(IpRateLimiterTests) {
+    TEST(Test1_1_BurstThenRateLimited) {
+        IpLimits limits;
+        limits.rate = 1;
+        limits.burst = 3;
+        IpRateLimiter limiter(limits);
+        uint32_t ip = IpRateLimiter::parse_ip("10.0.0.1");
+        for (int i = 0; i < 3; i++) {
+            CHECK(limiter.try_acquire(ip) == IpVerdict::Allowed);
+        }
+        CHECK(limiter.try_acquire(ip) == IpVerdict::RateLimited);
+        // Другой адрес расходует свою корзину
+        CHECK(limiter.try_acquire(IpRateLimiter::parse_ip("10.0.0.2")) == IpVerdict::Allowed);
+    }
+    
+    TEST(Test1_2_MaxSessionsReleased) {
+        IpLimits limits;
+        limits.max_sessions = 2;
+        IpRateLimiter limiter(limits);
+        uint32_t ip = IpRateLimiter::parse_ip("10.0.0.1");
+        CHECK(limiter.try_acquire(ip) == IpVerdict::Allowed);
+        CHECK(limiter.try_acquire(ip) == IpVerdict::Allowed);
+        CHECK(limiter.try_acquire(ip) == IpVerdict::TooManySessions);
+        limiter.release(ip);
+        CHECK(limiter.try_acquire(ip) == IpVerdict::Allowed);
+    }
+    
+    TEST(Test1_3_FailuresDelayThenBlock) {
+        IpLimits limits;
+        limits.fail_limit = 2;
+        IpRateLimiter limiter(limits);
+        uint32_t ip = IpRateLimiter::parse_ip("10.0.0.1");
+        CHECK(!limiter.record_auth(ip, false));
+        CHECK(limiter.try_acquire(ip) == IpVerdict::RateLimited);
+        std::this_thread::sleep_for(std::chrono::milliseconds(IpRateLimiter::PENALTY_BASE_MS + 50));
+        CHECK(limiter.try_acquire(ip) == IpVerdict::Allowed);
+        CHECK(limiter.record_auth(ip, false));
+        CHECK(limiter.try_acquire(ip) == IpVerdict::Blocked);
+        CHECK_EQUAL(1u, limiter.blocked_count());
+    }
+    
+    TEST(Test1_4_SuccessResetsFailures) {
+        IpLimits limits;
+        limits.fail_limit = 2;
+        IpRateLimiter limiter(limits);
+        uint32_t ip = IpRateLimiter::parse_ip("10.0.0.1");
+        CHECK(!limiter.record_auth(ip, false));
+        CHECK(!limiter.record_auth(ip, true));
+        CHECK(!limiter.record_auth(ip, false));
+        CHECK_EQUAL(0u, limiter.blocked_count());
+        CHECK_EQUAL(0u, IpRateLimiter::parse_ip("not an address"));
+    }
+    
+    TEST(Test1_5_SessionGateReleasesBothLimits) {
+        IpLimits limits;
+        limits.max_sessions = 1;
+        IpRateLimiter limiter(limits);
+        AdmissionController admission(1, std::chrono::milliseconds(0), std::chrono::milliseconds(100));
+        SessionGate gate(&admission, &limiter);
+        SessionStats stats;
+        uint32_t ip = IpRateLimiter::parse_ip("10.0.0.1");
+        uint32_t other_ip = IpRateLimiter::parse_ip("10.0.0.2");
+        auto client_socket = []() {
+            int sockfd[2];
+            CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+            close(sockfd[1]);
+            return sockfd[0];
+        };
+        
+        int admitted = client_socket();
+        CHECK(gate.admit(admitted, ip, stats));
+        close(admitted);
+        CHECK(!gate.admit(client_socket(), ip, stats));        // предел по IP
+        CHECK(!gate.admit(client_socket(), other_ip, stats));  // предел сервера, место по IP возвращено
+        CHECK_EQUAL(1u, stats.connections_throttled.load());
+        CHECK_EQUAL(1u, stats.connections_rejected.load());
+        
+        // Отклонённое после допуска подключение освобождает оба места
+        gate.reject(client_socket(), ip, stats);
+        CHECK_EQUAL(0u, admission.active_sessions());
+        admitted = client_socket();
+        CHECK(gate.admit(admitted, other_ip, stats));
+        close(admitted);
+        gate.release(other_ip);
+        admitted = client_socket();
+        CHECK(gate.admit(admitted, ip, stats));
+        close(admitted);
+        gate.release(ip);
+    }
+}
+
+SUITE(ServerTests) {
+    TEST(Test1_1_GetClientIPValidSocket) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        Server server(33333, users.get_path(), log.get_path());
+        
+        int test_sock = socket(AF_INET, SOCK_STREAM, 0);
+        CHECK(test_sock >= 0);
+        
+        std::string ip = server.get_client_ip(test_sock);
+        CHECK_EQUAL("unknown", ip);
+        
+        close(test_sock);
+    }
+    
+    TEST(Test1_2_GetClientIPInvalidSocket) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        Server server(33333, users.get_path(), log.get_path());
+        
+        std::string ip = server.get_client_ip(-1);
+        CHECK_EQUAL("unknown", ip);
+    }
+    
+    TEST(Test2_1_SendStringSuccess) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        Server server(33333, users.get_path(), log.get_path());
+        
+        int sockfd[2];
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
+        
+        bool result = server.send_string(sockfd[0], "Hello");
+        CHECK(result);
+        
+        close(sockfd[0]);
+        close(sockfd[1]);
+    }
+    
+    TEST(Test2_2_RecvStringSuccess) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        Server server(33333, users.get_path(), log.get_path());
         
         int sockfd[2];
         CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd) >= 0);
@@ -742,6 +2983,20 @@ SUITE(ServerTests) {
     CHECK(!started);
     }
     
+    TEST(Test3_4_ServerWritesToSharedLogger) {
+        TempFile users("test:pass\n");
+        TempDir dir;
+        std::string shared_path = dir.get_path() + "/shared.log";
+        std::string own_path = dir.get_path() + "/own.log";
+        auto logger = std::make_shared<Logger>(shared_path);
+        {
+            Server server(33353, users.get_path(), own_path, ServerOptions(), logger);
+        }
+        logger->flush();
+        CHECK(!fs::exists(own_path));
+        CHECK(read_file(shared_path).find("Server initialized successfully") != std::string::npos);
+    }
+    
     TEST(Test4_1_ServerRunStartsWithoutException) {
         TempFile users("test:pass\n");
         TempFile log;
@@ -752,6 +3007,291 @@ SUITE(ServerTests) {
         
         CHECK(true);
     }
+    
+    TEST(Test5_1_ConcurrentClientsWorkerPool) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.worker_threads = 4;
+        Server server(33342, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        std::atomic<int> succeeded(0);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < 8; i++) {
+            clients.emplace_back([&succeeded, i]() {
+                try {
+                    auto results = run_test_client(33342, "test", "pass", {{1.0, 2.0, double(i)}});
+                    if (results.size() == 1 && std::abs(results[0] - (5.0 + i * i)) < 1e-9) {
+                        succeeded++;
+                    }
+                } catch (const std::exception&) {
+                }
+            });
+        }
+        for (auto& client : clients) client.join();
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(8, succeeded.load());
+    }
+    
+    TEST(Test6_1_ConcurrentClientsEpoll) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Epoll;
+        options.worker_threads = 2;
+        Server server(33343, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        std::atomic<int> succeeded(0);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < 16; i++) {
+            clients.emplace_back([&succeeded, i]() {
+                try {
+                    auto results = run_test_client(33343, "test", "pass", {{double(i)}, {}, {1.0, 1.0}});
+                    if (results.size() == 3 && std::abs(results[0] - i * i) < 1e-9 &&
+                        results[1] == 0.0 && std::abs(results[2] - 2.0) < 1e-9) {
+                        succeeded++;
+                    }
+                } catch (const std::exception&) {
+                }
+            });
+        }
+        for (auto& client : clients) client.join();
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(16, succeeded.load());
+    }
+    
+    TEST(Test6_2_EpollWrongPassword) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Epoll;
+        options.worker_threads = 1;
+        Server server(33344, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        CHECK_THROW(run_test_client(33344, "test", "wrong", {{1.0}}), std::runtime_error);
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(1u, server.get_stats().auth_failures);
+    }
+    
+    TEST(Test6_3_EpollFailedLoginThrottlesIp) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Epoll;
+        options.worker_threads = 1;
+        options.ip_limits.fail_limit = 3;
+        Server server(33352, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        CHECK_THROW(run_test_client(33352, "test", "wrong", {{1.0}}), std::runtime_error);
+        // Во время задержки после неудачи даже верный пароль получает ERR без соли
+        CHECK_THROW(run_test_client(33352, "test", "pass", {{1.0}}), std::runtime_error);
+        std::this_thread::sleep_for(std::chrono::milliseconds(IpRateLimiter::PENALTY_BASE_MS + 50));
+        auto results = run_test_client(33352, "test", "pass", {{1.0}});
+        CHECK_EQUAL(1u, results.size());
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(1u, server.get_stats().auth_failures);
+        CHECK_EQUAL(1u, server.get_stats().connections_throttled);
+    }
+    
+    TEST(Test7_1_ShardedListenersAggregateStats) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.mode = ServerMode::Sharded;
+        options.worker_threads = 3;
+        Server server(33345, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        std::atomic<int> succeeded(0);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < 12; i++) {
+            clients.emplace_back([&succeeded]() {
+                try {
+                    auto results = run_test_client(33345, "test", "pass", {{3.0, 4.0}, {1.0}});
+                    if (results.size() == 2 && std::abs(results[0] - 25.0) < 1e-9) {
+                        succeeded++;
+                    }
+                } catch (const std::exception&) {
+                }
+            });
+        }
+        for (auto& client : clients) client.join();
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(12, succeeded.load());
+        
+        auto shard_stats = server.get_shard_stats();
+        CHECK_EQUAL(3u, shard_stats.size());
+        StatsSnapshot total;
+        for (const auto& shard : shard_stats) total += shard;
+        CHECK_EQUAL(24u, total.vectors_processed);
+        CHECK_EQUAL(12u, total.connections_accepted);
+        CHECK_EQUAL(total.vectors_processed, server.get_stats().vectors_processed);
+    }
+    
+    TEST(Test7_3_LargeVectorUsesComputePool) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        std::vector<double> data(DataCalculator::PARALLEL_REDUCTION_THRESHOLD * 2 + 4321);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = std::sin(static_cast<double>(i)) * 1e3;
+        }
+        double expected = DataCalculator::calculate_sum_of_squares(data);
+        unsigned threads = ComputePool::instance().thread_count();
+        int port = 33354;
+        for (ServerMode mode : {ServerMode::Blocking, ServerMode::Epoll, ServerMode::Coroutine}) {
+            ServerOptions options;
+            options.mode = mode;
+            options.worker_threads = 2;
+            options.compute_threads = 2;
+            Server server(port, users.get_path(), log.get_path(), options);
+            CHECK(server.start());
+            std::thread server_thread([&server]() { server.run(); });
+            
+            uint64_t jobs = ComputePool::instance().get_shared_jobs();
+            auto results = run_test_client(port, "test", "pass", {data});
+            CHECK_EQUAL(1u, results.size());
+            if (results.size() == 1) {
+                // Порции из сети суммируются теми же блоками, что и массив целиком
+                CHECK_EQUAL(expected, results[0]);
+            }
+            CHECK(ComputePool::instance().get_shared_jobs() > jobs);
+            
+            server.stop();
+            server_thread.join();
+            port++;
+        }
+        ComputePool::instance().set_threads(threads);
+    }
+    
+    TEST(Test7_4_OpenLegacyClientDoesNotHoldWorker) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.worker_threads = 1;
+        Server server(33357, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        // Клиент старого формата: один пакет, сокет не закрывает
+        int sock = create_test_socket();
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(33357);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+        send(sock, "test", 4, 0);
+        char salt[17] = {0};
+        recv(sock, salt, 16, MSG_WAITALL);
+        std::string hash = AuthManager::compute_md5_hash(salt, "pass");
+        send(sock, hash.c_str(), hash.length(), 0);
+        char status[3] = {0};
+        recv(sock, status, 2, MSG_WAITALL);
+        uint32_t packet[4] = {1, 1, 0, 0};
+        double value = 3.0;
+        memcpy(packet + 2, &value, sizeof(value));
+        send(sock, packet, sizeof(packet), 0);
+        double result = 0;
+        CHECK_EQUAL(static_cast<ssize_t>(sizeof(result)), recv(sock, &result, sizeof(result), MSG_WAITALL));
+        
+        // Без --keep-alive единственный рабочий поток свободен для следующего клиента
+        auto started = std::chrono::steady_clock::now();
+        auto results = run_test_client(33357, "test", "pass", {{2.0}});
+        CHECK(std::chrono::steady_clock::now() - started < std::chrono::seconds(2));
+        CHECK_EQUAL(1u, results.size());
+        close(sock);
+        
+        server.stop();
+        server_thread.join();
+    }
+    
+    TEST(Test7_5_FrameAfterNegotiationRejectedInAllModes) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        int port = 33358;
+        for (ServerMode mode : {ServerMode::Blocking, ServerMode::Epoll, ServerMode::Coroutine}) {
+            ServerOptions options;
+            options.mode = mode;
+            options.worker_threads = 1;
+            Server server(port, users.get_path(), log.get_path(), options);
+            CHECK(server.start());
+            std::thread server_thread([&server]() { server.run(); });
+            
+            int sock = create_test_socket();
+            struct sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            CHECK(connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+            send(sock, "test", 4, 0);
+            char salt[17] = {0};
+            recv(sock, salt, 16, MSG_WAITALL);
+            std::string hash = AuthManager::compute_md5_hash(salt, "pass");
+            send(sock, hash.c_str(), hash.length(), 0);
+            char status[4] = {0};
+            recv(sock, status, 2, MSG_WAITALL);
+            CHECK_EQUAL("OK", std::string(status));
+            
+            // "TYP" + 'd' принимается, следующий за ним кадр VEC2 - нет
+            send(sock, "TYPd", 4, 0);
+            memset(status, 0, sizeof(status));
+            recv(sock, status, 2, MSG_WAITALL);
+            CHECK_EQUAL("OK", std::string(status));
+            FrameHeader frame{};
+            frame.magic = DataCalculator::FRAME_MAGIC;
+            frame.version = DataCalculator::FRAME_VERSION;
+            frame.element_type = 'd';
+            frame.stats_mask = STAT_SUM_OF_SQUARES;
+            frame.num_vectors = 1;
+            frame.payload_length = sizeof(uint64_t) + sizeof(double);
+            send(sock, &frame, sizeof(frame), 0);
+            memset(status, 0, sizeof(status));
+            recv(sock, status, 3, MSG_WAITALL);
+            CHECK_EQUAL("ERR", std::string(status));
+            close(sock);
+            
+            server.stop();
+            server_thread.join();
+            port++;
+        }
+    }
+    
+    TEST(Test7_2_BlockingModeStats) {
+        TempFile users("test:pass\n");
+        TempFile log;
+        ServerOptions options;
+        options.worker_threads = 2;
+        Server server(33346, users.get_path(), log.get_path(), options);
+        CHECK(server.start());
+        std::thread server_thread([&server]() { server.run(); });
+        
+        auto results = run_test_client(33346, "test", "pass", {{2.0}, {2.0, 2.0}});
+        CHECK_EQUAL(2u, results.size());
+        
+        server.stop();
+        server_thread.join();
+        CHECK_EQUAL(2u, server.get_stats().vectors_processed);
+    }
 }
 
 // ===================== MAIN =====================
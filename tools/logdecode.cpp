@@ -0,0 +1,48 @@
+/*! \file logdecode.cpp
+ *  \brief Утилита чтения двоичного журнала сервера
+ *  \details Запуск: logdecode [--json] server.log. Выводит записи текстом, как текстовый журнал, или JSON
+ *  \author Осетров М.С.
+ *  \date 2025
+ *  \copyright ПГУ
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "../src/BinaryLog.h"
+
+//! \brief Точка входа утилиты
+//! \param[in] argc Количество аргументов командной строки
+//! \param[in] argv Массив аргументов: [--json] файл журнала
+//! \return 0 при успехе, 1 при ошибке
+int main(int argc, char* argv[]) {
+    LogOutputFormat format = LogOutputFormat::Text;
+    const char* filename = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            format = LogOutputFormat::Json;
+        } else {
+            filename = argv[i];
+        }
+    }
+    if (!filename) {
+        std::cerr << "Использование: " << argv[0] << " [--json] <двоичный журнал>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR: Cannot open log file: " << filename << std::endl;
+        return 1;
+    }
+    try {
+        BinaryLogDecoder::decode(file, std::cout, format);
+    } catch (const std::exception& e) {
+        std::cout.flush();
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}